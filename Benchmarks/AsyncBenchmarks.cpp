@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "Baselines.h"
+#include "Support.h"
+#include "../lib/Async.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// Attaches four Map stages to each of 1024 pending eithers, completes them all and waits for every result,
+	// so the stages of different chains run side by side. Items processed counts stages.
+
+	constexpr long Chains = 1024;
+	constexpr long StagesPerChain = 4;
+
+	void RunChains(Executor& executor)
+	{
+		std::vector<EitherPromise<int, long>> promises;
+		std::vector<AsyncEither<int, long>> results;
+		promises.reserve(Chains);
+		results.reserve(Chains);
+		for(long i = 0; i < Chains; i++)
+		{
+			promises.emplace_back(executor);
+			results.push_back(promises.back().GetAsync().Map(MapStage).Map(MapStage).Map(MapStage).Map(MapStage));
+		}
+		for(long i = 0; i < Chains; i++) { promises[i].Complete(Result(i)); }
+		for(auto& result : results) { benchmark::DoNotOptimize(std::move(result).Get()); }
+	}
+
+	// Stages run on the completing thread, so this is the cost of the continuations alone
+	void AsyncChainsInline(benchmark::State& state)
+	{
+		InlineExecutor executor;
+		Counters counters(state, sizeof(Result));
+		for (auto _ : state) { RunChains(executor); }
+		state.SetItemsProcessed(state.iterations() * Chains * StagesPerChain);
+	}
+
+	// state.range(0) is the number of threads of the work stealing executor
+	void AsyncChainsWorkStealing(benchmark::State& state)
+	{
+		WorkStealingExecutor executor(static_cast<std::size_t>(state.range(0)));
+		Counters counters(state, sizeof(Result));
+		for (auto _ : state) { RunChains(executor); }
+		state.SetItemsProcessed(state.iterations() * Chains * StagesPerChain);
+	}
+
+	// The same chains on eithers that are already there, as a baseline
+	void AsyncChainsSynchronous(benchmark::State& state)
+	{
+		Counters counters(state, sizeof(Result));
+		for (auto _ : state)
+		{
+			for(long i = 0; i < Chains; i++) { benchmark::DoNotOptimize(Result(i).Map(MapStage).Map(MapStage).Map(MapStage).Map(MapStage)); }
+		}
+		state.SetItemsProcessed(state.iterations() * Chains * StagesPerChain);
+	}
+
+	BENCHMARK(AsyncChainsSynchronous)->Unit(benchmark::kMicrosecond);
+	BENCHMARK(AsyncChainsInline)->Unit(benchmark::kMicrosecond);
+	BENCHMARK(AsyncChainsWorkStealing)->ArgName("threads")->RangeMultiplier(2)->Range(1, 64)->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
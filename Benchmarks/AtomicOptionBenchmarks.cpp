@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "Support.h"
+#include "../lib/AtomicOption.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// Two threads share one slot: the first publishes a value each iteration while the second tries to take one, so
+	// each iteration is one handoff attempt under contention. The baseline guards an Option<T> with a mutex.
+
+	template <typename T>
+	class MutexOption
+	{
+	public:
+		Option<T> Exchange(T value)
+		{
+			std::lock_guard lock(mutex);
+			return std::exchange(slot, Option<T>(std::move(value)));
+		}
+
+		Option<T> TryTake()
+		{
+			std::lock_guard lock(mutex);
+			return std::exchange(slot, Option<T>());
+		}
+
+	private:
+		std::mutex mutex;
+		Option<T> slot;
+	};
+
+	struct Quote
+	{
+		long bid;
+		long ask;
+		long time;
+		long volume;
+	};
+
+	template <typename T>
+	T MakeValue(const long i)
+	{
+		if constexpr (std::is_same_v<T, Quote>) { return Quote{ i, i + 1, i, 100 }; }
+		else { return static_cast<T>(i); }
+	}
+
+	template <typename Slot, typename T>
+	void Contended(benchmark::State& state)
+	{
+		static Slot slot;
+		Counters counters(state, state.thread_index() == 0 ? sizeof(Slot) : 0);  // counters are summed over both threads
+		long i = 0;
+		long taken = 0;
+		for (auto _ : state)
+		{
+			if(state.thread_index() == 0) { benchmark::DoNotOptimize(slot.Exchange(MakeValue<T>(++i))); }
+			else if(!slot.TryTake().IsNone()) { taken++; }
+		}
+		if(state.thread_index() == 1) { state.counters["taken"] = benchmark::Counter(static_cast<double>(taken), benchmark::Counter::kAvgIterations); }
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	BENCHMARK_TEMPLATE(Contended, MutexOption<int>, int)->Threads(2)->UseRealTime();
+	BENCHMARK_TEMPLATE(Contended, AtomicOption<int>, int)->Threads(2)->UseRealTime();
+	BENCHMARK_TEMPLATE(Contended, MutexOption<Quote>, Quote)->Threads(2)->UseRealTime();
+	BENCHMARK_TEMPLATE(Contended, AtomicOption<Quote>, Quote)->Threads(2)->UseRealTime();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <variant>
+#if __has_include(<expected>)
+#include <expected>
+#endif
+
+#include "../lib/Either.h"
+#include "../lib/Option.h"
+
+// std::expected is only compared against where the standard library provides it
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+#define LIBMONAD_BENCH_EXPECTED 1
+#else
+#define LIBMONAD_BENCH_EXPECTED 0
+#endif
+
+namespace Benchmarks
+{
+	// Each benchmark runs the same work through libmonad and through these baselines, with an int error code as the left value
+
+	using Result = libmonad::Either<int, long>;
+	using VariantResult = std::variant<int, long>;
+#if LIBMONAD_BENCH_EXPECTED
+	using ExpectedResult = std::expected<long, int>;
+#endif
+
+	using TextResult = libmonad::Either<int, std::string>;
+	using TextVariant = std::variant<int, std::string>;
+#if LIBMONAD_BENCH_EXPECTED
+	using TextExpected = std::expected<std::string, int>;
+#endif
+
+	// The error code a stage fails with
+	constexpr int StageFailed = 7;
+
+	// One stage of a chain: even stages map, odd stages bind and fail when the value reaches a multiple of 1009
+	constexpr long MapStage(const long l) { return l * 3 + 1; }
+	constexpr bool BindFails(const long l) { return l % 1009 == 0; }
+	constexpr long BindStage(const long l) { return l / 2; }
+}
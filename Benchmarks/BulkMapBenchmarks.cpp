@@ -0,0 +1,115 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "Support.h"
+#include "../lib/BulkMap.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// Transforms a column of a million arithmetic options, of which state.range(0) per mille are none
+
+	template <typename T>
+	OptionColumn<T> MakeNumberColumn(const long nonePerMille)
+	{
+		OptionColumn<T> column;
+		for(const auto input : MakeInputs(1000000, nonePerMille))
+		{
+			if(input < 0) { column.PushNone(); } else { column.PushSome(static_cast<T>(input)); }
+		}
+		return column;
+	}
+
+	// Maps x to 1 - x, so running it over the same column again and again stays in range
+	template <typename T>
+	constexpr auto Scale = [](const T value) { return value * T(-1) + T(1); };
+
+	// Option by option, through OptionColumn::Map
+	template <typename T>
+	void NumbersMap(benchmark::State& state)
+	{
+		const auto column = MakeNumberColumn<T>(state.range(0));
+		Counters counters(state, sizeof(T) + 1 / 8.0);
+		for (auto _ : state)
+		{
+			auto result = column.Map(Scale<T>);
+			benchmark::DoNotOptimize(result);
+		}
+		state.SetItemsProcessed(state.iterations() * column.Size());
+	}
+
+	template <typename T, SimdLevel Level>
+	void NumbersBulkMap(benchmark::State& state)
+	{
+		if(Level > CurrentSimdLevel())
+		{
+			state.SkipWithError("not supported by this CPU");
+			return;
+		}
+
+		const auto column = MakeNumberColumn<T>(state.range(0));
+		Counters counters(state, sizeof(T) + 1 / 8.0);
+		for (auto _ : state)
+		{
+			auto result = BulkMap(column, Scale<T>, Level);
+			benchmark::DoNotOptimize(result);
+		}
+		state.SetItemsProcessed(state.iterations() * column.Size());
+	}
+
+	// The same, transforming the column in place so that no time goes on allocating and filling a new one
+
+	template <typename T>
+	void NumbersMapInPlace(benchmark::State& state)
+	{
+		auto column = MakeNumberColumn<T>(state.range(0));
+		Counters counters(state, sizeof(T) + 1 / 8.0);
+		for (auto _ : state)
+		{
+			column = std::move(column).Map(Scale<T>);
+			benchmark::DoNotOptimize(column);
+		}
+		state.SetItemsProcessed(state.iterations() * column.Size());
+	}
+
+	template <typename T, SimdLevel Level>
+	void NumbersBulkMapInPlace(benchmark::State& state)
+	{
+		if(Level > CurrentSimdLevel())
+		{
+			state.SkipWithError("not supported by this CPU");
+			return;
+		}
+
+		auto column = MakeNumberColumn<T>(state.range(0));
+		Counters counters(state, sizeof(T) + 1 / 8.0);
+		for (auto _ : state)
+		{
+			column = BulkMap(std::move(column), Scale<T>, Level);
+			benchmark::DoNotOptimize(column);
+		}
+		state.SetItemsProcessed(state.iterations() * column.Size());
+	}
+
+	void NoneRates(benchmark::internal::Benchmark* benchmark)
+	{
+		benchmark->ArgName("nonePerMille")->Arg(0)->Arg(10)->Unit(benchmark::kMicrosecond);
+	}
+
+#define LIBMONAD_BULK_MAP_BENCHMARKS(T) \
+	BENCHMARK_TEMPLATE(NumbersMap, T)->Apply(NoneRates); \
+	BENCHMARK_TEMPLATE(NumbersBulkMap, T, SimdLevel::Scalar)->Apply(NoneRates); \
+	BENCHMARK_TEMPLATE(NumbersBulkMap, T, SimdLevel::Sse2)->Apply(NoneRates); \
+	BENCHMARK_TEMPLATE(NumbersBulkMap, T, SimdLevel::Avx2)->Apply(NoneRates); \
+	BENCHMARK_TEMPLATE(NumbersBulkMap, T, SimdLevel::Avx512)->Apply(NoneRates); \
+	BENCHMARK_TEMPLATE(NumbersMapInPlace, T)->Apply(NoneRates); \
+	BENCHMARK_TEMPLATE(NumbersBulkMapInPlace, T, SimdLevel::Scalar)->Apply(NoneRates); \
+	BENCHMARK_TEMPLATE(NumbersBulkMapInPlace, T, SimdLevel::Sse2)->Apply(NoneRates); \
+	BENCHMARK_TEMPLATE(NumbersBulkMapInPlace, T, SimdLevel::Avx2)->Apply(NoneRates); \
+	BENCHMARK_TEMPLATE(NumbersBulkMapInPlace, T, SimdLevel::Avx512)->Apply(NoneRates)
+
+	LIBMONAD_BULK_MAP_BENCHMARKS(std::int32_t);
+	LIBMONAD_BULK_MAP_BENCHMARKS(float);
+	LIBMONAD_BULK_MAP_BENCHMARKS(double);
+}
@@ -0,0 +1,226 @@
+#include <benchmark/benchmark.h>
+
+#include "Baselines.h"
+#include "../lib/Pipeline.h"
+#include "Support.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	Result Parse(const long input)
+	{
+		if(input < 0) { return -1; }
+		return input;
+	}
+
+	// Five stage chain through the std::function overloads
+	void EitherChainStdFunction(benchmark::State& state)
+	{
+		Counters counters(state, sizeof(Result));
+		long input = 0;
+		for (auto _ : state)
+		{
+			auto result = Parse(input++)
+				.Map<long>([](const long l) { return l + 1; })
+				.Map<long>([](const long l) { return l * 3; })
+				.Bind<long>([](const long l) { return l % 7 == 0 ? Result(7) : Result(l); })
+				.Map<long>([](const long l) { return l - 2; })
+				.Map<long>([](const long l) { return l / 2; });
+
+			benchmark::DoNotOptimize(result);
+		}
+	}
+
+	// The same chain through the overloads templated on the callable
+	void EitherChainTemplated(benchmark::State& state)
+	{
+		Counters counters(state, sizeof(Result));
+		long input = 0;
+		for (auto _ : state)
+		{
+			auto result = Parse(input++)
+				.Map([](const long l) { return l + 1; })
+				.Map([](const long l) { return l * 3; })
+				.Bind([](const long l) { return l % 7 == 0 ? Result(7) : Result(l); })
+				.Map([](const long l) { return l - 2; })
+				.Map([](const long l) { return l / 2; });
+
+			benchmark::DoNotOptimize(result);
+		}
+	}
+
+	// The same chain written by hand with early returns, which the templated chain should match
+	void EitherChainHandWritten(benchmark::State& state)
+	{
+		Counters counters(state, sizeof(Result));
+		long input = 0;
+		for (auto _ : state)
+		{
+			auto run = [](const long in) -> Result
+			{
+				if(in < 0) { return -1; }
+				auto l = in + 1;
+				l = l * 3;
+				if(l % 7 == 0) { return 7; }
+				l = l - 2;
+				return l / 2;
+			};
+
+			auto result = run(input++);
+			benchmark::DoNotOptimize(result);
+		}
+	}
+
+	// The same chain built once as a fused pipeline, with no intermediate eithers
+	void EitherChainPipeline(benchmark::State& state)
+	{
+		const auto pipeline = Pipeline<int>::From<long>()
+			.Map([](const long l) { return l + 1; })
+			.Map([](const long l) { return l * 3; })
+			.Bind([](const long l) { return l % 7 == 0 ? Result(7) : Result(l); })
+			.Map([](const long l) { return l - 2; })
+			.Map([](const long l) { return l / 2; });
+
+		Counters counters(state, sizeof(Result));
+		long input = 0;
+		for (auto _ : state)
+		{
+			auto result = pipeline.Run(Parse(input++));
+			benchmark::DoNotOptimize(result);
+		}
+	}
+
+	BENCHMARK(EitherChainStdFunction);
+	BENCHMARK(EitherChainTemplated);
+	BENCHMARK(EitherChainPipeline);
+	BENCHMARK(EitherChainHandWritten);
+
+	// Chains of state.range(0) stages, run over inputs of which state.range(1) per mille are left to begin with
+
+	Result EitherChain(const long input, const long stages)
+	{
+		auto result = Parse(input);
+		for(long stage = 0; stage < stages; stage++)
+		{
+			result = stage % 2 == 0
+				? std::move(result).Map([](const long l) { return MapStage(l); })
+				: std::move(result).Bind([](const long l) { return BindFails(l) ? Result(StageFailed) : Result(BindStage(l)); });
+		}
+		return result;
+	}
+
+	VariantResult VariantChain(const long input, const long stages)
+	{
+		VariantResult result = input < 0 ? VariantResult(std::in_place_index<0>, -1) : VariantResult(input);
+		for(long stage = 0; stage < stages; stage++)
+		{
+			if(result.index() == 0) { continue; }
+			const auto l = std::get<1>(result);
+			if(stage % 2 == 0) { result = MapStage(l); }
+			else if(BindFails(l)) { result.emplace<0>(StageFailed); }
+			else { result = BindStage(l); }
+		}
+		return result;
+	}
+
+#if LIBMONAD_BENCH_EXPECTED
+	ExpectedResult ExpectedChain(const long input, const long stages)
+	{
+		ExpectedResult result = input < 0 ? ExpectedResult(std::unexpect, -1) : ExpectedResult(input);
+		for(long stage = 0; stage < stages; stage++)
+		{
+			result = stage % 2 == 0
+				? std::move(result).transform([](const long l) { return MapStage(l); })
+				: std::move(result).and_then([](const long l) { return BindFails(l) ? ExpectedResult(std::unexpect, StageFailed) : ExpectedResult(BindStage(l)); });
+		}
+		return result;
+	}
+#endif
+
+	// Returns zero on success, leaving the result in out
+	int ErrorCodeChain(const long input, const long stages, long& out)
+	{
+		if(input < 0) { return -1; }
+		auto l = input;
+		for(long stage = 0; stage < stages; stage++)
+		{
+			if(stage % 2 == 0) { l = MapStage(l); }
+			else if(BindFails(l)) { return StageFailed; }
+			else { l = BindStage(l); }
+		}
+		out = l;
+		return 0;
+	}
+
+	// Runs chain over a fixed set of inputs, one input per iteration
+	template <typename Chain>
+	void RunChain(benchmark::State& state, const std::size_t bytesPerObject, Chain chain)
+	{
+		const auto inputs = MakeInputs(4096, state.range(1));
+		const auto stages = state.range(0);
+		Counters counters(state, bytesPerObject);
+		std::size_t next = 0;
+		for (auto _ : state)
+		{
+			auto result = chain(inputs[next++ & 4095], stages);
+			benchmark::DoNotOptimize(result);
+		}
+	}
+
+	void ChainEither(benchmark::State& state) { RunChain(state, sizeof(Result), EitherChain); }
+	// A fused pipeline has a fixed number of stages, so each length is its own pipeline, alternating Map and Bind as above
+	template <std::size_t Stages>
+	constexpr auto MakePipeline()
+	{
+		if constexpr (Stages == 0) { return Pipeline<int>::From<long>(); }
+		else if constexpr (Stages % 2 == 1) { return MakePipeline<Stages - 1>().Map([](const long l) { return MapStage(l); }); }
+		else { return MakePipeline<Stages - 1>().Bind([](const long l) { return BindFails(l) ? Result(StageFailed) : Result(BindStage(l)); }); }
+	}
+
+	template <std::size_t... Lengths>
+	Result PipelineChain(const long input, const long stages, std::index_sequence<Lengths...>)
+	{
+		static constexpr auto pipelines = std::make_tuple(MakePipeline<Lengths + 1>()...);
+		Result result = -1;
+		((stages == static_cast<long>(Lengths + 1) ? (result = std::get<Lengths>(pipelines).Run(Parse(input)), true) : false) || ...);
+		return result;
+	}
+
+	void ChainPipeline(benchmark::State& state)
+	{
+		RunChain(state, sizeof(Result), [](const long input, const long stages)
+		{
+			return PipelineChain(input, stages, std::make_index_sequence<16>());
+		});
+	}
+
+	void ChainVariant(benchmark::State& state) { RunChain(state, sizeof(VariantResult), VariantChain); }
+#if LIBMONAD_BENCH_EXPECTED
+	void ChainExpected(benchmark::State& state) { RunChain(state, sizeof(ExpectedResult), ExpectedChain); }
+#endif
+	void ChainErrorCode(benchmark::State& state)
+	{
+		RunChain(state, sizeof(int) + sizeof(long), [](const long input, const long stages)
+		{
+			long out = 0;
+			const auto code = ErrorCodeChain(input, stages, out);
+			return code == 0 ? out : code;
+		});
+	}
+
+	// Chain lengths 1 to 16 with no lefts, then chains of 8 at each left rate
+	void ChainArgs(benchmark::internal::Benchmark* benchmark)
+	{
+		benchmark->ArgNames({ "stages", "leftPerMille" });
+		for(const long stages : { 1, 2, 4, 8, 16 }) { benchmark->Args({ stages, 0 }); }
+		for(const long leftPerMille : { 10, 500 }) { benchmark->Args({ 8, leftPerMille }); }
+	}
+
+	BENCHMARK(ChainEither)->Apply(ChainArgs);
+	BENCHMARK(ChainPipeline)->Apply(ChainArgs);
+	BENCHMARK(ChainVariant)->Apply(ChainArgs);
+#if LIBMONAD_BENCH_EXPECTED
+	BENCHMARK(ChainExpected)->Apply(ChainArgs);
+#endif
+	BENCHMARK(ChainErrorCode)->Apply(ChainArgs);
+}
@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include "Baselines.h"
+#include "Support.h"
+#include "../lib/EitherColumn.h"
+#include "../lib/OptionColumn.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// Map then Bind over a batch of state.range(1) eithers, of which state.range(0) per mille are left,
+	// stored as a std::vector of eithers and as a column
+
+	constexpr auto BatchMap = [](const long l) { return MapStage(l); };
+	constexpr auto BatchBind = [](const long l) { return BindFails(l) ? Result(StageFailed) : Result(BindStage(l)); };
+
+	std::vector<Result> MakeBatch(benchmark::State& state)
+	{
+		std::vector<Result> batch;
+		for(const auto input : MakeInputs(state.range(1), state.range(0)))
+		{
+			batch.push_back(input < 0 ? Result(StageFailed) : Result(input));
+		}
+		return batch;
+	}
+
+	void BatchVectorOfEither(benchmark::State& state)
+	{
+		const auto batch = MakeBatch(state);
+		Counters counters(state, sizeof(Result));
+		for (auto _ : state)
+		{
+			std::vector<Result> result;
+			result.reserve(batch.size());
+			for(const auto& either : batch) { result.push_back(either.Map(BatchMap).Bind(BatchBind)); }
+			benchmark::DoNotOptimize(result.data());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(1));
+	}
+
+	void BatchEitherColumn(benchmark::State& state)
+	{
+		const EitherColumn<int, long> batch(MakeBatch(state));
+		Counters counters(state, sizeof(long) + sizeof(std::uint64_t) / 64.0);
+		for (auto _ : state)
+		{
+			auto result = batch.Map(BatchMap).Bind(BatchBind);
+			benchmark::DoNotOptimize(result);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(1));
+	}
+
+	void BatchVectorOfOption(benchmark::State& state)
+	{
+		std::vector<Option<long>> batch;
+		for(const auto input : MakeInputs(state.range(1), state.range(0))) { batch.push_back(input < 0 ? Option<long>() : Option<long>(input)); }
+
+		Counters counters(state, sizeof(Option<long>));
+		for (auto _ : state)
+		{
+			std::vector<Option<long>> result;
+			result.reserve(batch.size());
+			for(const auto& option : batch) { result.push_back(option.Map(BatchMap)); }
+			benchmark::DoNotOptimize(result.data());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(1));
+	}
+
+	void BatchOptionColumn(benchmark::State& state)
+	{
+		OptionColumn<long> batch;
+		for(const auto input : MakeInputs(state.range(1), state.range(0)))
+		{
+			if(input < 0) { batch.PushNone(); } else { batch.PushSome(input); }
+		}
+
+		Counters counters(state, sizeof(long) + sizeof(std::uint64_t) / 64.0);
+		for (auto _ : state)
+		{
+			auto result = batch.Map(BatchMap);
+			benchmark::DoNotOptimize(result);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(1));
+	}
+
+	// Left rates, then batches of 10k and 1M
+	void BatchArgs(benchmark::internal::Benchmark* benchmark)
+	{
+		benchmark->ArgNames({ "leftPerMille", "batch" })->Unit(benchmark::kMicrosecond);
+		for(const long batch : { 10000, 1000000 })
+		{
+			for(const long leftPerMille : { 0, 10, 500, 1000 }) { benchmark->Args({ leftPerMille, batch }); }
+		}
+	}
+
+	BENCHMARK(BatchVectorOfEither)->Apply(BatchArgs);
+	BENCHMARK(BatchEitherColumn)->Apply(BatchArgs);
+	BENCHMARK(BatchVectorOfOption)->Apply(BatchArgs);
+	BENCHMARK(BatchOptionColumn)->Apply(BatchArgs);
+}
@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "Support.h"
+#include "../lib/ColumnFile.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// Sums the right values of 1M eithers, of which state.range(0) per mille are left, kept in a file. The baseline reads
+	// a row of tag and value per element and parses it into a std::vector of eithers; the column file is mapped and summed in place.
+
+	using Stored = Either<int, long>;
+
+	constexpr std::size_t FileElements = 1'000'000;
+
+	struct Files
+	{
+		explicit Files(const long leftPerMille)
+			: rows(std::filesystem::temp_directory_path() / "libmonad_bench_rows.bin"),
+			  column(std::filesystem::temp_directory_path() / "libmonad_bench_column.col")
+		{
+			EitherColumn<int, long> eithers;
+			std::ofstream out(rows, std::ios::binary | std::ios::trunc);
+			for(const auto input : MakeInputs(FileElements, leftPerMille))
+			{
+				const char tag = input < 0 ? 'L' : 'R';
+				out.write(&tag, 1);
+				if(input < 0)
+				{
+					const auto left = static_cast<int>(input);
+					out.write(reinterpret_cast<const char*>(&left), sizeof(left));
+					eithers.PushLeft(left);
+				}
+				else
+				{
+					out.write(reinterpret_cast<const char*>(&input), sizeof(input));
+					eithers.PushRight(input);
+				}
+			}
+			WriteColumnFile(column, eithers).ThrowIfLeft();
+		}
+
+		~Files()
+		{
+			std::filesystem::remove(rows);
+			std::filesystem::remove(column);
+		}
+
+		std::filesystem::path rows;
+		std::filesystem::path column;
+	};
+
+	void ParseIntoVector(benchmark::State& state)
+	{
+		const Files files(state.range(0));
+		Counters counters(state, sizeof(Stored));
+		for (auto _ : state)
+		{
+			std::ifstream in(files.rows, std::ios::binary);
+			std::vector<Stored> eithers;
+			char tag;
+			while(in.read(&tag, 1))
+			{
+				if(tag == 'L') { int left; in.read(reinterpret_cast<char*>(&left), sizeof(left)); eithers.emplace_back(left); }
+				else { long right; in.read(reinterpret_cast<char*>(&right), sizeof(right)); eithers.emplace_back(right); }
+			}
+
+			long sum = 0;
+			for(const auto& either : eithers) { either.Match([](int) {}, [&](const long right) { sum += right; }); }
+			benchmark::DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(state.iterations() * FileElements);
+	}
+
+	void MappedColumnFile(benchmark::State& state)
+	{
+		const Files files(state.range(0));
+		Counters counters(state, sizeof(long) + 1.0 / 8);
+		for (auto _ : state)
+		{
+			const auto view = OpenEitherColumnFile<int, long>(files.column).ThrowIfLeft();
+			long sum = 0;
+			view.WhenRight([&](const long right) { sum += right; });
+			benchmark::DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(state.iterations() * FileElements);
+	}
+
+	BENCHMARK(ParseIntoVector)->Arg(0)->Arg(100)->Unit(benchmark::kMillisecond);
+	BENCHMARK(MappedColumnFile)->Arg(0)->Arg(100)->Unit(benchmark::kMillisecond);
+}
@@ -0,0 +1,167 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "Baselines.h"
+#include "Support.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// A right value of each payload, long enough that a std::string payload allocates
+	template <typename T> T Sample();
+	template <> long Sample<long>() { return 42; }
+	template <> std::string Sample<std::string>() { return "a string too long for the small string buffer"; }
+
+	// Builds a right value in each of the compared types
+	template <typename Monad, typename T> Monad MakeRight(T value) { return Monad(std::move(value)); }
+	template <> VariantResult MakeRight<VariantResult, long>(long value) { return VariantResult(std::in_place_index<1>, value); }
+	template <> TextVariant MakeRight<TextVariant, std::string>(std::string value) { return TextVariant(std::in_place_index<1>, std::move(value)); }
+
+	template <typename Monad, typename T>
+	void Construct(benchmark::State& state)
+	{
+		const auto value = Sample<T>();
+		Counters counters(state, sizeof(Monad));
+		for (auto _ : state)
+		{
+			auto monad = MakeRight<Monad>(value);
+			benchmark::DoNotOptimize(monad);
+		}
+	}
+
+	template <typename Monad, typename T>
+	void Copy(benchmark::State& state)
+	{
+		const auto source = MakeRight<Monad>(Sample<T>());
+		Counters counters(state, sizeof(Monad));
+		for (auto _ : state)
+		{
+			auto copy = source;
+			benchmark::DoNotOptimize(copy);
+		}
+	}
+
+	// Moves back and forth between two objects, so that neither is left moved-from for long
+	template <typename Monad, typename T>
+	void Move(benchmark::State& state)
+	{
+		auto first = MakeRight<Monad>(Sample<T>());
+		auto second = MakeRight<Monad>(Sample<T>());
+		Counters counters(state, sizeof(Monad));
+		for (auto _ : state)
+		{
+			second = std::move(first);
+			first = std::move(second);
+			benchmark::DoNotOptimize(first);
+		}
+	}
+
+#define LIBMONAD_CONSTRUCTION_BENCHMARKS(Monad, T) \
+	BENCHMARK_TEMPLATE(Construct, Monad, T); \
+	BENCHMARK_TEMPLATE(Copy, Monad, T); \
+	BENCHMARK_TEMPLATE(Move, Monad, T)
+
+	LIBMONAD_CONSTRUCTION_BENCHMARKS(Result, long);
+	LIBMONAD_CONSTRUCTION_BENCHMARKS(VariantResult, long);
+	LIBMONAD_CONSTRUCTION_BENCHMARKS(Option<long>, long);
+	LIBMONAD_CONSTRUCTION_BENCHMARKS(std::optional<long>, long);
+	LIBMONAD_CONSTRUCTION_BENCHMARKS(TextResult, std::string);
+	LIBMONAD_CONSTRUCTION_BENCHMARKS(TextVariant, std::string);
+	LIBMONAD_CONSTRUCTION_BENCHMARKS(Option<std::string>, std::string);
+	LIBMONAD_CONSTRUCTION_BENCHMARKS(std::optional<std::string>, std::string);
+#if LIBMONAD_BENCH_EXPECTED
+	LIBMONAD_CONSTRUCTION_BENCHMARKS(ExpectedResult, long);
+	LIBMONAD_CONSTRUCTION_BENCHMARKS(TextExpected, std::string);
+#endif
+
+	// Building an either or option of a 512 byte payload from its constructor's arguments: passing a payload made first, which is
+	// moved into place, against making it in place
+
+	struct LargeRecord
+	{
+		explicit LargeRecord(const long seed) { for(std::size_t i = 0; i < fields.size(); i++) { fields[i] = seed + static_cast<long>(i); } }
+
+		std::array<long, 64> fields;
+	};
+
+	using LargeResult = Either<int, LargeRecord>;
+
+	void LargeEitherByValue(benchmark::State& state)
+	{
+		Counters counters(state, sizeof(LargeResult));
+		long seed = 0;
+		for (auto _ : state)
+		{
+			LargeResult result(LargeRecord(seed++));
+			benchmark::DoNotOptimize(result);
+		}
+	}
+
+	void LargeEitherInPlace(benchmark::State& state)
+	{
+		Counters counters(state, sizeof(LargeResult));
+		long seed = 0;
+		for (auto _ : state)
+		{
+			LargeResult result(inPlaceRight, seed++);
+			benchmark::DoNotOptimize(result);
+		}
+	}
+
+	void LargeOptionByValue(benchmark::State& state)
+	{
+		Counters counters(state, sizeof(Option<LargeRecord>));
+		long seed = 0;
+		for (auto _ : state)
+		{
+			Option<LargeRecord> option(LargeRecord(seed++));
+			benchmark::DoNotOptimize(option);
+		}
+	}
+
+	void LargeOptionInPlace(benchmark::State& state)
+	{
+		Counters counters(state, sizeof(Option<LargeRecord>));
+		long seed = 0;
+		for (auto _ : state)
+		{
+			Option<LargeRecord> option(std::in_place, seed++);
+			benchmark::DoNotOptimize(option);
+		}
+	}
+
+	// Reuses one either, as a loop filling in a result would
+	void LargeEitherAssign(benchmark::State& state)
+	{
+		LargeResult result(0);
+		Counters counters(state, sizeof(LargeResult));
+		long seed = 0;
+		for (auto _ : state)
+		{
+			result = LargeResult(LargeRecord(seed++));
+			benchmark::DoNotOptimize(result);
+		}
+	}
+
+	void LargeEitherEmplace(benchmark::State& state)
+	{
+		LargeResult result(0);
+		Counters counters(state, sizeof(LargeResult));
+		long seed = 0;
+		for (auto _ : state)
+		{
+			result.EmplaceRight(seed++);
+			benchmark::DoNotOptimize(result);
+		}
+	}
+
+	BENCHMARK(LargeEitherByValue);
+	BENCHMARK(LargeEitherInPlace);
+	BENCHMARK(LargeOptionByValue);
+	BENCHMARK(LargeOptionInPlace);
+	BENCHMARK(LargeEitherAssign);
+	BENCHMARK(LargeEitherEmplace);
+}
@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "Baselines.h"
+#include "Support.h"
+#include "../lib/Error.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// Parses inputs of which 30% fail, then maps and binds the result, with a std::string message or an Error as the left value.
+	// The parsed either is kept and mapped from, so each Map on a left copies it, as in code that inspects a result more than once.
+
+	const ErrorCode NegativeInput = RegisterError("negative input");
+	const ErrorCode TooLarge = RegisterError("too large");
+
+	using StringResult = Either<std::string, long>;
+
+	StringResult ParseWithString(const long input)
+	{
+		if(input < 0) { return "negative input: " + std::to_string(input); }
+		return input;
+	}
+
+	ErrorOr<long> ParseWithError(const long input)
+	{
+		if(input < 0) { return Error(NegativeInput, std::int64_t(input)); }
+		return input;
+	}
+
+	void StringLefts(benchmark::State& state)
+	{
+		const auto inputs = MakeInputs(4096, 300);
+		Counters counters(state, sizeof(StringResult));
+		for (auto _ : state)
+		{
+			for(const auto input : inputs)
+			{
+				const auto parsed = ParseWithString(input);
+				auto result = parsed
+					.Map(MapStage)
+					.Bind([](const long l) { return BindFails(l) ? StringResult("too large: " + std::to_string(l)) : StringResult(BindStage(l)); });
+				auto logged = parsed.Map(BindStage);
+				benchmark::DoNotOptimize(result);
+				benchmark::DoNotOptimize(logged);
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * inputs.size());
+	}
+
+	void ErrorLefts(benchmark::State& state)
+	{
+		const auto inputs = MakeInputs(4096, 300);
+		Counters counters(state, sizeof(ErrorOr<long>));
+		for (auto _ : state)
+		{
+			for(const auto input : inputs)
+			{
+				const auto parsed = ParseWithError(input);
+				auto result = parsed
+					.Map(MapStage)
+					.Bind([](const long l) { return BindFails(l) ? ErrorOr<long>(Error(TooLarge, std::int64_t(l))) : ErrorOr<long>(BindStage(l)); });
+				auto logged = parsed.Map(BindStage);
+				benchmark::DoNotOptimize(result);
+				benchmark::DoNotOptimize(logged);
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * inputs.size());
+	}
+
+	// The same with plain int error codes, which carry no context at all
+	void ErrorCodeLefts(benchmark::State& state)
+	{
+		const auto inputs = MakeInputs(4096, 300);
+		Counters counters(state, sizeof(Result));
+		for (auto _ : state)
+		{
+			for(const auto input : inputs)
+			{
+				const auto parsed = input < 0 ? Result(StageFailed) : Result(input);
+				auto result = parsed
+					.Map(MapStage)
+					.Bind([](const long l) { return BindFails(l) ? Result(StageFailed) : Result(BindStage(l)); });
+				auto logged = parsed.Map(BindStage);
+				benchmark::DoNotOptimize(result);
+				benchmark::DoNotOptimize(logged);
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * inputs.size());
+	}
+
+	BENCHMARK(StringLefts)->Unit(benchmark::kMicrosecond);
+	BENCHMARK(ErrorLefts)->Unit(benchmark::kMicrosecond);
+	BENCHMARK(ErrorCodeLefts)->Unit(benchmark::kMicrosecond);
+}
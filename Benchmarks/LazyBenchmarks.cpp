@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+
+#include <barrier>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "Support.h"
+#include "../lib/Lazy.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// Reading a value that has already been worked out, and 32 threads all forcing one that has not. The baseline is the
+	// ad hoc std::call_once that Lazy replaces.
+
+	constexpr std::size_t Forcers = 32;
+
+	// Stands in for parsing a config: pure, and slow enough that the first force is contended
+	long ParseSettings()
+	{
+		std::vector<long> settings(4096);
+		std::iota(settings.begin(), settings.end(), 0);
+		return std::accumulate(settings.begin(), settings.end(), 0L);
+	}
+
+	class OnceSettings
+	{
+	public:
+		long Get()
+		{
+			std::call_once(once, [this] { value = ParseSettings(); });
+			return value;
+		}
+
+	private:
+		std::once_flag once;
+		long value = 0;
+	};
+
+	void CallOnceRead(benchmark::State& state)
+	{
+		OnceSettings settings;
+		Counters counters(state, sizeof(OnceSettings));
+		for (auto _ : state) { benchmark::DoNotOptimize(settings.Get()); }
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void LazyRead(benchmark::State& state)
+	{
+		const auto settings = Defer(ParseSettings);
+		settings.Force();
+		Counters counters(state, sizeof(Lazy<long>));
+		for (auto _ : state) { benchmark::DoNotOptimize(settings.Force()); }
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// Each iteration makes a fresh value and releases Forcers threads, which are kept waiting on a barrier, to force it at once
+	template <typename Fresh, typename Force>
+	void ContendedFirstForce(benchmark::State& state, Fresh fresh, Force force)
+	{
+		std::barrier start(Forcers + 1);
+		std::barrier done(Forcers + 1);
+		bool stopping = false;
+		auto value = fresh();
+
+		std::vector<std::thread> forcers;
+		for(std::size_t i = 0; i < Forcers; i++)
+		{
+			forcers.emplace_back([&]
+			{
+				for(start.arrive_and_wait(); !stopping; start.arrive_and_wait())
+				{
+					benchmark::DoNotOptimize(force(value));
+					done.arrive_and_wait();
+				}
+			});
+		}
+
+		for (auto _ : state)
+		{
+			value = fresh();
+			start.arrive_and_wait();
+			done.arrive_and_wait();
+		}
+		stopping = true;
+		start.arrive_and_wait();
+		for(auto& forcer : forcers) { forcer.join(); }
+		state.SetItemsProcessed(state.iterations() * Forcers);
+	}
+
+	void CallOnceFirstForce(benchmark::State& state)
+	{
+		ContendedFirstForce(state, [] { return std::make_unique<OnceSettings>(); }, [](const std::unique_ptr<OnceSettings>& settings) { return settings->Get(); });
+	}
+
+	void LazyFirstForce(benchmark::State& state)
+	{
+		ContendedFirstForce(state, [] { return Defer(ParseSettings); }, [](const Lazy<long>& settings) { return settings.Force(); });
+	}
+
+	BENCHMARK(CallOnceRead);
+	BENCHMARK(LazyRead);
+	BENCHMARK(CallOnceFirstForce)->UseRealTime();
+	BENCHMARK(LazyFirstForce)->UseRealTime();
+}
@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+
+#include "Baselines.h"
+#include "Support.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// Extracting a value out of a result, over inputs of which state.range(0) per mille are left
+
+	template <typename Monad, typename Make, typename Extract>
+	void RunExtract(benchmark::State& state, Make make, Extract extract)
+	{
+		std::vector<Monad> monads;
+		for(const auto input : MakeInputs(4096, state.range(0))) { monads.push_back(make(input)); }
+		Counters counters(state, sizeof(Monad));
+		std::size_t next = 0;
+		for (auto _ : state)
+		{
+			auto value = extract(monads[next++ & 4095]);
+			benchmark::DoNotOptimize(value);
+		}
+	}
+
+	Result MakeEither(const long input) { return input < 0 ? Result(StageFailed) : Result(input); }
+	VariantResult MakeVariant(const long input) { return input < 0 ? VariantResult(std::in_place_index<0>, StageFailed) : VariantResult(input); }
+
+	void MatchEither(benchmark::State& state)
+	{
+		RunExtract<Result>(state, MakeEither, [](const Result& result)
+		{
+			return result.Match([](const int code) { return static_cast<long>(code); }, [](const long l) { return l; });
+		});
+	}
+
+	void WhenEither(benchmark::State& state)
+	{
+		RunExtract<Result>(state, MakeEither, [](const Result& result)
+		{
+			return result.WhenLeft([](const int code) { return static_cast<long>(code); });
+		});
+	}
+
+	void VisitVariant(benchmark::State& state)
+	{
+		RunExtract<VariantResult>(state, MakeVariant, [](const VariantResult& result)
+		{
+			return std::visit([](const auto value) { return static_cast<long>(value); }, result);
+		});
+	}
+
+#if LIBMONAD_BENCH_EXPECTED
+	void ValueOrExpected(benchmark::State& state)
+	{
+		RunExtract<ExpectedResult>(state, [](const long input)
+		{
+			return input < 0 ? ExpectedResult(std::unexpect, StageFailed) : ExpectedResult(input);
+		}, [](const ExpectedResult& result)
+		{
+			return result.has_value() ? *result : static_cast<long>(result.error());
+		});
+	}
+#endif
+
+	void MatchOption(benchmark::State& state)
+	{
+		RunExtract<Option<long>>(state, [](const long input)
+		{
+			return input < 0 ? Option<long>() : Option<long>(input);
+		}, [](const Option<long>& option)
+		{
+			return option.Match([](None) { return 0L; }, [](const long l) { return l; });
+		});
+	}
+
+	void WhenNoneOption(benchmark::State& state)
+	{
+		RunExtract<Option<long>>(state, [](const long input)
+		{
+			return input < 0 ? Option<long>() : Option<long>(input);
+		}, [](const Option<long>& option)
+		{
+			return option.WhenNone([] { return 0L; });
+		});
+	}
+
+	void ValueOrOptional(benchmark::State& state)
+	{
+		RunExtract<std::optional<long>>(state, [](const long input)
+		{
+			return input < 0 ? std::optional<long>() : std::optional<long>(input);
+		}, [](const std::optional<long>& option)
+		{
+			return option.value_or(0L);
+		});
+	}
+
+	void LeftRateArgs(benchmark::internal::Benchmark* benchmark)
+	{
+		benchmark->ArgName("leftPerMille")->Arg(0)->Arg(10)->Arg(500);
+	}
+
+	BENCHMARK(MatchEither)->Apply(LeftRateArgs);
+	BENCHMARK(WhenEither)->Apply(LeftRateArgs);
+	BENCHMARK(VisitVariant)->Apply(LeftRateArgs);
+#if LIBMONAD_BENCH_EXPECTED
+	BENCHMARK(ValueOrExpected)->Apply(LeftRateArgs);
+#endif
+	BENCHMARK(MatchOption)->Apply(LeftRateArgs);
+	BENCHMARK(WhenNoneOption)->Apply(LeftRateArgs);
+	BENCHMARK(ValueOrOptional)->Apply(LeftRateArgs);
+}
@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Support.h"
+#include "../lib/Memoize.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// Binds a pure but slow lookup over a stream of keys drawn from a Zipf distribution (s = 1) over 100,000 keys, so a few
+	// keys are hot and most are rare. The baseline calls the lookup every time; the memoised lookups keep the results of
+	// up to state.range(0) keys.
+
+	constexpr std::size_t KeySpace = 100000;
+	constexpr std::size_t Lookups = 100000;
+
+	std::vector<long> MakeZipfKeys()
+	{
+		std::vector<double> cumulative(KeySpace);
+		double total = 0;
+		for(std::size_t rank = 0; rank < KeySpace; rank++) { cumulative[rank] = total += 1.0 / static_cast<double>(rank + 1); }
+
+		std::mt19937 random(42);
+		std::uniform_real_distribution<double> uniform(0, total);
+		std::vector<long> keys(Lookups);
+		for(auto& key : keys)
+		{
+			key = static_cast<long>(std::lower_bound(cumulative.begin(), cumulative.end(), uniform(random)) - cumulative.begin());
+		}
+		return keys;
+	}
+
+	// Half a microsecond or so of hashing, failing for one key in eight
+	Either<int, long> SlowLookup(const long key)
+	{
+		auto hash = static_cast<std::uint64_t>(key);
+		for(int round = 0; round < 512; round++) { hash = (hash ^ (hash >> 31)) * 0x9E3779B97F4A7C15ull; }
+		if(key % 8 == 7) { return static_cast<int>(key); }
+		return static_cast<long>(hash >> 1);
+	}
+
+	template <typename Lookup>
+	long BindAll(const std::vector<long>& keys, Lookup& lookup)
+	{
+		long sum = 0;
+		for(const auto key : keys) { sum += Either<int, long>(key).Bind(lookup).Match([](int) { return 0L; }, [](const long l) { return l & 1; }); }
+		return sum;
+	}
+
+	void UnmemoisedZipf(benchmark::State& state)
+	{
+		const auto keys = MakeZipfKeys();
+		Counters counters(state, 0);
+		for (auto _ : state) { benchmark::DoNotOptimize(BindAll(keys, SlowLookup)); }
+		state.SetItemsProcessed(state.iterations() * Lookups);
+	}
+
+	void MemoisedZipf(benchmark::State& state)
+	{
+		const auto keys = MakeZipfKeys();
+		auto lookup = Memoize<long>(SlowLookup, static_cast<std::size_t>(state.range(0)));
+		Counters counters(state, 0);
+		for (auto _ : state) { benchmark::DoNotOptimize(BindAll(keys, lookup)); }
+		state.counters["hit rate"] = lookup.Stats().HitRate();
+		state.SetItemsProcessed(state.iterations() * Lookups);
+	}
+
+	void ShardedMemoisedZipf(benchmark::State& state)
+	{
+		const auto keys = MakeZipfKeys();
+		const auto lookup = MemoizeSharded<long>(SlowLookup, static_cast<std::size_t>(state.range(0)));
+		Counters counters(state, 0);
+		for (auto _ : state) { benchmark::DoNotOptimize(BindAll(keys, lookup)); }
+		state.counters["hit rate"] = lookup.Stats().HitRate();
+		state.SetItemsProcessed(state.iterations() * Lookups);
+	}
+
+	BENCHMARK(UnmemoisedZipf);
+	BENCHMARK(MemoisedZipf)->Arg(1024)->Arg(16384);
+	BENCHMARK(ShardedMemoisedZipf)->Arg(1024)->Arg(16384);
+}
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include "Baselines.h"
+#include "Support.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// Chains of state.range(0) stages, in which a bind stage turns the value into none rather than an error code
+
+	Option<long> OptionChain(const long input, const long stages)
+	{
+		auto option = input < 0 ? Option<long>() : Option<long>(input);
+		for(long stage = 0; stage < stages; stage++)
+		{
+			option = stage % 2 == 0
+				? std::move(option).Map([](const long l) { return MapStage(l); })
+				: std::move(option).Bind([](const long l) { return BindFails(l) ? Option<long>() : Option<long>(BindStage(l)); });
+		}
+		return option;
+	}
+
+	std::optional<long> OptionalChain(const long input, const long stages)
+	{
+		auto option = input < 0 ? std::optional<long>() : std::optional<long>(input);
+		for(long stage = 0; stage < stages && option; stage++)
+		{
+			const auto l = *option;
+			if(stage % 2 == 0) { option = MapStage(l); }
+			else if(BindFails(l)) { option.reset(); }
+			else { option = BindStage(l); }
+		}
+		return option;
+	}
+
+	template <typename Monad, typename Chain>
+	void RunOptionChain(benchmark::State& state, Chain chain)
+	{
+		const auto inputs = MakeInputs(4096, state.range(1));
+		const auto stages = state.range(0);
+		Counters counters(state, sizeof(Monad));
+		std::size_t next = 0;
+		for (auto _ : state)
+		{
+			auto result = chain(inputs[next++ & 4095], stages);
+			benchmark::DoNotOptimize(result);
+		}
+	}
+
+	void ChainOption(benchmark::State& state) { RunOptionChain<Option<long>>(state, OptionChain); }
+	void ChainOptional(benchmark::State& state) { RunOptionChain<std::optional<long>>(state, OptionalChain); }
+
+	void OptionChainArgs(benchmark::internal::Benchmark* benchmark)
+	{
+		benchmark->ArgNames({ "stages", "nonePerMille" });
+		for(const long stages : { 1, 2, 4, 8, 16 }) { benchmark->Args({ stages, 0 }); }
+		for(const long nonePerMille : { 10, 500 }) { benchmark->Args({ 8, nonePerMille }); }
+	}
+
+	BENCHMARK(ChainOption)->Apply(OptionChainArgs);
+	BENCHMARK(ChainOptional)->Apply(OptionChainArgs);
+}
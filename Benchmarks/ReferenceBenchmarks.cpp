@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "Support.h"
+#include "../lib/Option.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// Looks up 4 KB records in a cache of 1024 and reads a field of each, with 10% of lookups missing
+
+	struct CachedRecord
+	{
+		std::array<char, 4096> payload{};
+		long checksum = 0;
+	};
+
+	class RecordCache
+	{
+	public:
+		RecordCache() : records(1024)
+		{
+			for(std::size_t i = 0; i < records.size(); i++) { records[i].checksum = static_cast<long>(i); }
+		}
+
+		// Copies the record into the option, as an owning option has to
+		Option<CachedRecord> FindCopy(const std::size_t id) const
+		{
+			if(id % 10 == 9) { return None(); }
+			return records[id % records.size()];
+		}
+
+		Option<const CachedRecord&> Find(const std::size_t id) const
+		{
+			if(id % 10 == 9) { return None(); }
+			return records[id % records.size()];
+		}
+
+		const CachedRecord* FindPointer(const std::size_t id) const
+		{
+			if(id % 10 == 9) { return nullptr; }
+			return &records[id % records.size()];
+		}
+
+	private:
+		std::vector<CachedRecord> records;
+	};
+
+	auto Checksum = [](const CachedRecord& record) { return record.checksum; };
+
+	void LookupOwningOption(benchmark::State& state)
+	{
+		const RecordCache cache;
+		Counters counters(state, sizeof(Option<CachedRecord>));
+		std::size_t id = 0;
+		for (auto _ : state)
+		{
+			auto checksum = cache.FindCopy(id++).Map(Checksum);
+			benchmark::DoNotOptimize(checksum);
+		}
+	}
+
+	void LookupReferenceOption(benchmark::State& state)
+	{
+		const RecordCache cache;
+		Counters counters(state, sizeof(Option<const CachedRecord&>));
+		std::size_t id = 0;
+		for (auto _ : state)
+		{
+			auto checksum = cache.Find(id++).Map(Checksum);
+			benchmark::DoNotOptimize(checksum);
+		}
+	}
+
+	void LookupRawPointer(benchmark::State& state)
+	{
+		const RecordCache cache;
+		Counters counters(state, sizeof(const CachedRecord*));
+		std::size_t id = 0;
+		for (auto _ : state)
+		{
+			const auto record = cache.FindPointer(id++);
+			auto checksum = record ? Option<long>(record->checksum) : Option<long>();
+			benchmark::DoNotOptimize(checksum);
+		}
+	}
+
+	BENCHMARK(LookupOwningOption);
+	BENCHMARK(LookupReferenceOption);
+	BENCHMARK(LookupRawPointer);
+}
@@ -0,0 +1,25 @@
+# Runs monad_bench and writes its results as JSON to <OUTPUT_DIR>/<commit>.json, so runs can be compared commit by commit
+#
+# cmake -DBENCHMARK=<path to monad_bench> -DOUTPUT_DIR=<dir> -DSOURCE_DIR=<repo> -P RunBenchmarks.cmake
+
+execute_process(
+	COMMAND git rev-parse --short HEAD
+	WORKING_DIRECTORY ${SOURCE_DIR}
+	OUTPUT_VARIABLE COMMIT
+	OUTPUT_STRIP_TRAILING_WHITESPACE
+	RESULT_VARIABLE GIT_RESULT
+	ERROR_QUIET
+)
+
+if(NOT GIT_RESULT EQUAL 0 OR COMMIT STREQUAL "")
+	set(COMMIT "unversioned")
+endif()
+
+file(MAKE_DIRECTORY ${OUTPUT_DIR})
+
+execute_process(
+	COMMAND ${BENCHMARK} --benchmark_out=${OUTPUT_DIR}/${COMMIT}.json --benchmark_out_format=json
+	COMMAND_ERROR_IS_FATAL ANY
+)
+
+message(STATUS "Benchmark results written to ${OUTPUT_DIR}/${COMMIT}.json")
@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "Baselines.h"
+#include "Support.h"
+#include "../lib/Stream.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// Runs state.range(0) synthetic records, 1 in 100 of them left, through Map, Bind and Filter and sums what is left.
+	// The stream pulls one record at a time through every stage; the eager version buffers every record, then each stage's output.
+	// maxRSS is the process's peak resident memory so far, so run one benchmark at a time (--benchmark_filter) to compare it.
+
+	constexpr long LeftPerMille = 10;
+
+	Result Synthetic(const std::uint64_t i)
+	{
+		return (i * 2654435761u) % 1000 < LeftPerMille ? Result(StageFailed) : Result(static_cast<long>(i % 1000000));
+	}
+
+	EitherStream<int, long> SyntheticStream(const std::uint64_t count)
+	{
+		for(std::uint64_t i = 0; i < count; i++) { co_yield Synthetic(i); }
+	}
+
+	constexpr auto StreamMap = [](const long l) { return MapStage(l); };
+	constexpr auto StreamBind = [](const long l) { return BindFails(l) ? Result(StageFailed) : Result(BindStage(l)); };
+	constexpr auto StreamFilter = [](const long l) { return l % 2 == 0; };
+
+	void ReportMaxRss(benchmark::State& state)
+	{
+#ifndef _WIN32
+		rusage usage {};
+		getrusage(RUSAGE_SELF, &usage);
+		state.counters["maxRSS(MB)"] = static_cast<double>(usage.ru_maxrss) / 1024;
+#endif
+	}
+
+	void StreamStages(benchmark::State& state)
+	{
+		const auto count = static_cast<std::uint64_t>(state.range(0));
+		Counters counters(state, sizeof(Result));
+		for (auto _ : state)
+		{
+			long sum = 0;
+			for(auto& result : SyntheticStream(count).Map(StreamMap).Bind(StreamBind).Filter(StreamFilter))
+			{
+				result.Match([](int) {}, [&](const long l) { sum += l; });
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+		ReportMaxRss(state);
+	}
+
+	void EagerVectorStages(benchmark::State& state)
+	{
+		const auto count = static_cast<std::uint64_t>(state.range(0));
+		Counters counters(state, sizeof(Result));
+		for (auto _ : state)
+		{
+			std::vector<Result> records;
+			for(std::uint64_t i = 0; i < count; i++) { records.push_back(Synthetic(i)); }
+
+			std::vector<Result> mapped;
+			mapped.reserve(records.size());
+			for(auto& record : records) { mapped.push_back(std::move(record).Map(StreamMap)); }
+
+			std::vector<Result> bound;
+			bound.reserve(mapped.size());
+			for(auto& record : mapped) { bound.push_back(std::move(record).Bind(StreamBind)); }
+
+			std::vector<Result> filtered;
+			for(auto& record : bound)
+			{
+				if(record.IsLeft() || StreamFilter(record.ThrowIfLeft())) { filtered.push_back(std::move(record)); }
+			}
+
+			long sum = 0;
+			for(const auto& result : filtered) { result.Match([](int) {}, [&](const long l) { sum += l; }); }
+			benchmark::DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+		ReportMaxRss(state);
+	}
+
+	BENCHMARK(StreamStages)->Arg(10'000'000)->Arg(100'000'000)->Unit(benchmark::kMillisecond);
+	BENCHMARK(EagerVectorStages)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+}
@@ -0,0 +1,86 @@
+#include "Support.h"
+
+#include <cstdlib>
+#include <new>
+#include <random>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+namespace
+{
+	thread_local std::uint64_t allocations = 0;
+
+	void* Allocate(const std::size_t size)
+	{
+		allocations++;
+		if(auto memory = std::malloc(size == 0 ? 1 : size)) { return memory; }
+		throw std::bad_alloc();
+	}
+
+	void* AllocateAligned(const std::size_t size, const std::align_val_t alignment)
+	{
+		allocations++;
+		const auto align = static_cast<std::size_t>(alignment);
+#ifdef _MSC_VER
+		if(auto memory = _aligned_malloc(size == 0 ? 1 : size, align)) { return memory; }
+#else
+		if(auto memory = std::aligned_alloc(align, (size + align - 1) / align * align)) { return memory; }
+#endif
+		throw std::bad_alloc();
+	}
+
+	// MSVC has no std::aligned_alloc, and memory from _aligned_malloc must be given back to _aligned_free
+	void FreeAligned(void* memory) noexcept
+	{
+#ifdef _MSC_VER
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+}
+
+// Count every heap allocation, so benchmarks can report allocations per operation
+
+void* operator new(const std::size_t size) { return Allocate(size); }
+void* operator new[](const std::size_t size) { return Allocate(size); }
+void* operator new(const std::size_t size, const std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+void* operator new[](const std::size_t size, const std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { FreeAligned(memory); }
+
+namespace Benchmarks
+{
+	std::uint64_t Allocations() { return allocations; }
+
+	Counters::Counters(benchmark::State& state, const double bytesPerObject)
+		: state(state), bytesPerObject(bytesPerObject), allocationsBefore(Allocations()) {}
+
+	Counters::~Counters()
+	{
+		state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(Allocations() - allocationsBefore), benchmark::Counter::kAvgIterations);
+		state.counters["bytes/obj"] = bytesPerObject;
+	}
+
+	std::vector<long> MakeInputs(const std::size_t count, const long leftPerMille)
+	{
+		std::mt19937 random(42);
+		std::uniform_int_distribution<long> perMille(0, 999);
+		std::uniform_int_distribution<long> value(1, 1000000);
+
+		std::vector<long> inputs(count);
+		for(auto& input : inputs)
+		{
+			input = perMille(random) < leftPerMille ? -value(random) : value(random);
+		}
+		return inputs;
+	}
+}
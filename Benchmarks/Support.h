@@ -0,0 +1,49 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Benchmarks
+{
+	/**
+	 * \brief How many heap allocations this thread has made, counted by the replacement operator new in Support.cpp
+	 * \return number of allocations so far
+	 */
+	std::uint64_t Allocations();
+
+	/**
+	 * \brief Reports allocations per operation and the size of the object under test alongside the time
+	 */
+	class Counters
+	{
+	public:
+		/**
+		 * \brief Starts counting
+		 * \param state benchmark being run
+		 * \param bytesPerObject size of the object under test, or average bytes per element for a column
+		 */
+		Counters(benchmark::State& state, double bytesPerObject);
+
+		/**
+		 * \brief Reports what was counted since construction
+		 */
+		~Counters();
+
+	private:
+		benchmark::State& state;
+		double bytesPerObject;
+		std::uint64_t allocationsBefore;
+	};
+
+	/**
+	 * \brief Makes inputs for a chain, of which leftPerMille in every thousand are negative and so parse to a left value
+	 * \param count number of inputs
+	 * \param leftPerMille how many in a thousand parse to a left value
+	 * \return inputs, in a fixed pseudo-random order
+	 */
+	std::vector<long> MakeInputs(std::size_t count, long leftPerMille);
+
+}
@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+
+#include "Baselines.h"
+#include "Support.h"
+#include "../lib/Task.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// Four fallible steps in a row, written as nested binds, as a coroutine and by hand.
+	// Each step fails when its input is a multiple of 1009, so about one in 250 inputs ends early.
+
+	Result Step(const long l)
+	{
+		if(BindFails(l)) { return StageFailed; }
+		return BindStage(MapStage(l));
+	}
+
+	// Nested binds through the std::function overloads, as in Tests/BindTests.cpp
+	void StepsNestedBind(benchmark::State& state)
+	{
+		Counters counters(state, sizeof(Result));
+		long input = 1;
+		for (auto _ : state)
+		{
+			auto result = Step(input++).Bind<long>([](const long a)
+			{
+				return Step(a).Bind<long>([](const long b)
+				{
+					return Step(b).Bind<long>([](const long c) { return Step(c); });
+				});
+			});
+			benchmark::DoNotOptimize(result);
+		}
+	}
+
+	// The same binds through the overloads templated on the callable
+	void StepsTemplatedBind(benchmark::State& state)
+	{
+		Counters counters(state, sizeof(Result));
+		long input = 1;
+		for (auto _ : state)
+		{
+			auto result = Step(input++).Bind(Step).Bind(Step).Bind(Step);
+			benchmark::DoNotOptimize(result);
+		}
+	}
+
+	// The same steps with early returns written by hand
+	void StepsHandWritten(benchmark::State& state)
+	{
+		Counters counters(state, sizeof(Result));
+		long input = 1;
+		for (auto _ : state)
+		{
+			auto run = [](long l) -> Result
+			{
+				for(int i = 0; i < 4; i++)
+				{
+					if(BindFails(l)) { return StageFailed; }
+					l = BindStage(MapStage(l));
+				}
+				return l;
+			};
+
+			auto result = run(input++);
+			benchmark::DoNotOptimize(result);
+		}
+	}
+
+	EitherTask<int, long> Steps(const long input)
+	{
+		const long a = co_await Step(input);
+		const long b = co_await Step(a);
+		const long c = co_await Step(b);
+		co_return co_await Step(c);
+	}
+
+	// The same steps as a coroutine, its frame from the thread's frame pool unless the compiler elides it
+	void StepsTask(benchmark::State& state)
+	{
+		Counters counters(state, sizeof(Result));
+		long input = 1;
+		for (auto _ : state)
+		{
+			Result result = Steps(input++);
+			benchmark::DoNotOptimize(result);
+		}
+	}
+
+	// The same coroutine with its frame from the global operator new, as without a frame pool
+	void StepsTaskNewDelete(benchmark::State& state)
+	{
+		NewDeleteFrameAllocator newDelete;
+		const auto previous = SetFrameAllocator(&newDelete);
+		{
+			Counters counters(state, sizeof(Result));
+			long input = 1;
+			for (auto _ : state)
+			{
+				Result result = Steps(input++);
+				benchmark::DoNotOptimize(result);
+			}
+		}
+		SetFrameAllocator(previous);
+	}
+
+	BENCHMARK(StepsNestedBind);
+	BENCHMARK(StepsTemplatedBind);
+	BENCHMARK(StepsHandWritten);
+	BENCHMARK(StepsTask);
+	BENCHMARK(StepsTaskNewDelete);
+}
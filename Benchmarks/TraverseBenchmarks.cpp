@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "Support.h"
+#include "Baselines.h"
+#include "../lib/Traverse.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// Traverses a million inputs with a function doing about a hundred operations each.
+	// state.range(0) says where the only left value is: 0 for nowhere, 1 for a tenth of the way in, 2 for nine tenths of the way in.
+
+	constexpr std::size_t TraverseCount = 1000000;
+
+	std::vector<long> MakeTraverseInputs(const long failAt)
+	{
+		std::vector<long> inputs(TraverseCount);
+		for(std::size_t i = 0; i < inputs.size(); i++) { inputs[i] = static_cast<long>(i); }
+		if(failAt == 1) { inputs[TraverseCount / 10] = -1; }
+		if(failAt == 2) { inputs[TraverseCount / 10 * 9] = -1; }
+		return inputs;
+	}
+
+	// A short xorshift loop the compiler cannot fold away, failing on negative inputs
+	constexpr auto Work = [](const long input)
+	{
+		if(input < 0) { return Result(StageFailed); }
+		auto x = static_cast<unsigned long>(input) | 1;
+		for(int i = 0; i < 32; i++)
+		{
+			x ^= x << 13;
+			x ^= x >> 7;
+			x ^= x << 17;
+		}
+		return Result(static_cast<long>(x >> 1));
+	};
+
+	void TraverseSequential(benchmark::State& state)
+	{
+		const auto inputs = MakeTraverseInputs(state.range(0));
+		Counters counters(state, sizeof(Result));
+		for (auto _ : state)
+		{
+			auto result = Traverse(inputs, Work);
+			benchmark::DoNotOptimize(result);
+		}
+		state.SetItemsProcessed(state.iterations() * inputs.size());
+	}
+
+	// state.range(1) is the number of threads in the pool, besides the calling thread
+	void TraverseParallel(benchmark::State& state)
+	{
+		const auto inputs = MakeTraverseInputs(state.range(0));
+		ThreadPool pool(static_cast<std::size_t>(state.range(1)));
+		Counters counters(state, sizeof(Result));
+		for (auto _ : state)
+		{
+			auto result = Traverse(pool, inputs, Work);
+			benchmark::DoNotOptimize(result);
+		}
+		state.SetItemsProcessed(state.iterations() * inputs.size());
+	}
+
+	void FailurePositions(benchmark::internal::Benchmark* benchmark)
+	{
+		benchmark->ArgName("failAt")->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+	}
+
+	void PoolSizes(benchmark::internal::Benchmark* benchmark)
+	{
+		benchmark->ArgNames({ "failAt", "threads" })->Unit(benchmark::kMillisecond)->UseRealTime();
+		for(long failAt = 0; failAt <= 2; failAt++)
+		{
+			for(const long threads : { 1, 2, 4, 8, 16, 32, 64 }) { benchmark->Args({ failAt, threads }); }
+		}
+	}
+
+	BENCHMARK(TraverseSequential)->Apply(FailurePositions);
+	BENCHMARK(TraverseParallel)->Apply(PoolSizes);
+}
@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "Support.h"
+#include "../lib/Either.h"
+#include "../lib/Option.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// Grows a std::vector to 10M eithers or options one element at a time, and copies it whole. Trivially copyable elements
+	// are copied with memcpy; the same value with a user-provided copy, as every Either and Option had before, goes element by element.
+
+	constexpr std::size_t VectorSize = 10'000'000;
+
+	/**
+	 * \brief A T whose copy and move are user provided, so an either or option holding it is not trivially copyable
+	 */
+	template <typename T>
+	struct UserCopied
+	{
+		UserCopied(const T value) : value(value) {}
+		UserCopied(const UserCopied& other) : value(other.value) {}
+		UserCopied& operator=(const UserCopied& other) { value = other.value; return *this; }
+		T value;
+	};
+
+	template <typename T>
+	T Element(const std::size_t i)
+	{
+		if constexpr (IsOption<T>::value) { return i % 4 == 0 ? T() : T(static_cast<int>(i)); }
+		else { return i % 4 == 0 ? T(static_cast<int>(i)) : T(static_cast<float>(i)); }
+	}
+
+	template <typename T>
+	void GrowVector(benchmark::State& state)
+	{
+		Counters counters(state, sizeof(T));
+		for (auto _ : state)
+		{
+			std::vector<T> vector;
+			for(std::size_t i = 0; i < VectorSize; i++) { vector.push_back(Element<T>(i)); }
+			benchmark::DoNotOptimize(vector.data());
+		}
+		state.SetItemsProcessed(state.iterations() * VectorSize);
+	}
+
+	template <typename T>
+	void CopyVector(benchmark::State& state)
+	{
+		std::vector<T> source;
+		source.reserve(VectorSize);
+		for(std::size_t i = 0; i < VectorSize; i++) { source.push_back(Element<T>(i)); }
+
+		Counters counters(state, sizeof(T));
+		for (auto _ : state)
+		{
+			auto copy = source;
+			benchmark::DoNotOptimize(copy.data());
+		}
+		state.SetBytesProcessed(state.iterations() * VectorSize * sizeof(T));
+	}
+
+	using TrivialEither = Either<int, float>;
+	using UserCopiedEither = Either<int, UserCopied<float>>;
+	using TrivialOption = Option<int>;
+	using UserCopiedOption = Option<UserCopied<int>>;
+
+	static_assert(sizeof(TrivialEither) == sizeof(UserCopiedEither) && sizeof(TrivialOption) == sizeof(UserCopiedOption));
+
+	BENCHMARK_TEMPLATE(GrowVector, TrivialEither)->Unit(benchmark::kMillisecond);
+	BENCHMARK_TEMPLATE(GrowVector, UserCopiedEither)->Unit(benchmark::kMillisecond);
+	BENCHMARK_TEMPLATE(GrowVector, TrivialOption)->Unit(benchmark::kMillisecond);
+	BENCHMARK_TEMPLATE(GrowVector, UserCopiedOption)->Unit(benchmark::kMillisecond);
+	BENCHMARK_TEMPLATE(CopyVector, TrivialEither)->Unit(benchmark::kMillisecond);
+	BENCHMARK_TEMPLATE(CopyVector, UserCopiedEither)->Unit(benchmark::kMillisecond);
+	BENCHMARK_TEMPLATE(CopyVector, TrivialOption)->Unit(benchmark::kMillisecond);
+	BENCHMARK_TEMPLATE(CopyVector, UserCopiedOption)->Unit(benchmark::kMillisecond);
+}
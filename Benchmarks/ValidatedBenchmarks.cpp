@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Support.h"
+#include "../lib/Error.h"
+#include "../lib/Validated.h"
+using namespace libmonad;
+
+namespace Benchmarks
+{
+	// Validates a batch of requests of 20 numeric fields, of which state.range(0) per mille are out of range, and keeps
+	// every error of a request. The baseline runs each check separately and pushes a message into a std::vector<std::string>;
+	// Validated runs the checks together with Combine() and keeps up to 4 errors of each request in place.
+
+	constexpr std::size_t Fields = 20;
+	constexpr std::size_t Requests = 1000;
+
+	using Request = std::array<long, Fields>;
+
+	const ErrorCode FieldOutOfRange = RegisterError("field out of range");
+
+	std::vector<Request> MakeRequests(const long badPerMille)
+	{
+		std::mt19937 random(42);
+		std::uniform_int_distribution<long> perMille(0, 999);
+		std::vector<Request> requests(Requests);
+		for(auto& request : requests)
+		{
+			for(auto& field : request) { field = perMille(random) < badPerMille ? -1 : perMille(random); }
+		}
+		return requests;
+	}
+
+	bool InRange(const long value) { return value >= 0 && value < 1000; }
+
+	Validated<Error, long> CheckField(const long value, const std::size_t field)
+	{
+		if(!InRange(value)) { return Error(FieldOutOfRange, static_cast<std::int64_t>(field)); }
+		return value;
+	}
+
+	template <std::size_t... I>
+	Validated<Error, Request> CheckRequest(const Request& request, std::index_sequence<I...>)
+	{
+		return Combine([](const auto... values) { return Request{ values... }; }, CheckField(request[I], I)...);
+	}
+
+	void VectorOfStringErrors(benchmark::State& state)
+	{
+		const auto requests = MakeRequests(state.range(0));
+		Counters counters(state, sizeof(std::vector<std::string>));
+		for (auto _ : state)
+		{
+			std::size_t errorCount = 0;
+			for(const auto& request : requests)
+			{
+				std::vector<std::string> errors;
+				Request checked {};
+				for(std::size_t field = 0; field < Fields; field++)
+				{
+					if(!InRange(request[field])) { errors.push_back("field " + std::to_string(field) + " out of range"); }
+					else { checked[field] = request[field]; }
+				}
+				errorCount += errors.size();
+				benchmark::DoNotOptimize(checked);
+			}
+			benchmark::DoNotOptimize(errorCount);
+		}
+		state.SetItemsProcessed(state.iterations() * Requests);
+	}
+
+	void ValidatedCombine(benchmark::State& state)
+	{
+		const auto requests = MakeRequests(state.range(0));
+		Counters counters(state, sizeof(Validated<Error, Request>));
+		for (auto _ : state)
+		{
+			std::size_t errorCount = 0;
+			for(const auto& request : requests)
+			{
+				const auto checked = CheckRequest(request, std::make_index_sequence<Fields>());
+				errorCount += checked.Errors().Size();
+				benchmark::DoNotOptimize(checked);
+			}
+			benchmark::DoNotOptimize(errorCount);
+		}
+		state.SetItemsProcessed(state.iterations() * Requests);
+	}
+
+	BENCHMARK(VectorOfStringErrors)->Arg(0)->Arg(100);
+	BENCHMARK(ValidatedCombine)->Arg(0)->Arg(100);
+}
@@ -0,0 +1,354 @@
+#include "pch.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../lib/Async.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	// Left value is an error code
+	using Result = Either<int, long>;
+
+	constexpr int NotFound = -1;
+	constexpr int Odd = -2;
+
+	// Runs work straight away, counting how much was posted
+	class CountingExecutor final : public Executor
+	{
+	public:
+		void Post(Work& work) override
+		{
+			posted++;
+			work.run(work);
+		}
+
+		int posted = 0;
+	};
+
+	// Answers reads from its own thread a little later, as a disk or a socket would
+	class SimulatedDisk
+	{
+	public:
+		explicit SimulatedDisk(Executor& executor) : executor(executor), thread([this] { Serve(); }) {}
+
+		~SimulatedDisk()
+		{
+			{
+				std::lock_guard lock(mutex);
+				stopping = true;
+			}
+			wake.notify_one();
+			thread.join();
+		}
+
+		void Write(const std::string& name, const std::string& contents) { files[name] = contents; }
+
+		AsyncEither<int, std::string> Read(const std::string& name)
+		{
+			EitherPromise<int, std::string> promise(executor);
+			auto pending = promise.GetAsync();
+			{
+				std::lock_guard lock(mutex);
+				requests.emplace_back(name, std::move(promise));
+			}
+			wake.notify_one();
+			return pending;
+		}
+
+	private:
+		void Serve()
+		{
+			std::unique_lock lock(mutex);
+			for(;;)
+			{
+				wake.wait(lock, [this] { return stopping || !requests.empty(); });
+				if(requests.empty()) { return; }
+				auto [name, promise] = std::move(requests.front());
+				requests.pop_front();
+
+				lock.unlock();
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				const auto file = files.find(name);
+				promise.Complete(file == files.end() ? Either<int, std::string>(NotFound) : Either<int, std::string>(file->second));
+				lock.lock();
+			}
+		}
+
+		Executor& executor;
+		std::map<std::string, std::string> files;
+		std::deque<std::pair<std::string, EitherPromise<int, std::string>>> requests;
+		std::mutex mutex;
+		std::condition_variable wake;
+		bool stopping = false;
+		std::thread thread;
+	};
+
+	auto halve = [](const long l) { return l % 2 == 0 ? Result(l / 2) : Result(Odd); };
+
+	TEST(AsyncTests, MapRunsOnceValueArrives)
+	{
+		InlineExecutor executor;
+		EitherPromise<int, long> promise(executor);
+		auto pending = promise.GetAsync().Map([](const long l) { return l * 3; });
+
+		EXPECT_FALSE(pending.IsReady());
+		promise.Complete(Result(14L));
+
+		EXPECT_TRUE(pending.IsReady());
+		EXPECT_EQ(std::move(pending).Get(), Result(42L));
+	}
+
+	TEST(AsyncTests, MapRunsOnValueThatHasAlreadyArrived)
+	{
+		InlineExecutor executor;
+		auto result = AsyncEither<int, long>::Ready(Result(14L), executor)
+			.Map([](const long l) { return l * 3; })
+			.Bind(halve)
+			.Map([](const long l) { return std::to_string(l); });
+
+		EXPECT_EQ(std::move(result).Get(), (Either<int, std::string>(std::string("21"))));
+	}
+
+	TEST(AsyncTests, LeftValueSkipsStagesWithoutSchedulingThem)
+	{
+		CountingExecutor executor;
+		EitherPromise<int, long> promise(executor);
+		auto calls = 0;
+		auto pending = promise.GetAsync()
+			.Map([&](const long l) { calls++; return l + 1; })
+			.Bind([&](const long l) { calls++; return halve(l); })
+			.Map([&](const long l) { calls++; return l; });
+
+		promise.Complete(Result(NotFound));
+
+		EXPECT_EQ(std::move(pending).Get(), Result(NotFound));
+		EXPECT_EQ(calls, 0);
+		EXPECT_EQ(executor.posted, 0);
+	}
+
+	TEST(AsyncTests, BindLeftValueSkipsLaterStages)
+	{
+		CountingExecutor executor;
+		auto later = 0;
+		auto pending = AsyncEither<int, long>::Ready(Result(3L), executor)
+			.Bind(halve)
+			.Map([&](const long l) { later++; return l; });
+
+		EXPECT_EQ(std::move(pending).Get(), Result(Odd));
+		EXPECT_EQ(executor.posted, 1);
+		EXPECT_EQ(later, 0);
+	}
+
+	TEST(AsyncTests, LeftValueIsPassedOnAsLeft)
+	{
+		// The left value converts to the right type too, and must still arrive as the left
+		InlineExecutor executor;
+		auto result = AsyncEither<int, long>::Ready(Result(Odd), executor)
+			.Bind([](const long l) { return Either<int, double>(inPlaceRight, l * 0.5); })
+			.Map([](const double d) { return d + 1; });
+
+		EXPECT_EQ(std::move(result).Get(), (Either<int, double>(inPlaceLeft, Odd)));
+	}
+
+	TEST(AsyncTests, MatchCallsOneAction)
+	{
+		InlineExecutor executor;
+		auto left = 0;
+		long right = 0;
+
+		AsyncEither<int, long>::Ready(Result(5L), executor).Match([&](int) { left++; }, [&](const long l) { right = l; });
+		AsyncEither<int, long>::Ready(Result(Odd), executor).Match([&](int) { left++; }, [&](const long l) { right = l; });
+
+		EXPECT_EQ(left, 1);
+		EXPECT_EQ(right, 5);
+	}
+
+	TEST(AsyncTests, BindChainsReadsFromSimulatedDisk)
+	{
+		WorkStealingExecutor executor(2);
+		SimulatedDisk disk(executor);
+		disk.Write("index", "data");
+		disk.Write("data", "12345");
+
+		auto size = disk.Read("index")
+			.Bind([&](const std::string& next) { return disk.Read(next); })
+			.Map([](const std::string& contents) { return static_cast<long>(contents.size()); });
+		auto missing = disk.Read("index")
+			.Bind([&](const std::string&) { return disk.Read("nowhere"); })
+			.Map([](const std::string& contents) { return static_cast<long>(contents.size()); });
+
+		EXPECT_EQ(std::move(size).Get(), Result(5L));
+		EXPECT_EQ(std::move(missing).Get(), Result(NotFound));
+	}
+
+	TEST(AsyncTests, OptionNoneSkipsStages)
+	{
+		CountingExecutor executor;
+		OptionPromise<int> promise(executor);
+		auto pending = promise.GetAsync()
+			.Map([](const int i) { return i * 2; })
+			.Bind([](const int i) { return i > 10 ? Option<int>(i) : Option<int>(); });
+
+		promise.Complete(None());
+
+		EXPECT_EQ(std::move(pending).Get(), None());
+		EXPECT_EQ(executor.posted, 0);
+	}
+
+	TEST(AsyncTests, OptionMapAndBind)
+	{
+		InlineExecutor executor;
+		auto big = AsyncOption<int>::Ready(Option<int>(6), executor)
+			.Map([](const int i) { return i * 2; })
+			.Bind([](const int i) { return i > 10 ? Option<int>(i) : Option<int>(); });
+		auto small = AsyncOption<int>::Ready(Option<int>(2), executor)
+			.Map([](const int i) { return i * 2; })
+			.Bind([](const int i) { return i > 10 ? Option<int>(i) : Option<int>(); });
+
+		EXPECT_EQ(std::move(big).Get(), Option<int>(12));
+		EXPECT_EQ(std::move(small).Get(), None());
+	}
+
+	TEST(AsyncTests, CompletingWhileAttachingFromAnotherThread)
+	{
+		WorkStealingExecutor executor(4);
+		for(long i = 0; i < 2000; i++)
+		{
+			EitherPromise<int, long> promise(executor);
+			auto pending = promise.GetAsync();
+			std::thread completer([&promise, i] { promise.Complete(i % 3 == 0 ? Result(NotFound) : Result(i * 2)); });
+			auto result = std::move(pending).Map([](const long l) { return l + 2; }).Bind(halve);
+			completer.join();
+
+			EXPECT_EQ(std::move(result).Get(), i % 3 == 0 ? Result(NotFound) : Result(i + 1)) << i;
+		}
+	}
+
+	TEST(AsyncTests, ManyChainsAcrossWorkStealingExecutor)
+	{
+		WorkStealingExecutor executor(4);
+		std::vector<EitherPromise<int, long>> promises;
+		std::vector<AsyncEither<int, long>> results;
+		for(long i = 0; i < 1000; i++)
+		{
+			promises.emplace_back(executor);
+			results.push_back(promises.back().GetAsync()
+				.Map([](const long l) { return l * 4; })
+				.Bind(halve)
+				.Bind(halve)
+				.Map([](const long l) { return l + 1; }));
+		}
+		for(long i = 0; i < 1000; i++) { promises[i].Complete(i % 10 == 0 ? Result(NotFound) : Result(i)); }
+
+		for(long i = 0; i < 1000; i++)
+		{
+			EXPECT_EQ(std::move(results[i]).Get(), i % 10 == 0 ? Result(NotFound) : Result(i + 1)) << i;
+		}
+	}
+
+#ifndef LIBMONAD_NO_EXCEPTIONS
+	TEST(AsyncTests, ThrowingStageSkipsLaterStagesAndGetRethrows)
+	{
+		WorkStealingExecutor executor(2);
+		auto later = 0;
+		auto thrown = AsyncEither<int, long>::Ready(Result(4L), executor)
+			.Map([](const long l) -> long { if(l > 3) { throw std::runtime_error("too big"); } return l; })
+			.Bind(halve)
+			.Map([&](const long l) { later++; return l; });
+		auto inner = AsyncEither<int, long>::Ready(Result(4L), executor)
+			.Bind([&](const long l) { return AsyncEither<int, long>::Ready(Result(l), executor).Map([](long) -> long { throw std::logic_error("inner"); }); })
+			.Map([&](const long l) { later++; return l; });
+
+		EXPECT_THROW(std::move(thrown).Get(), std::runtime_error);
+		EXPECT_THROW(std::move(inner).Get(), std::logic_error);
+		EXPECT_EQ(later, 0);
+	}
+
+	TEST(AsyncTests, MatchCanBeHandedWhatAStageThrew)
+	{
+		InlineExecutor executor;
+		std::string caught;
+		AsyncEither<int, long>::Ready(Result(4L), executor)
+			.Map([](long) -> long { throw std::runtime_error("too big"); })
+			.Match([](int) {}, [](long) {}, [&](const std::exception_ptr& thrown)
+			{
+				try { std::rethrow_exception(thrown); }
+				catch(const std::runtime_error& error) { caught = error.what(); }
+			});
+
+		EXPECT_EQ(caught, "too big");
+	}
+#endif
+
+#if LIBMONAD_ERROR_POLICY == LIBMONAD_ERROR_POLICY_THROW
+	TEST(AsyncTests, DroppedPromiseBreaksItsAsync)
+	{
+		InlineExecutor executor;
+		const auto captured = std::make_shared<int>(0);
+		std::optional<AsyncEither<int, long>> pending;
+		{
+			EitherPromise<int, long> promise(executor);
+			pending = promise.GetAsync().Map([captured](const long l) { return l + *captured; });
+		}
+
+		EXPECT_TRUE(pending->IsReady());
+		EXPECT_THROW(std::move(*pending).Get(), std::runtime_error);
+
+		// The stage waiting on the promise has been freed along with what it captured, rather than leaked
+		pending.reset();
+		EXPECT_EQ(captured.use_count(), 1);
+	}
+#endif
+
+	// Work that, run on one of the executor's threads, posts more of itself from there
+	struct Fanout : Work
+	{
+		Fanout() : Work{ &Spread } {}
+
+		static void Spread(Work& work)
+		{
+			auto& self = static_cast<Fanout&>(work);
+			for(auto& child : *self.children) { self.executor->Post(child); }
+			self.ran->fetch_add(1, std::memory_order_relaxed);
+		}
+
+		static void Count(Work& work) { static_cast<Fanout&>(work).ran->fetch_add(1, std::memory_order_relaxed); }
+
+		Executor* executor = nullptr;
+		std::vector<Fanout>* children = nullptr;
+		std::atomic<int>* ran = nullptr;
+	};
+
+	TEST(AsyncTests, WorkPostedFromExecutorThreadsIsShared)
+	{
+		std::atomic<int> ran{0};
+		std::vector<Fanout> children(5000);
+		Fanout root;
+		{
+			WorkStealingExecutor executor(4);
+			for(auto& child : children)
+			{
+				child.run = &Fanout::Count;
+				child.ran = &ran;
+			}
+			root.executor = &executor;
+			root.children = &children;
+			root.ran = &ran;
+			executor.Post(root);
+		}
+
+		EXPECT_EQ(ran.load(), 5001);
+	}
+}
@@ -0,0 +1,104 @@
+#include "pch.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "../lib/AtomicOption.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	// Wide enough to go through the buffers, and any torn copy would leave its lanes unequal
+	struct Lanes
+	{
+		long lane[8];
+	};
+
+	// Hands 1 to count from one thread to another, checking every value arrives whole and in order, and is either taken or
+	// comes back displaced exactly once
+	template <typename T, typename Make, typename Read>
+	void HandOverInOrder(const long count, Make make, Read read)
+	{
+		AtomicOption<T> slot;
+		long displacedSum = 0;
+		std::thread producer([&]
+		{
+			for(long i = 1; i <= count; i++)
+			{
+				const auto displaced = slot.Exchange(make(i));
+				if(!displaced.IsNone()) { displacedSum += read(displaced.ThrowIfNone()); }
+			}
+		});
+
+		long last = 0;
+		long takenSum = 0;
+		bool inOrder = true;
+		while(last != count)
+		{
+			auto taken = slot.TryTake();
+			if(taken.IsNone()) { std::this_thread::yield(); continue; }
+
+			const auto value = read(taken.ThrowIfNone());
+			inOrder = inOrder && value > last;
+			last = value;
+			takenSum += value;
+		}
+		producer.join();
+
+		EXPECT_TRUE(inOrder);
+		EXPECT_EQ(takenSum + displacedSum, count * (count + 1) / 2);
+		EXPECT_FALSE(slot.HasValue());
+	}
+
+	TEST(AtomicOptionTests, PacksSmallValuesIntoOneWord)
+	{
+		static_assert(AtomicOption<int>::IsLockFree && sizeof(AtomicOption<int>) == sizeof(std::uint64_t));
+		static_assert(sizeof(AtomicOption<int*>) == sizeof(std::uint64_t));
+
+		AtomicOption<int> slot;
+		EXPECT_EQ(slot.TryTake(), None());
+
+		slot.Publish(0);
+		EXPECT_TRUE(slot.HasValue());
+		EXPECT_EQ(slot.Exchange(6), Option<int>(0));
+		EXPECT_EQ(slot.TryTake(), Option<int>(6));
+		EXPECT_EQ(slot.TryTake(), None());
+
+		int target = 1;
+		AtomicOption<int*> pointers;
+		EXPECT_EQ(pointers.Exchange(&target), None());
+		EXPECT_EQ(pointers.TryTake(), Option<int*>(&target));
+		EXPECT_FALSE(pointers.HasValue());
+	}
+
+	TEST(AtomicOptionTests, HandsOverLargerValuesThroughBuffers)
+	{
+		static_assert(AtomicOption<std::string>::IsLockFree);
+
+		AtomicOption<std::string> slot;
+		EXPECT_EQ(slot.TryTake(), None());
+		EXPECT_EQ(slot.Exchange("first"), None());
+		EXPECT_EQ(slot.Exchange("second"), Option<std::string>("first"));
+		EXPECT_EQ(slot.TryTake(), Option<std::string>("second"));
+		EXPECT_EQ(slot.TryTake(), None());
+
+		AtomicOption<std::unique_ptr<int>> pointers;
+		pointers.Publish(std::make_unique<int>(3));
+		EXPECT_EQ(*pointers.TryTake().ThrowIfNone(), 3);
+		EXPECT_FALSE(pointers.HasValue());
+	}
+
+	TEST(AtomicOptionTests, HandsOverBetweenThreads)
+	{
+		HandOverInOrder<int>(200000, [](const long i) { return static_cast<int>(i); }, [](const int i) { return static_cast<long>(i); });
+		HandOverInOrder<long>(200000, [](const long i) { return i; }, [](const long i) { return i; });
+		HandOverInOrder<Lanes>(200000,
+			[](const long i) { Lanes lanes{}; for(auto& lane : lanes.lane) { lane = i; } return lanes; },
+			[](const Lanes& lanes)
+			{
+				for(const auto lane : lanes.lane) { if(lane != lanes.lane[0]) { return -1L; } }
+				return lanes.lane[0];
+			});
+	}
+}
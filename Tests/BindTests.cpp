@@ -2,7 +2,7 @@
 
 #include <string>
 
-#include "..\lib\Either.h"
+#include "../lib/Either.h"
 using namespace libmonad;
 
 namespace Tests
@@ -54,4 +54,20 @@ namespace Tests
 
 		EXPECT_TRUE(result.IsLeft());
 	}
-}
\ No newline at end of file
+
+	TEST(EitherTests, BindDeducesType)
+	{
+		Either<int, std::string> result = std::string("42");
+
+		auto parsed = result.Bind([](const std::string& s)
+		{
+			return s.empty() ? Either<int, long>(-1) : Either<int, long>(std::stol(s));
+		}).Bind([](const long l)
+		{
+			return l > 100 ? Either<int, char>(1) : Either<int, char>('y');
+		});
+
+		static_assert(std::is_same_v<decltype(parsed), Either<int, char>>);
+		EXPECT_EQ(parsed.WhenLeft([](int) { return 'n'; }), 'y');
+	}
+}
@@ -0,0 +1,90 @@
+#include "pch.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "../lib/BulkMap.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	// Every level this CPU can run
+	std::vector<SimdLevel> SupportedLevels()
+	{
+		std::vector<SimdLevel> levels;
+		for(const auto level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512 })
+		{
+			if(level <= CurrentSimdLevel()) { levels.push_back(level); }
+		}
+		return levels;
+	}
+
+	// Makes a column of count values in which every element whose index is a multiple of noneEvery is none
+	template <typename T>
+	OptionColumn<T> MakeColumn(const std::size_t count, const std::size_t noneEvery)
+	{
+		OptionColumn<T> column;
+		for(std::size_t i = 0; i < count; i++)
+		{
+			if(i % noneEvery == 0) { column.PushNone(); } else { column.PushSome(static_cast<T>(i)); }
+		}
+		return column;
+	}
+
+	TEST(BulkMapTests, MatchesMapAtEveryLevel)
+	{
+		// Long runs of full words, mixed words and a partial last word
+		auto column = MakeColumn<float>(10000, 1000);
+		auto transform = [](const float f) { return f * 2.0f + 1.0f; };
+
+		for(const auto level : SupportedLevels())
+		{
+			EXPECT_EQ(BulkMap(column, transform, level), column.Map(transform)) << static_cast<int>(level);
+		}
+	}
+
+	TEST(BulkMapTests, RvalueColumnMapsInPlace)
+	{
+		const auto column = MakeColumn<double>(3000, 64);
+		auto transform = [](const double d) { return d * -1.0 + 1.0; };
+
+		for(const auto level : SupportedLevels())
+		{
+			EXPECT_EQ(BulkMap(OptionColumn<double>(column), transform, level), column.Map(transform)) << static_cast<int>(level);
+		}
+	}
+
+	TEST(BulkMapTests, ConvertsBetweenArithmeticTypes)
+	{
+		const auto column = MakeColumn<std::int32_t>(1000, 7);
+
+		for(const auto level : SupportedLevels())
+		{
+			const auto halves = BulkMap(column, [](const std::int32_t i) { return i / 2.0; }, level);
+
+			EXPECT_EQ(halves.At(7), Option<double>());
+			EXPECT_EQ(halves.At(9), Option<double>(4.5));
+			EXPECT_EQ(halves.SomeCount(), column.SomeCount());
+		}
+	}
+
+	TEST(BulkMapTests, NeverCallsTransformForNone)
+	{
+		// A none slot holds zero, which this transformation would divide by
+		const auto column = MakeColumn<std::int32_t>(4096, 3);
+
+		for(const auto level : SupportedLevels())
+		{
+			const auto result = BulkMap(column, [](const std::int32_t i) { return 1000000 / i; }, level);
+
+			EXPECT_EQ(result.At(1), Option<std::int32_t>(1000000));
+			EXPECT_EQ(result.At(3), Option<std::int32_t>());
+		}
+	}
+
+	TEST(BulkMapTests, EmptyAndAllNoneColumns)
+	{
+		EXPECT_EQ(BulkMap(OptionColumn<double>(), [](const double d) { return d; }).Size(), 0);
+		EXPECT_EQ(BulkMap(MakeColumn<double>(500, 1), [](const double d) { return d; }).SomeCount(), 0);
+	}
+}
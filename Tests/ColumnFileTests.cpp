@@ -0,0 +1,181 @@
+#include "pch.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "../lib/ColumnFile.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	// A file in the temporary directory, removed when the test ends
+	struct TemporaryFile
+	{
+		explicit TemporaryFile(const std::string& name) : path(std::filesystem::temp_directory_path() / ("libmonad_" + name)) {}
+		~TemporaryFile() { std::filesystem::remove(path); }
+		std::filesystem::path path;
+	};
+
+	// Every element whose index is a multiple of leftEvery is a left value of minus its index
+	EitherColumn<int, long> MakeEitherColumn(const long count, const long leftEvery)
+	{
+		EitherColumn<int, long> column;
+		for(long i = 0; i < count; i++)
+		{
+			if(i % leftEvery == 0) { column.PushLeft(static_cast<int>(-i)); } else { column.PushRight(i); }
+		}
+		return column;
+	}
+
+	// The left value an either holds, or a default value if it is right
+	template <typename L, typename R, typename T = std::remove_cvref_t<L>>
+	T LeftOf(const Either<L, R>& either) { return either.Match([](const L& left) { return T(left); }, [](const R&) { return T(); }); }
+
+	// Writes words over a file at an offset, leaving the rest as it is
+	void Overwrite(const std::filesystem::path& path, const std::uint64_t offset, const std::vector<std::uint64_t>& words)
+	{
+		std::fstream stream(path, std::ios::binary | std::ios::in | std::ios::out);
+		stream.seekp(static_cast<std::streamoff>(offset));
+		stream.write(reinterpret_cast<const char*>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(std::uint64_t)));
+	}
+
+	ColumnFileHeader ReadHeader(const std::filesystem::path& path)
+	{
+		ColumnFileHeader header{};
+		std::ifstream(path, std::ios::binary).read(reinterpret_cast<char*>(&header), sizeof(header));
+		return header;
+	}
+
+	template <typename T>
+	Error ErrorOf(const ErrorOr<T>& result) { return result.WhenRight([](const T&) { return Error(); }); }
+
+	TEST(ColumnFileTests, EitherColumnRoundTrips)
+	{
+		const TemporaryFile file("either.col");
+		const auto column = MakeEitherColumn(1000, 7);
+		EXPECT_TRUE(WriteColumnFile(file.path, column).IsRight());
+
+		const auto view = OpenEitherColumnFile<int, long>(file.path).ThrowIfLeft();
+		EXPECT_EQ(view.Size(), 1000);
+		EXPECT_EQ(view.LeftCount(), 143);
+		EXPECT_TRUE(view.IsLeft(7));
+		EXPECT_EQ(LeftOf(view.At(7)), -7);
+		EXPECT_EQ(view.At(8).ThrowIfLeft(), 8);
+		EXPECT_EQ(view.ToColumn().ToVector(), column.ToVector());
+	}
+
+	TEST(ColumnFileTests, MatchesInPlace)
+	{
+		const TemporaryFile file("match.col");
+		EXPECT_TRUE(WriteColumnFile(file.path, MakeEitherColumn(200, 3)).IsRight());
+		const auto view = OpenEitherColumnFile<int, long>(file.path).ThrowIfLeft();
+
+		long rights = 0, lefts = 0;
+		view.Match([&](const int& left) { lefts += left; }, [&](const long& right) { rights += right; });
+		long whenRight = 0;
+		view.WhenRight([&](const long right) { whenRight += right; });
+
+		const auto mapped = view.Map([](const long right) { return right * 2; });
+		EXPECT_EQ(lefts, -6633);
+		EXPECT_EQ(rights, 13267);
+		EXPECT_EQ(whenRight, rights);
+		EXPECT_EQ(mapped.At(4), (Either<int, long>(8L)));
+		EXPECT_EQ(mapped.At(3), (Either<int, long>(-3)));
+	}
+
+	TEST(ColumnFileTests, StringsAreReadAsViews)
+	{
+		const TemporaryFile file("strings.col");
+		EitherColumn<std::string, long> column;
+		column.PushRight(1);
+		column.PushLeft("missing");
+		column.PushLeft("");
+		column.PushLeft(std::string(1000, 'x'));
+		EXPECT_TRUE(WriteColumnFile(file.path, column).IsRight());
+
+		const auto view = OpenEitherColumnFile<std::string, long>(file.path).ThrowIfLeft();
+		EXPECT_EQ(view.At(0).ThrowIfLeft(), 1);
+		EXPECT_EQ(LeftOf(view.At(1)), "missing");
+		EXPECT_EQ(LeftOf(view.At(2)), "");
+		EXPECT_EQ(LeftOf(view.At(3)).size(), 1000);
+		EXPECT_EQ(view.ToColumn().ToVector(), column.ToVector());
+	}
+
+	TEST(ColumnFileTests, OptionColumnRoundTrips)
+	{
+		const TemporaryFile file("option.col");
+		OptionColumn<std::string> names;
+		OptionColumn<double> values;
+		for(auto i = 0; i < 150; i++)
+		{
+			if(i % 5 == 0) { names.PushNone(); values.PushNone(); }
+			else { names.PushSome("name" + std::to_string(i)); values.PushSome(i * 0.5); }
+		}
+
+		EXPECT_TRUE(WriteColumnFile(file.path, names).IsRight());
+		const auto nameView = OpenOptionColumnFile<std::string>(file.path).ThrowIfLeft();
+		EXPECT_EQ(nameView.SomeCount(), 120);
+		EXPECT_EQ(nameView.At(0), None());
+		EXPECT_EQ(nameView.At(12).ThrowIfNone(), "name12");
+		EXPECT_EQ(nameView.Map([](const std::string_view name) { return name.size(); }).At(12), Option<std::size_t>(6));
+
+		EXPECT_TRUE(WriteColumnFile(file.path, values).IsRight());
+		const auto valueView = OpenOptionColumnFile<double>(file.path).ThrowIfLeft();
+		double sum = 0;
+		valueView.WhenSome([&](const double value) { sum += value; });
+		EXPECT_EQ(sum, 4500);
+		EXPECT_EQ(valueView.ToColumn().Values(), values.Values());
+	}
+
+	TEST(ColumnFileTests, EmptyColumnRoundTrips)
+	{
+		const TemporaryFile file("empty.col");
+		EXPECT_TRUE(WriteColumnFile(file.path, EitherColumn<int, long>()).IsRight());
+
+		const auto view = OpenEitherColumnFile<int, long>(file.path).ThrowIfLeft();
+		EXPECT_EQ(view.Size(), 0);
+		EXPECT_TRUE(view.ToColumn().ToVector().empty());
+	}
+
+	TEST(ColumnFileTests, RejectsWrongMissingAndCorruptFiles)
+	{
+		const TemporaryFile file("corrupt.col");
+		EXPECT_EQ(ErrorOf(OpenEitherColumnFile<int, long>(file.path)).Code(), CannotOpenColumnFile);
+
+		EXPECT_TRUE(WriteColumnFile(file.path, MakeEitherColumn(100, 2)).IsRight());
+		EXPECT_EQ(ErrorOf(OpenEitherColumnFile<int, short>(file.path)).Code(), BadColumnFile);
+		EXPECT_EQ(ErrorOf(OpenOptionColumnFile<long>(file.path)).Code(), BadColumnFile);
+
+		std::filesystem::resize_file(file.path, std::filesystem::file_size(file.path) - 8);
+		EXPECT_EQ(ErrorOf(OpenEitherColumnFile<int, long>(file.path)), Error(BadColumnFile, "lefts"));
+
+		std::ofstream(file.path, std::ios::binary) << "not a column file";
+		EXPECT_EQ(ErrorOf(OpenEitherColumnFile<int, long>(file.path)), Error(BadColumnFile, "header"));
+
+		// As many bits set as there are rights, but 58 of them past the last element, where no values are
+		EitherColumn<int, long> rights;
+		for(long i = 0; i < 70; i++) { rights.PushRight(i); }
+		EXPECT_TRUE(WriteColumnFile(file.path, rights).IsRight());
+		Overwrite(file.path, ReadHeader(file.path).bits.offset, { 0x3F, ~std::uint64_t(0) });
+		EXPECT_EQ(ErrorOf(OpenEitherColumnFile<int, long>(file.path)), Error(BadColumnFile, "bits"));
+
+		OptionColumn<long> some;
+		for(long i = 0; i < 70; i++) { some.PushSome(i); }
+		EXPECT_TRUE(WriteColumnFile(file.path, some).IsRight());
+		Overwrite(file.path, ReadHeader(file.path).bits.offset, { 0x3F, ~std::uint64_t(0) });
+		EXPECT_EQ(ErrorOf(OpenOptionColumnFile<long>(file.path)), Error(BadColumnFile, "bits"));
+
+		// Lefts at every even index, given indices out of order, past the end, and of a right element
+		for(const auto& indices : std::vector<std::vector<std::uint64_t>>{ { 2, 0 }, { 0, 200 }, { 0, 1 } })
+		{
+			EXPECT_TRUE(WriteColumnFile(file.path, MakeEitherColumn(100, 2)).IsRight());
+			Overwrite(file.path, ReadHeader(file.path).leftIndices.offset, indices);
+			EXPECT_EQ(ErrorOf(OpenEitherColumnFile<int, long>(file.path)), Error(BadColumnFile, "left index"));
+		}
+	}
+}
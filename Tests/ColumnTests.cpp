@@ -0,0 +1,176 @@
+#include "pch.h"
+
+#include <string>
+#include <vector>
+
+#include "../lib/EitherColumn.h"
+#include "../lib/OptionColumn.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	using Result = Either<int, long>;
+
+	// Makes count eithers in which every element whose index is a multiple of leftEvery is a left value of minus its index
+	std::vector<Result> MakeEithers(const long count, const long leftEvery)
+	{
+		std::vector<Result> eithers;
+		for(long i = 0; i < count; i++)
+		{
+			eithers.push_back(i % leftEvery == 0 ? Result(static_cast<int>(-i)) : Result(i));
+		}
+		return eithers;
+	}
+
+	TEST(BitmapTests, CountsAndScansWords)
+	{
+		ValidityBitmap bits(200);
+		for(const std::size_t i : { 0, 63, 64, 65, 130, 199 }) { bits.Set(i); }
+
+		std::vector<std::size_t> set;
+		bits.ForEachSet([&](const std::size_t i) { set.push_back(i); });
+
+		EXPECT_EQ(bits.Count(), 6);
+		EXPECT_EQ(set, std::vector<std::size_t>({ 0, 63, 64, 65, 130, 199 }));
+	}
+
+	TEST(BitmapTests, FullBitmapStopsAtSize)
+	{
+		const ValidityBitmap bits(70, true);
+		std::size_t set = 0, clear = 0;
+		bits.ForEach([&](std::size_t) { set++; }, [&](std::size_t) { clear++; });
+
+		EXPECT_EQ(bits.Count(), 70);
+		EXPECT_EQ(set, 70);
+		EXPECT_EQ(clear, 0);
+	}
+
+	TEST(EitherColumnTests, RoundTripsThroughVector)
+	{
+		const auto eithers = MakeEithers(1000, 7);
+		const EitherColumn<int, long> column(eithers);
+
+		EXPECT_EQ(column.Size(), 1000);
+		EXPECT_EQ(column.LeftCount(), 143);
+		EXPECT_EQ(column.RightCount(), 857);
+		EXPECT_TRUE(column.IsLeft(7));
+		EXPECT_EQ(column.At(7), Result(-7));
+		EXPECT_EQ(column.At(8), Result(8L));
+		EXPECT_EQ(column.ToVector(), eithers);
+	}
+
+	TEST(EitherColumnTests, MapMatchesEitherMap)
+	{
+		const auto eithers = MakeEithers(1000, 3);
+		const EitherColumn<int, long> column(eithers);
+
+		const auto mapped = column.Map([](const long l) { return std::to_string(l * 2); });
+
+		std::vector<Either<int, std::string>> expected;
+		for(const auto& either : eithers) { expected.push_back(either.Map([](const long l) { return std::to_string(l * 2); })); }
+
+		EXPECT_EQ(mapped.ToVector(), expected);
+	}
+
+	TEST(EitherColumnTests, BindKeepsLeftsInOrder)
+	{
+		const auto eithers = MakeEithers(1000, 5);
+		auto failIfMultipleOf3 = [](const long l) { return l % 3 == 0 ? Result(static_cast<int>(l * 100)) : Result(l + 1); };
+
+		const auto bound = EitherColumn<int, long>(eithers).Bind(failIfMultipleOf3);
+
+		std::vector<Result> expected;
+		for(const auto& either : eithers) { expected.push_back(either.Bind(failIfMultipleOf3)); }
+
+		EXPECT_EQ(bound.ToVector(), expected);
+		EXPECT_EQ(bound, (EitherColumn<int, long>(expected)));
+		EXPECT_EQ(bound.At(999), Result(99900));
+	}
+
+	TEST(EitherColumnTests, RvalueColumnTransformsInPlace)
+	{
+		const auto eithers = MakeEithers(1000, 5);
+		auto failIfMultipleOf3 = [](const long l) { return l % 3 == 0 ? Result(static_cast<int>(l * 100)) : Result(l + 1); };
+
+		const auto inPlace = EitherColumn<int, long>(eithers).Map([](const long l) { return l * 2; }).Bind(failIfMultipleOf3);
+		const EitherColumn<int, long> column(eithers);
+		const auto copied = column.Map([](const long l) { return l * 2; }).Bind(failIfMultipleOf3);
+
+		EXPECT_EQ(inPlace, copied);
+		EXPECT_EQ(column.ToVector(), eithers);
+	}
+
+	TEST(EitherColumnTests, MatchVisitsEveryElementInOrder)
+	{
+		const EitherColumn<int, long> column(MakeEithers(300, 4));
+
+		std::vector<long> visited;
+		column.Match(
+			[&](const int left) { visited.push_back(left); },
+			[&](const long right) { visited.push_back(right); });
+
+		ASSERT_EQ(visited.size(), 300);
+		for(long i = 0; i < 300; i++) { EXPECT_EQ(visited[i], i % 4 == 0 ? -i : i); }
+	}
+
+	TEST(EitherColumnTests, AllLeftColumnRunsNothing)
+	{
+		EitherColumn<int, long> column;
+		for(int i = 0; i < 500; i++) { column.PushLeft(i); }
+
+		int calls = 0;
+		const auto mapped = std::move(column).Map([&](const long l) { calls++; return l; });
+
+		EXPECT_EQ(calls, 0);
+		EXPECT_EQ(mapped.LeftCount(), 500);
+		EXPECT_EQ(mapped.At(499), Result(499));
+	}
+
+	TEST(OptionColumnTests, RoundTripsThroughVector)
+	{
+		std::vector<Option<std::string>> options;
+		for(int i = 0; i < 150; i++) { options.push_back(i % 3 == 0 ? Option<std::string>() : Option<std::string>(std::to_string(i))); }
+
+		const OptionColumn<std::string> column(options);
+
+		EXPECT_EQ(column.Size(), 150);
+		EXPECT_EQ(column.SomeCount(), 100);
+		EXPECT_TRUE(column.IsNone(3));
+		EXPECT_EQ(column.At(4), Option<std::string>("4"));
+		EXPECT_EQ(column.ToVector(), options);
+	}
+
+	TEST(OptionColumnTests, MapAndBindMatchOption)
+	{
+		std::vector<Option<int>> options;
+		for(int i = 0; i < 1000; i++) { options.push_back(i % 10 == 0 ? Option<int>() : Option<int>(i)); }
+
+		auto halveIfEven = [](const int i) { return i % 2 == 0 ? Option<int>(i / 2) : Option<int>(); };
+		const auto result = OptionColumn<int>(options)
+			.Map([](const int i) { return i * 3; })
+			.Bind(halveIfEven);
+
+		std::vector<Option<int>> expected;
+		for(const auto& option : options) { expected.push_back(option.Map([](const int i) { return i * 3; }).Bind(halveIfEven)); }
+
+		EXPECT_EQ(result.ToVector(), expected);
+		EXPECT_EQ(OptionColumn<int>(options).Bind(halveIfEven).ToVector(), OptionColumn<int>(options).Map(halveIfEven).ToVector());
+	}
+
+	TEST(OptionColumnTests, WhenSomeSkipsNones)
+	{
+		OptionColumn<int> column;
+		for(int i = 0; i < 200; i++)
+		{
+			if(i < 128) { column.PushNone(); } else { column.PushSome(i); }
+		}
+
+		long total = 0;
+		int nones = 0;
+		column.WhenSome([&](const int i) { total += i; });
+		column.Match([&](None) { nones++; }, [](int) {});
+
+		EXPECT_EQ(total, (128 + 199) * 72 / 2);
+		EXPECT_EQ(nones, 128);
+	}
+}
@@ -0,0 +1,108 @@
+#include "pch.h"
+#include "../lib/Either.h"
+#include "../lib/Option.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	// These are all evaluated by the compiler: if any of them fail, this file does not compile
+
+	enum class RouteError { EmptyPath, NotAbsolute, BadPort, Reserved };
+
+	struct Route
+	{
+		const char* path;
+		int port;
+
+		friend constexpr bool operator==(const Route&, const Route&) = default;
+	};
+
+	constexpr Either<RouteError, const char*> ValidatePath(const char* path)
+	{
+		if(path == nullptr || path[0] == '\0') { return RouteError::EmptyPath; }
+		if(path[0] != '/') { return RouteError::NotAbsolute; }
+		return path;
+	}
+
+	constexpr Either<RouteError, int> ValidatePort(const int port)
+	{
+		if(port <= 0 || port > 65535) { return RouteError::BadPort; }
+		return port;
+	}
+
+	constexpr Either<RouteError, Route> Validate(const Route& route)
+	{
+		return ValidatePath(route.path)
+			.Bind([&](const char*) { return ValidatePort(route.port); })
+			.Bind([](const int port) { return port < 1024 ? Either<RouteError, int>(RouteError::Reserved) : Either<RouteError, int>(port); })
+			.Map([&](int) { return route; });
+	}
+
+	constexpr Route routes[] = {
+		{ "/users", 8080 },
+		{ "/orders", 8081 },
+		{ "/health", 9000 }
+	};
+
+	constexpr int CountValid(const Route* begin, const Route* end)
+	{
+		auto valid = 0;
+		for(auto route = begin; route != end; ++route)
+		{
+			valid += Validate(*route).Match([](RouteError) { return 0; }, [](const Route&) { return 1; });
+		}
+		return valid;
+	}
+
+	static_assert(CountValid(std::begin(routes), std::end(routes)) == 3);
+
+	static_assert(Validate({ "", 8080 }) == Either<RouteError, Route>(RouteError::EmptyPath));
+	static_assert(Validate({ "users", 8080 }).WhenRight([](const Route&) { return RouteError::BadPort; }) == RouteError::NotAbsolute);
+	static_assert(Validate({ "/users", 80 }).IsLeft());
+	static_assert(Validate({ "/users", 70000 }).When([](RouteError e) { return e == RouteError::BadPort; }, [](const Route&) { return false; }));
+	static_assert(Validate({ "/users", 8080 }).WhenLeft([](RouteError) { return Route{ "", 0 }; }).port == 8080);
+
+	// Copying, assigning and switching which value is held all work at compile time
+	static_assert([]
+	{
+		Either<int, double> either;
+		if(!either.IsBottom()) { return false; }
+
+		either = 1;
+		auto copy = either;
+		either = 2.5;
+		copy = either;
+
+		return copy.IsRight() && copy == Either<int, double>(2.5) && copy != Either<int, double>(1);
+	}());
+
+	// Options, including ones using a sentinel, work at compile time too
+	constexpr Option<int> Half(const int i)
+	{
+		if(i % 2 != 0) { return None(); }
+		return i / 2;
+	}
+
+	consteval int HalveThrice(const int i)
+	{
+		return Half(i).Bind(Half).Bind(Half).Map([](const int h) { return h + 1; }).MatchTo([] { return -1; }, [](const int h) { return h; });
+	}
+
+	static_assert(HalveThrice(40) == 6);
+	static_assert(HalveThrice(20) == -1);
+	static_assert(Half(7) == None());
+	static_assert(Half(8) == Option<int>(4));
+	static_assert(Half(8) != Option<int>(3));
+
+	constexpr const char* greeting = "hello";
+	static_assert(Option<const char*>(greeting).Map([](const char* s) { return s[0]; }).WhenNone([] { return '?'; }) == 'h');
+	static_assert(Option<const char*>(nullptr).IsNone());
+
+	TEST(ConstexprTests, SameResultsAtRunTime)
+	{
+		EXPECT_EQ(CountValid(std::begin(routes), std::end(routes)), 3);
+		EXPECT_TRUE(Validate({ "/users", 80 }).IsLeft());
+		EXPECT_TRUE(Half(7) == None());
+		EXPECT_EQ(Half(40).Bind(Half).Bind(Half).WhenNone([] { return -1; }), 5);
+	}
+}
@@ -1,9 +1,35 @@
 #include "pch.h"
-#include "..\lib\Either.h"
+#include "../lib/Either.h"
+
+#include <string>
+#include <vector>
 using namespace libmonad;
 
 namespace Tests
 {
+	// The either only holds one of its values at a time, so it is the size of the largest plus a tag byte (and padding)
+	static_assert(sizeof(Either<int, float>) == sizeof(int) + alignof(int));
+	static_assert(sizeof(Either<char, short>) == sizeof(short) + alignof(short));
+	static_assert(sizeof(Either<char, double>) == sizeof(double) + alignof(double));
+	static_assert(sizeof(Either<std::string, std::vector<int>>) == sizeof(std::string) + alignof(std::string));
+
+	/**
+	 * \brief Counts how many of itself are alive, and has no default constructor
+	 */
+	struct Tracked
+	{
+		static int alive;
+		int value;
+
+		explicit Tracked(const int value) : value(value) { alive++; }
+		Tracked(const Tracked& other) : value(other.value) { alive++; }
+		Tracked(Tracked&& other) noexcept : value(other.value) { alive++; }
+		Tracked& operator=(const Tracked&) = default;
+		Tracked& operator=(Tracked&&) = default;
+		~Tracked() { alive--; }
+	};
+
+	int Tracked::alive = 0;
 
 	TEST(EitherTests, Match)
 	{
@@ -49,7 +75,7 @@ namespace Tests
 		constexpr auto errorMessage = "35";
 
 		// assign a right type value
-		Either<int, std::string> errorOrMessage = errorMessage;
+		Either<int, std::string> errorOrMessage = std::string(errorMessage);
 
 		// What to return if its actually a string, i.e a right type
 		const std::string result = errorOrMessage.When(
@@ -92,7 +118,7 @@ namespace Tests
 		constexpr auto errorMessage = "35";
 
 		// assign a right type value
-		Either<int, std::string> errorOrMessage = errorMessage;
+		Either<int, std::string> errorOrMessage = std::string(errorMessage);
 
 		// What to return if its actually a int, i.e a left type
 		const std::string result = errorOrMessage.WhenLeft(
@@ -132,13 +158,81 @@ namespace Tests
 
 		number = 12.0f;
 
-		EXPECT_NO_THROW(number.ThrowIfLeft());
+		EXPECT_NO_MONAD_ERROR(number.ThrowIfLeft());
 		EXPECT_TRUE(number.IsRight());
 		EXPECT_FALSE(number.IsLeft());
 
 		number = 12;
 
-		EXPECT_THROW(number.ThrowIfLeft(), std::exception);
+		EXPECT_MONAD_ERROR(number.ThrowIfLeft(), "ThrowIfLeft");
+
+	}
+
+	TEST(EitherTests, UseBottom)
+	{
+		Either<int, float> bottom;
+
+		EXPECT_MONAD_ERROR(bottom.Map([](const float f) { return f * 2; }), "not initialized");
+		EXPECT_MONAD_ERROR(bottom.WhenLeft([](int) { return 0.0f; }), "not initialized");
+	}
+
+#if LIBMONAD_ERROR_POLICY == LIBMONAD_ERROR_POLICY_HANDLER
+	TEST(EitherTests, ErrorHandler)
+	{
+		SetErrorHandler([](const char* message) { std::fprintf(stderr, "Handled: %s\n", message); });
+
+		Either<int, float> number = 12;
+		EXPECT_DEATH(number.ThrowIfLeft(), "Handled: ThrowIfLeft");
+
+		SetErrorHandler(nullptr);
+	}
+#endif
+
+	TEST(EitherTests, OnlyHeldValueIsConstructed)
+	{
+		{
+			// Neither value type needs to be default constructible
+			Either<Tracked, std::string> either;
+			EXPECT_EQ(Tracked::alive, 0);
+
+			either = Tracked(1);
+			EXPECT_EQ(Tracked::alive, 1);
+
+			either = std::string("right");
+			EXPECT_EQ(Tracked::alive, 0);
+			EXPECT_TRUE(either.IsRight());
+
+			either = Tracked(2);
+			Either<Tracked, std::string> copy = either;
+			EXPECT_EQ(Tracked::alive, 2);
+
+			Either<Tracked, std::string> moved = std::move(copy);
+			EXPECT_EQ(Tracked::alive, 3);
+			EXPECT_EQ(moved.WhenRight([](const std::string&) { return Tracked(0); }).value, 2);
+		}
+
+		// Everything that was constructed was destroyed
+		EXPECT_EQ(Tracked::alive, 0);
+	}
+
+	TEST(EitherTests, CopyAndMoveKeepState)
+	{
+		Either<std::string, std::vector<int>> either = std::vector<int>{1, 2, 3};
+
+		auto copy = either;
+		EXPECT_TRUE(copy.IsRight());
+		EXPECT_EQ(copy.WhenLeft([](const std::string&) { return std::vector<int>(); }).size(), 3);
+
+		either = std::string("error");
+		copy = either;
+		EXPECT_TRUE(copy.IsLeft());
+
+		auto moved = std::move(copy);
+		EXPECT_TRUE(moved.IsLeft());
+		EXPECT_EQ(moved.WhenRight([](const std::vector<int>&) { return std::string(); }), "error");
 
+		Either<std::string, std::vector<int>> bottom;
+		moved = bottom;
+		EXPECT_TRUE(moved.IsBottom());
 	}
 }
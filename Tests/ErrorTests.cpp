@@ -0,0 +1,77 @@
+#include "pch.h"
+
+#include <sstream>
+#include <string>
+
+#include "../lib/Error.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	const ErrorCode NotFound = RegisterError("not found");
+	const ErrorCode BadRecord = RegisterError("bad record");
+
+	ErrorOr<long> Find(const long key)
+	{
+		if(key < 0) { return Error(NotFound, "key " + std::to_string(key)); }
+		if(key > 100) { return Error(BadRecord, static_cast<std::int64_t>(key)); }
+		return key * 2;
+	}
+
+	TEST(ErrorTests, IsSmallAndTriviallyCopyable)
+	{
+		EXPECT_LE(sizeof(Error), 16u);
+		EXPECT_TRUE(std::is_trivially_copyable_v<Error>);
+	}
+
+	TEST(ErrorTests, SameMessageGivesSameCode)
+	{
+		EXPECT_EQ(RegisterError("not found"), NotFound);
+		EXPECT_FALSE(NotFound == BadRecord);
+	}
+
+	TEST(ErrorTests, FormatsMessageWithContext)
+	{
+		EXPECT_EQ(Error(NotFound).Message(), "not found");
+		EXPECT_EQ(Error(NotFound, "config").Message(), "not found: config");
+		EXPECT_EQ(Error(BadRecord, std::int64_t(-42)).Message(), "bad record (-42)");
+		EXPECT_EQ(Error(ErrorCode{ 999999 }).Message(), "error 999999");
+
+		std::ostringstream stream;
+		stream << Error(NotFound, "x");
+		EXPECT_EQ(stream.str(), "not found: x");
+	}
+
+	TEST(ErrorTests, CutsLongTextShort)
+	{
+		const Error error(NotFound, "a rather long file name.txt");
+
+		EXPECT_EQ(error.Text(), Option<std::string_view>("a rather lo"));
+		EXPECT_EQ(error.Integer(), None());
+	}
+
+	TEST(ErrorTests, ComparesCodeAndContext)
+	{
+		EXPECT_EQ(Error(NotFound, "a"), Error(NotFound, "a"));
+		EXPECT_FALSE(Error(NotFound, "a") == Error(NotFound, "b"));
+		EXPECT_FALSE(Error(NotFound, std::int64_t(1)) == Error(BadRecord, std::int64_t(1)));
+		EXPECT_EQ(Error(NotFound), Error(NotFound, ""));
+	}
+
+	TEST(ErrorTests, PassesThroughMapAndBind)
+	{
+		const auto found = Find(4).Map([](const long l) { return l + 1; }).Bind(Find);
+		const auto missing = Find(-3).Map([](const long l) { return l + 1; }).Bind(Find);
+		const auto bad = Find(60).Bind(Find);
+
+		EXPECT_EQ(found, ErrorOr<long>(18L));
+		EXPECT_EQ(missing, ErrorOr<long>(Error(NotFound, "key -3")));
+		EXPECT_EQ(bad.WhenRight([](long) { return Error(); }).Message(), "bad record (120)");
+	}
+
+	TEST(ErrorTests, OrErrorReplacesNone)
+	{
+		EXPECT_EQ(OrError(Option<int>(3), Error(NotFound)), ErrorOr<int>(3));
+		EXPECT_EQ(OrError(Option<int>(), Error(NotFound)), ErrorOr<int>(Error(NotFound)));
+	}
+}
@@ -0,0 +1,185 @@
+#include "pch.h"
+
+#include <string>
+
+// These tests are built into their own executable with LIBMONAD_INSTRUMENT=1, which also counts its heap allocations
+#define LIBMONAD_INSTRUMENT_ALLOCATIONS
+#include "../lib/Instrument.h"
+#include "../lib/Either.h"
+#include "../lib/Option.h"
+#include "../lib/Validated.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	using Result = Either<int, long>;
+	using Named = Either<std::string, long>;
+
+	const std::string LongMessage = "a message too long to fit in a string without allocating";
+
+	Result Halve(const long l) { return l % 2 == 0 ? Result(l / 2) : Result(-1); }
+
+	TEST(InstrumentTests, CountsCopiesAndMovesOfEachInstantiation)
+	{
+		const auto before = CountsOf<Named>();
+		const auto others = CountsOf<Result>();
+		{
+			Named named = 5L;
+			auto copy = named;
+			auto moved = std::move(named);
+			copy = moved;
+			moved = std::move(copy);
+		}
+		const auto counted = CountsOf<Named>() - before;
+
+		EXPECT_EQ(counted.constructions, 1u);
+		EXPECT_EQ(counted.copies, 2u);
+		EXPECT_EQ(counted.moves, 2u);
+		EXPECT_EQ(counted.destructions, 3u);
+		EXPECT_EQ(CountsOf<Result>() - others, Counts{});
+	}
+
+	TEST(InstrumentTests, CountsCopiesAndMovesOfOptions)
+	{
+		const auto before = CountsOf<Option<std::string>>();
+		{
+			Option<std::string> option = LongMessage;
+			auto copy = option;
+			auto moved = std::move(option);
+		}
+		const auto counted = CountsOf<Option<std::string>>() - before;
+
+		EXPECT_EQ(counted.constructions, 1u);
+		EXPECT_EQ(counted.copies, 1u);
+		EXPECT_EQ(counted.moves, 1u);
+		EXPECT_EQ(counted.destructions, 3u);
+	}
+
+	TEST(InstrumentTests, CountsCallsOfEachCombinator)
+	{
+		const auto maps = CountsOf("Either::Map");
+		const auto binds = CountsOf("Either::Bind");
+
+		const auto result = Result(12L).Map([](const long l) { return l + 2; }).Bind(Halve).Bind(Halve);
+		const auto left = Result(-2).Map([](const long l) { return l + 2; }).Bind(Halve);
+
+		EXPECT_EQ(result, Result(-1));
+		EXPECT_TRUE(left.IsLeft());
+		EXPECT_EQ((CountsOf("Either::Map") - maps).calls, 2u);
+		EXPECT_EQ((CountsOf("Either::Bind") - binds).calls, 3u);
+	}
+
+	TEST(InstrumentTests, LambdaPipelinesDoNotAllocate)
+	{
+		EXPECT_NO_ALLOCATIONS(
+			const auto result = Result(40L)
+				.Map([](const long l) { return l * 2; })
+				.Bind(Halve)
+				.Bind(Halve)
+				.Match([](int) { return 0L; }, [](const long l) { return l; });
+			EXPECT_EQ(result, 20));
+
+		EXPECT_NO_ALLOCATIONS(
+			const auto option = Option<long>(3L)
+				.Map([](const long l) { return l + 1; })
+				.Bind([](const long l) { return l > 10 ? Option<long>(l) : Option<long>(); });
+			EXPECT_TRUE(option.IsNone()));
+	}
+
+	TEST(InstrumentTests, ValidatedAllocatesOnlyPastInlineErrors)
+	{
+		using Checked = Validated<int, long>;
+		const auto check = [](const long l) { return l < 0 ? Checked(static_cast<int>(l)) : Checked(l); };
+		const auto sum = [](const long a, const long b, const long c, const long d, const long e) { return a + b + c + d + e; };
+
+		EXPECT_NO_ALLOCATIONS(
+			const auto valid = Combine(sum, check(1), check(2), check(3), check(4), check(5));
+			EXPECT_EQ(valid.ThrowIfInvalid(), 15));
+
+		EXPECT_NO_ALLOCATIONS(
+			const auto twoErrors = Combine(sum, check(1), check(-2), check(3), check(-4), check(5));
+			EXPECT_EQ(twoErrors.Errors().Size(), 2u));
+
+		const auto fiveErrors = AllocationsDuring([&]
+		{
+			const auto invalid = Combine(sum, check(-1), check(-2), check(-3), check(-4), check(-5));
+			EXPECT_EQ(invalid.Errors().Size(), 5u);
+		});
+		EXPECT_GT(fiveErrors, 0u);
+	}
+
+	TEST(InstrumentTests, StdFunctionOverloadSpillsLargeCaptures)
+	{
+		const long a = 1, b = 2, c = 3;
+		const auto lambdaAllocations = AllocationsDuring([&]
+		{
+			const auto result = Result(4L).Map([a, b, c](const long l) { return l + a + b + c; });
+			EXPECT_EQ(result, Result(10L));
+		});
+		const auto functionAllocations = AllocationsDuring([&]
+		{
+			const auto result = Result(4L).Map<long>([a, b, c](const long l) { return Result(l + a + b + c); });
+			EXPECT_EQ(result, Result(10L));
+		});
+
+		EXPECT_EQ(lambdaAllocations, 0u);
+		EXPECT_GT(functionAllocations, 0u);
+	}
+
+	TEST(InstrumentTests, CopyingLeftInMapAllocatesButMovingDoesNot)
+	{
+		const Named failed = LongMessage;
+		const auto copying = CountsOf("Either::Map");
+		const auto copied = failed.Map([](const long l) { return l + 1; });
+		const auto copyingCounts = CountsOf("Either::Map") - copying;
+
+		Named moving = LongMessage;
+		const auto before = CountsOf("Either::Map");
+		const auto moved = std::move(moving).Map([](const long l) { return l + 1; });
+		const auto movingCounts = CountsOf("Either::Map") - before;
+
+		EXPECT_EQ(copied, moved);
+		EXPECT_EQ(copyingCounts.allocations, 1u);
+		EXPECT_EQ(movingCounts.allocations, 0u);
+	}
+
+	TEST(InstrumentTests, NestedCombinatorsCountTowardsEnclosingCall)
+	{
+		const auto maps = CountsOf("Either::Map");
+		const auto binds = CountsOf("Either::Bind");
+
+		const auto result = Named(8L).Map([](const long l) { return Named(std::to_string(l) + LongMessage); });
+
+		EXPECT_TRUE(result.IsLeft());
+		EXPECT_GE((CountsOf("Either::Map") - maps).allocations, 1u);
+		EXPECT_EQ((CountsOf("Either::Bind") - binds).allocations, 0u);
+	}
+
+	TEST(InstrumentTests, ToEitherRoundTripMovesValue)
+	{
+		Option<std::string> option = LongMessage;
+		const auto toEither = CountsOf("Option::ToEither");
+		const auto toOption = CountsOf("Option::ToOption");
+
+		const auto either = option.ToEither(std::move(option));
+		const auto back = option.ToOption(either);
+
+		const auto eitherCounts = CountsOf("Option::ToEither") - toEither;
+		const auto optionCounts = CountsOf("Option::ToOption") - toOption;
+		EXPECT_EQ(back, Option<std::string>(LongMessage));
+		EXPECT_EQ(eitherCounts.calls, 1u);
+		EXPECT_EQ(eitherCounts.allocations, 0u);
+		EXPECT_EQ(optionCounts.allocations, 0u);
+	}
+
+	TEST(InstrumentTests, RegistryListsEverythingCounted)
+	{
+		Result(1L).Map([](const long l) { return l; });
+
+		const auto all = InstrumentRegistry::Instance().ReadAll();
+
+		EXPECT_TRUE(all.contains("Either::Map"));
+		EXPECT_GE(all.at("Either::Map").calls, 1u);
+		EXPECT_EQ(CountsOf("Either::NoSuchCombinator"), Counts{});
+	}
+}
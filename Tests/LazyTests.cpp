@@ -0,0 +1,93 @@
+#include "pch.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../lib/Lazy.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	TEST(LazyTests, WorksValueOutOnceWhenFirstForced)
+	{
+		int evaluations = 0;
+		const auto answer = Defer([&] { evaluations++; return 21; });
+		const auto doubled = answer.Map([](const int i) { return i * 2; });
+		const auto described = doubled.Bind([](const int i) { return Defer([i] { return std::to_string(i); }); });
+		EXPECT_EQ(evaluations, 0);
+		EXPECT_FALSE(described.IsForced());
+
+		EXPECT_EQ(described.Force(), "42");
+		EXPECT_EQ(evaluations, 1);
+		EXPECT_TRUE(answer.IsForced());
+
+		const auto copy = answer;
+		EXPECT_EQ(copy.Force(), 21);
+		EXPECT_EQ(&copy.Force(), &answer.Force());
+		EXPECT_EQ(evaluations, 1);
+	}
+
+	TEST(LazyTests, KeepsLeftValues)
+	{
+		int lookups = 0;
+		const auto lookup = Defer([&] { lookups++; return Either<std::string, int>("no such schema"); });
+		const auto mapped = lookup.Map([](const int i) { return i + 1; });
+
+		EXPECT_EQ(mapped.Force(), (Either<std::string, int>("no such schema")));
+		EXPECT_EQ(lookup.Force(), (Either<std::string, int>("no such schema")));
+		EXPECT_EQ(lookups, 1);
+
+		const auto found = Defer([] { return Option<int>(3); }).Bind([](const int i) { return i > 2 ? Option<int>(i) : None(); });
+		EXPECT_EQ(found.Force(), Option<int>(3));
+	}
+
+	TEST(LazyTests, WorksValueOutOnceAcrossThreads)
+	{
+		std::atomic<int> evaluations = 0;
+		std::atomic<bool> go = false;
+		const auto config = Defer([&]
+		{
+			evaluations++;
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			return std::vector<int>{ 1, 2, 3 };
+		});
+
+		std::vector<const std::vector<int>*> seen(16);
+		std::vector<std::thread> threads;
+		for(std::size_t i = 0; i < seen.size(); i++)
+		{
+			threads.emplace_back([&, i]
+			{
+				while(!go) { std::this_thread::yield(); }
+				seen[i] = &config.Force();
+			});
+		}
+		go = true;
+		for(auto& thread : threads) { thread.join(); }
+
+		EXPECT_EQ(evaluations, 1);
+		for(const auto* value : seen) { EXPECT_EQ(value, &config.Force()); }
+		EXPECT_EQ(config.Force(), (std::vector<int>{ 1, 2, 3 }));
+	}
+
+#ifndef LIBMONAD_NO_EXCEPTIONS
+	TEST(LazyTests, TriesAgainAfterThrowing)
+	{
+		int attempts = 0;
+		const auto flaky = Defer([&]
+		{
+			if(++attempts == 1) { throw std::runtime_error("first attempt fails"); }
+			return attempts;
+		});
+
+		EXPECT_THROW(flaky.Force(), std::runtime_error);
+		EXPECT_FALSE(flaky.IsForced());
+		EXPECT_EQ(flaky.Force(), 2);
+		EXPECT_EQ(flaky.Force(), 2);
+	}
+#endif
+}
@@ -1,5 +1,5 @@
 #include "pch.h"
-#include "..\lib\Either.h"
+#include "../lib/Either.h"
 using namespace libmonad;
 
 namespace Tests
@@ -76,4 +76,48 @@ namespace Tests
 		EXPECT_EQ(result2, 0.0f);
 
 	}
-}
\ No newline at end of file
+
+	TEST(EitherTests, MapDeducesType)
+	{
+		Either<std::string, int> either = 5;
+
+		// No template argument needed, the type to transform to comes from what the lambda returns
+		auto result = either.Map([](const int i) { return i * 2.5f; })
+		.Map([](const float f) { return static_cast<long>(f); });
+
+		static_assert(std::is_same_v<decltype(result), Either<std::string, long>>);
+		EXPECT_EQ(result.WhenLeft([](const std::string&) { return 0L; }), 12L);
+
+		// A transformation that returns an either is not nested inside another
+		auto result2 = either.Map([](int) { return Either<std::string, char>(std::string("Error")); });
+
+		static_assert(std::is_same_v<decltype(result2), Either<std::string, char>>);
+		EXPECT_TRUE(result2.IsLeft());
+	}
+
+	TEST(EitherTests, MapDeducedShortCircuit)
+	{
+		Either<std::string, int> either{"Error"};
+		auto calls = 0;
+
+		auto result = either.Map([&](const int i) { calls++; return i + 1; })
+		.Map([&](const int i) { calls++; return static_cast<double>(i); });
+
+		EXPECT_TRUE(result.IsLeft());
+		EXPECT_EQ(calls, 0);
+		EXPECT_EQ(result.Match([](const std::string& s) { return s; }, [](double) { return std::string("right"); }), "Error");
+	}
+
+	TEST(EitherTests, MapAndBindPassLeftOnAsLeft)
+	{
+		// The left value converts to the right type too, and must still be passed on as the left
+		const Either<int, long> failed = 7;
+
+		const auto mapped = failed.Map([](const long l) { return Either<int, double>(inPlaceRight, l * 0.5); });
+		const auto bound = failed.Bind([](const long l) { return Either<int, double>(inPlaceRight, l * 0.5); });
+
+		static_assert(std::is_same_v<decltype(mapped), const Either<int, double>>);
+		EXPECT_EQ(mapped, (Either<int, double>(inPlaceLeft, 7)));
+		EXPECT_EQ(bound, (Either<int, double>(inPlaceLeft, 7)));
+	}
+}
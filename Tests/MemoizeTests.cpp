@@ -0,0 +1,134 @@
+#include "pch.h"
+
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../lib/Memoize.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	// Counts how often it is really called
+	struct CountedLookup
+	{
+		int* calls;
+
+		Either<std::string, int> operator()(const int key) const
+		{
+			++*calls;
+			if(key < 0) { return std::string("negative"); }
+			return key * 10;
+		}
+	};
+
+	TEST(MemoizeTests, KeepsResultsByKey)
+	{
+		int calls = 0;
+		auto lookup = Memoize<int>(CountedLookup{ &calls }, 16);
+
+		EXPECT_EQ(lookup(1), (Either<std::string, int>(10)));
+		EXPECT_EQ(lookup(1), (Either<std::string, int>(10)));
+		EXPECT_EQ(lookup(-1), (Either<std::string, int>("negative")));
+		EXPECT_EQ(lookup(-1), (Either<std::string, int>("negative")));
+		EXPECT_EQ(calls, 2);
+		EXPECT_EQ(lookup.Stats().hits, 2);
+		EXPECT_EQ(lookup.Stats().misses, 2);
+
+		const auto bound = Either<std::string, int>(1).Bind(lookup).Map([](const int i) { return i + 1; });
+		EXPECT_EQ(bound, (Either<std::string, int>(11)));
+		EXPECT_EQ(calls, 2);
+	}
+
+	TEST(MemoizeTests, CanRecomputeLefts)
+	{
+		int calls = 0;
+		auto lookup = Memoize<int>(CountedLookup{ &calls }, 16, CacheLefts::No);
+
+		lookup(-1);
+		lookup(-1);
+		lookup(2);
+		lookup(2);
+		EXPECT_EQ(calls, 3);
+		EXPECT_EQ(lookup.Size(), 1);
+
+		auto half = Memoize<int>([](const int i) { return i % 2 == 0 ? Option<int>(i / 2) : None(); }, 4, CacheLefts::No);
+		EXPECT_EQ(half(3), None());
+		EXPECT_EQ(half(4), Option<int>(2));
+		EXPECT_EQ(half.Size(), 1);
+	}
+
+	TEST(MemoizeTests, EvictsKeysNotFoundSinceTheClockLastPassed)
+	{
+		int calls = 0;
+		auto lookup = Memoize<int>(CountedLookup{ &calls }, 2);
+
+		lookup(1);
+		lookup(2);
+		lookup(1);  // found, so spared once
+		lookup(3);  // evicts 2
+		EXPECT_EQ(lookup.Stats().evictions, 1);
+		EXPECT_EQ(lookup.Size(), 2);
+
+		calls = 0;
+		lookup(1);
+		lookup(3);
+		EXPECT_EQ(calls, 0);
+		lookup(2);
+		EXPECT_EQ(calls, 1);
+	}
+
+	TEST(MemoizeTests, StaysCorrectThroughManyEvictions)
+	{
+		int calls = 0;
+		auto lookup = Memoize<int>(CountedLookup{ &calls }, 8);
+		std::mt19937 random(7);
+		std::uniform_int_distribution<int> keys(-20, 100);
+		for(int i = 0; i < 20000; i++)
+		{
+			const auto key = keys(random);
+			ASSERT_EQ(lookup(key), CountedLookup{ &calls }(key));
+		}
+		EXPECT_EQ(lookup.Size(), 8);
+		EXPECT_EQ(lookup.Stats().hits + lookup.Stats().misses, 20000);
+	}
+
+	TEST(MemoizeTests, ShardsAcrossThreads)
+	{
+		const auto square = MemoizeSharded<int>([](const int i) { return Option<long>(static_cast<long>(i) * i); }, 1024, 8);
+		std::vector<std::thread> threads;
+		std::vector<char> correct(4, true);
+		for(std::size_t t = 0; t < correct.size(); t++)
+		{
+			threads.emplace_back([&, t]
+			{
+				for(int i = 0; i < 10000; i++)
+				{
+					const auto key = i % 64;
+					if(square(key) != Option<long>(static_cast<long>(key) * key)) { correct[t] = false; }
+				}
+			});
+		}
+		for(auto& thread : threads) { thread.join(); }
+
+		const auto stats = square.Stats();
+		EXPECT_EQ(correct, std::vector<char>(4, true));
+		EXPECT_EQ(stats.hits + stats.misses, 40000);
+		EXPECT_GE(stats.misses, 64);
+		EXPECT_LE(stats.misses, 64 * 4);
+		EXPECT_EQ(stats.evictions, 0);
+	}
+
+	TEST(MemoizeTests, SpreadsKeysThatShareLowBitsAcrossShards)
+	{
+		// Every key is a multiple of 16, so taking the hash modulo the shard count would put them all in one shard
+		const auto square = MemoizeSharded<int>([](const int i) { return Option<long>(static_cast<long>(i) * i); }, 256, 16);
+		for(int i = 0; i < 64; i++) { square(i * 16); }
+		for(int i = 0; i < 64; i++) { EXPECT_EQ(square(i * 16), Option<long>(static_cast<long>(i) * i * 256)); }
+
+		const auto stats = square.Stats();
+		EXPECT_EQ(stats.evictions, 0);
+		EXPECT_EQ(stats.hits, 64);
+	}
+}
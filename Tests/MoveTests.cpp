@@ -0,0 +1,202 @@
+#include "pch.h"
+
+#include <memory>
+#include <string>
+
+#include "../lib/Either.h"
+#include "../lib/Option.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	/**
+	 * \brief Counts how many times it is copied and moved
+	 */
+	struct Probe
+	{
+		static int copies;
+		static int moves;
+
+		int value;
+
+		explicit Probe(const int value) : value(value) {}
+		Probe(const Probe& other) : value(other.value) { copies++; }
+		Probe(Probe&& other) noexcept : value(other.value) { moves++; }
+		Probe& operator=(const Probe& other) { value = other.value; copies++; return *this; }
+		Probe& operator=(Probe&& other) noexcept { value = other.value; moves++; return *this; }
+
+		static void Reset() { copies = 0; moves = 0; }
+	};
+
+	int Probe::copies = 0;
+	int Probe::moves = 0;
+
+	/**
+	 * \brief Can be neither copied nor moved, so can only be made where it is kept. Counts how many are made.
+	 */
+	struct Pinned
+	{
+		static int made;
+
+		int number;
+		std::string name;
+
+		Pinned(const int number, const char* name) : number(number), name(name) { made++; }
+		Pinned(const Pinned&) = delete;
+		Pinned& operator=(const Pinned&) = delete;
+	};
+
+	int Pinned::made = 0;
+
+	// Passes the probe it is given on, one higher
+	auto next = [](Probe&& probe) { probe.value++; return std::move(probe); };
+
+	TEST(MoveTests, RightPipelineDoesNotCopy)
+	{
+		Either<std::string, Probe> either = Probe(0);
+		Probe::Reset();
+
+		auto result = std::move(either)
+			.Map(next).Map(next).Map(next).Map(next).Map(next)
+			.Map(next).Map(next).Map(next).Map(next).Map(next);
+
+		EXPECT_EQ(Probe::copies, 0);
+		EXPECT_GT(Probe::moves, 0);
+		EXPECT_EQ(std::move(result).ThrowIfLeft().value, 10);
+		EXPECT_EQ(Probe::copies, 0);
+	}
+
+	TEST(MoveTests, LeftPipelineDoesNotCopy)
+	{
+		Either<Probe, int> either = Probe(5);
+		Probe::Reset();
+
+		auto calls = 0;
+		auto increment = [&](int&& i) { calls++; return i + 1; };
+		auto bind = [&](int&& i) { calls++; return Either<Probe, int>(i); };
+
+		auto result = std::move(either)
+			.Map(increment).Bind(bind).Map(increment).Bind(bind).Map(increment)
+			.Bind(bind).Map(increment).Bind(bind).Map(increment).Bind(bind);
+
+		EXPECT_EQ(calls, 0);
+		EXPECT_EQ(Probe::copies, 0);
+
+		const auto left = std::move(result).WhenRight([](int&& i) { return Probe(i); });
+		EXPECT_EQ(left.value, 5);
+		EXPECT_EQ(Probe::copies, 0);
+	}
+
+	TEST(MoveTests, LvaluePipelineCopiesOnlyWhereAsked)
+	{
+		const Either<std::string, Probe> either = Probe(1);
+		Probe::Reset();
+
+		// Reading through a const reference needs no copy
+		const auto value = either.Map([](const Probe& probe) { return probe.value; });
+		EXPECT_EQ(Probe::copies, 0);
+		EXPECT_EQ(value.WhenLeft([](const std::string&) { return 0; }), 1);
+
+		// Taking the value by value from an lvalue either copies it, leaving the original intact
+		const auto copied = either.Map([](Probe probe) { return probe.value + 1; });
+		EXPECT_EQ(Probe::copies, 1);
+		EXPECT_EQ(either.ThrowIfLeft().value, 1);
+		EXPECT_EQ(copied.ThrowIfLeft(), 2);
+	}
+
+	TEST(MoveTests, MoveOnlyEither)
+	{
+		Either<std::string, std::unique_ptr<int>> either = std::make_unique<int>(41);
+
+		auto result = std::move(either)
+			.Map([](std::unique_ptr<int>&& p) { ++*p; return std::move(p); })
+			.Bind([](std::unique_ptr<int>&& p)
+			{
+				return *p == 42
+					? Either<std::string, std::unique_ptr<int>>(std::move(p))
+					: Either<std::string, std::unique_ptr<int>>(std::string("Not the answer"));
+			});
+
+		EXPECT_TRUE(result.IsRight());
+		EXPECT_EQ(*result.ThrowIfLeft(), 42);
+
+		auto moved = std::move(result);
+		const std::unique_ptr<int> pointer = std::move(moved).WhenLeft([](std::string&&) { return std::unique_ptr<int>(); });
+		EXPECT_EQ(*pointer, 42);
+
+		Either<std::unique_ptr<std::string>, int> left = std::make_unique<std::string>("Error");
+		const auto message = std::move(left)
+			.Map([](int&& i) { return i * 2; })
+			.Match([](std::unique_ptr<std::string>&& s) { return *s; }, [](int&&) { return std::string(); });
+
+		EXPECT_EQ(message, "Error");
+	}
+
+	TEST(MoveTests, MoveOnlyOption)
+	{
+		Option<std::unique_ptr<int>> option = std::make_unique<int>(1);
+
+		auto result = std::move(option)
+			.Map([](std::unique_ptr<int>&& p) { *p += 1; return std::move(p); })
+			.Bind([](std::unique_ptr<int>&& p) { return Option<std::unique_ptr<int>>(std::move(p)); })
+			.Map([](std::unique_ptr<int>&& p) { return *p; });
+
+		EXPECT_EQ(std::move(result).ThrowIfNone(), 2);
+
+		Option<Probe> probe = Probe(3);
+		Probe::Reset();
+
+		const auto value = std::move(probe)
+			.Map(next).Map(next).Map(next)
+			.MatchTo([] { return 0; }, [](Probe&& p) { return p.value; });
+
+		EXPECT_EQ(value, 6);
+		EXPECT_EQ(Probe::copies, 0);
+	}
+
+	TEST(MoveTests, InPlaceConstructsOnce)
+	{
+		Pinned::made = 0;
+
+		const Either<std::string, Pinned> right(inPlaceRight, 1, "one");
+		const Either<Pinned, int> left(inPlaceLeft, 2, "two");
+		const Option<Pinned> option(std::in_place, 3, "three");
+
+		EXPECT_EQ(Pinned::made, 3);
+		EXPECT_EQ(right.ThrowIfLeft().name, "one");
+		EXPECT_EQ(left.Match([](const Pinned& p) { return p.number; }, [](int) { return 0; }), 2);
+		EXPECT_EQ(option.ThrowIfNone().name, "three");
+
+		Probe::Reset();
+		const Option<Probe> probe = Probe(4);
+		EXPECT_EQ(probe.ThrowIfNone().value, 4);
+		EXPECT_EQ(Probe::moves, 1);
+		EXPECT_EQ(Probe::copies, 0);
+
+		static_assert(Either<int, long>(inPlaceRight, 5L).IsRight());
+		static_assert(Option<int>(std::in_place, 6).IsSome());
+	}
+
+	TEST(MoveTests, EmplaceConstructsOnce)
+	{
+		Either<std::string, Probe> either = std::string("not yet");
+		Option<Probe> option;
+		Probe::Reset();
+
+		EXPECT_EQ(either.EmplaceRight(1).value, 1);
+		EXPECT_EQ(either.EmplaceRight(2).value, 2);
+		EXPECT_EQ(option.Emplace(3).value, 3);
+		EXPECT_EQ(option.Emplace(4).value, 4);
+		EXPECT_EQ(Probe::copies, 0);
+		EXPECT_EQ(Probe::moves, 0);
+		EXPECT_EQ(either.ThrowIfLeft().value, 2);
+		EXPECT_EQ(option.ThrowIfNone().value, 4);
+
+		either.EmplaceLeft(3, 'x');
+		EXPECT_EQ(either.Match([](const std::string& s) { return s; }, [](const Probe&) { return std::string(); }), "xxx");
+
+		Option<std::unique_ptr<int>> pointer;
+		EXPECT_EQ(*pointer.Emplace(new int(7)), 7);
+		EXPECT_TRUE(pointer.IsSome());
+	}
+}
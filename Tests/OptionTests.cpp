@@ -1,11 +1,38 @@
 #include "pch.h"
-#include "..\lib\Option.h"
+#include "../lib/Option.h"
 
 using namespace libmonad;
 using namespace std;
 
 namespace Tests
 {
+	/**
+	 * \brief An index into a table, where the largest value is never a real index
+	 */
+	struct Index
+	{
+		unsigned int position;
+	};
+}
+
+// Reserve the largest index to mean None
+template <>
+struct libmonad::NoneSentinel<Tests::Index>
+{
+	static constexpr bool Enabled = true;
+	static Tests::Index Value() noexcept { return { 0xFFFFFFFF }; }
+	static bool IsNone(const Tests::Index& index) noexcept { return index.position == 0xFFFFFFFF; }
+};
+
+namespace Tests
+{
+	// An option is its value plus a flag, or just its value when it has a reserved value to mean None
+	static_assert(sizeof(Option<int>) == sizeof(int) + alignof(int));
+	static_assert(sizeof(Option<double>) == sizeof(double) + alignof(double));
+	static_assert(sizeof(Option<int*>) == sizeof(int*));
+	static_assert(sizeof(Option<std::unique_ptr<string>>) == sizeof(std::unique_ptr<string>));
+	static_assert(sizeof(Option<Index>) == sizeof(Index));
+
 	TEST(OptionTests, Match)
 	{
 		Option<int> maybeNumber = 25;
@@ -152,7 +179,7 @@ namespace Tests
 		Option<std::string> maybeString {"Stuart"};
 
 		// It should not throw as the option is set to a string
-		EXPECT_NO_THROW(maybeString.ThrowIfNone());
+		EXPECT_NO_MONAD_ERROR(maybeString.ThrowIfNone());
 
 		// Of course the whole point of ThrowIfNone() is to get the underlying value if its not a none:
 		auto theString = maybeString.ThrowIfNone();
@@ -169,9 +196,10 @@ namespace Tests
 		maybeString = None();
 
 		// Should throw
-		EXPECT_THROW(maybeString.ThrowIfNone(), std::exception);
+		EXPECT_MONAD_ERROR(maybeString.ThrowIfNone(), "ThrowIfNone");
 		std::string message = "Bad juju! Value can't be none here!";
 
+#if LIBMONAD_ERROR_POLICY == LIBMONAD_ERROR_POLICY_THROW
 		try
 		{
 			// pass a message to use in the exception as a variable
@@ -195,6 +223,54 @@ namespace Tests
 			// check it passed message to thrown exception
 			EXPECT_STREQ(e.what(), "Bad juju! Value can't be none here!");
 		}
-
+#else
+		// The message is what the policy reports
+		EXPECT_MONAD_ERROR(maybeString.ThrowIfNone(message), message);
+#endif
 	};
-}
\ No newline at end of file
+
+	TEST(OptionTests, MapAndBindDeduceType)
+	{
+		Option<int> option = 25;
+
+		auto result = option
+		              .Map([](const int i) { return i * 2; })
+		              .Bind([](const int i) { return i > 10 ? Option<string>(to_string(i)) : Option<string>(); })
+		              .Map([](const string& s) { return s + "!"; });
+
+		static_assert(std::is_same_v<decltype(result), Option<string>>);
+		EXPECT_EQ(result.WhenNone([] { return string("none"); }), "50!");
+
+		Option<int> none = None();
+		auto noneResult = none.Map([](const int i) { return to_string(i); });
+
+		EXPECT_TRUE(noneResult.IsNone());
+		EXPECT_EQ(noneResult.MatchTo([] { return string("none"); }, [](const string& s) { return s; }), "none");
+	}
+
+	TEST(OptionTests, SentinelNone)
+	{
+		int number = 5;
+
+		Option<int*> pointer = &number;
+		EXPECT_TRUE(pointer.IsSome());
+		EXPECT_EQ(*pointer.ThrowIfNone(), 5);
+
+		// A null pointer is the reserved value, so it is None
+		pointer = static_cast<int*>(nullptr);
+		EXPECT_TRUE(pointer.IsNone());
+
+		Option<Index> index = Index{ 3 };
+		EXPECT_EQ(index.Map([](const Index& i) { return i.position * 2; }).WhenNone([] { return 0u; }), 6u);
+
+		index = None();
+		EXPECT_TRUE(index.IsNone());
+		EXPECT_EQ(index.Map([](const Index& i) { return i.position * 2; }).WhenNone([] { return 0u; }), 0u);
+
+		// Moving the value out of an option of unique pointer leaves it None
+		Option<std::unique_ptr<int>> owner = std::make_unique<int>(7);
+		Option<std::unique_ptr<int>> taken = std::move(owner);
+		EXPECT_TRUE(taken.IsSome());
+		EXPECT_TRUE(owner.IsNone());
+	}
+}
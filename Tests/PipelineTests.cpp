@@ -0,0 +1,124 @@
+#include "pch.h"
+
+#include <string>
+
+#include "../lib/Pipeline.h"
+#include "../lib/Trace.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	// Left value is an error code
+	using Result = Either<int, long>;
+
+	constexpr int Odd = -1;
+	constexpr int Stop = -2;
+	constexpr int Failed = -3;
+
+	auto times12 = [](const long l) { return l * 12; };
+	auto failIfOdd = [](const long l) { return l % 2 == 0 ? Result(l / 2) : Result(Odd); };
+	auto toText = [](const long l) { return std::to_string(l); };
+
+	TEST(PipelineTests, RunsStagesInOrder)
+	{
+		const auto pipeline = Pipeline<int>::From<long>()
+			.Map(times12)
+			.Bind(failIfOdd)
+			.Map(toText);
+
+		const Either<int, std::string> result = pipeline.Run(Result(56L));
+
+		EXPECT_EQ(result.WhenLeft([](int) { return std::string("failed"); }), "336");
+	}
+
+	TEST(PipelineTests, MatchesEagerChain)
+	{
+		const auto pipeline = Pipeline<int>::From<long>()
+			.Map(times12)
+			.Bind(failIfOdd)
+			.Bind(failIfOdd)
+			.Map(toText);
+
+		for(long i = -20; i < 20; i++)
+		{
+			const Result input = i % 5 == 0 ? Result(Failed) : Result(i);
+			const auto eager = input.Map(times12).Bind(failIfOdd).Bind(failIfOdd).Map(toText);
+
+			EXPECT_EQ(pipeline.Run(input), eager) << i;
+		}
+	}
+
+	TEST(PipelineTests, LeftInputSkipsEveryStage)
+	{
+		int stagesRun = 0;
+		const auto pipeline = Pipeline<int>::From<long>()
+			.Map([&](const long l) { stagesRun++; return l; })
+			.Bind([&](const long l) { stagesRun++; return Result(l); });
+
+		const auto result = pipeline.Run(Result(Failed));
+
+		EXPECT_EQ(stagesRun, 0);
+		EXPECT_EQ(result, Result(Failed));
+	}
+
+	TEST(PipelineTests, LeftFromBindSkipsLaterStages)
+	{
+		int stagesRun = 0;
+		const auto pipeline = Pipeline<int>::From<long>()
+			.Bind([](long) { return Result(Stop); })
+			.Map([&](const long l) { stagesRun++; return l; })
+			.Map([&](const long l) { stagesRun++; return l; });
+
+		EXPECT_EQ(pipeline.Run(1L), Result(Stop));
+		EXPECT_EQ(stagesRun, 0);
+	}
+
+	TEST(PipelineTests, MapMayReturnEither)
+	{
+		// As with Either::Map, a stage returning an Either is flattened rather than nested
+		const auto pipeline = Pipeline<int>::From<long>().Map(failIfOdd);
+
+		EXPECT_EQ(pipeline.Run(4L), Result(2L));
+		EXPECT_EQ(pipeline.Run(3L), Result(Odd));
+	}
+
+	TEST(PipelineTests, ReusableAndUsableAsFunction)
+	{
+		const auto pipeline = Pipeline<int>::From<long>().Map(times12).Bind(failIfOdd);
+
+		long total = 0;
+		for(long i = 0; i < 1000; i++)
+		{
+			total += pipeline(i).WhenLeft([](int) { return 0L; });
+		}
+
+		EXPECT_EQ(total, 6 * 999 * 1000 / 2);
+	}
+
+	TEST(PipelineTests, EmptyPipelinePassesInputThrough)
+	{
+		const auto pipeline = Pipeline<int>::From<long>();
+
+		EXPECT_EQ(pipeline.Run(Result(3L)), Result(3L));
+		EXPECT_EQ(pipeline.Run(Result(Failed)), Result(Failed));
+	}
+
+	TEST(PipelineTests, UsableInConstantExpressions)
+	{
+		constexpr auto pipeline = Pipeline<int>::From<long>()
+			.Map([](const long l) { return l * 2; })
+			.Bind([](const long l) { return l > 100 ? Either<int, long>(-1) : Either<int, long>(l); });
+
+		static_assert(pipeline.Run(21L) == Either<int, long>(42L));
+		static_assert(pipeline.Run(51L) == Either<int, long>(-1));
+		static_assert(pipeline.Run(Either<int, long>(7)) == Either<int, long>(7));
+	}
+
+	TEST(PipelineTests, TracedStagesAreThePlainFunctionsWhenNotTracing)
+	{
+		static_assert(std::is_same_v<decltype(Traced<"times12">(times12)), decltype(times12)>);
+
+		EXPECT_EQ(Result(2L).Map(Traced<"times12">(times12)), Result(24L));
+		EXPECT_TRUE(Trace::Snapshot().stages.empty());
+	}
+}
@@ -0,0 +1,170 @@
+#include "pch.h"
+
+#include <map>
+#include <string>
+
+#include "../lib/Either.h"
+#include "../lib/Option.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	// Counts its copies and moves, so tests can check a reference is passed on rather than the object
+	struct Record
+	{
+		explicit Record(const int id) : id(id) {}
+		Record(const Record& other) : id(other.id) { copies++; }
+		Record(Record&& other) noexcept : id(other.id) { moves++; }
+		Record& operator=(const Record& other) { id = other.id; copies++; return *this; }
+		Record& operator=(Record&& other) noexcept { id = other.id; moves++; return *this; }
+
+		friend bool operator==(const Record& a, const Record& b) { return a.id == b.id; }
+
+		int id;
+
+		static inline int copies = 0;
+		static inline int moves = 0;
+		static void Reset() { copies = moves = 0; }
+	};
+
+	class RecordCache
+	{
+	public:
+		RecordCache() { for(int i = 0; i < 10; i++) { records.emplace(i, Record(i)); } }
+
+		Option<const Record&> Find(const int id) const
+		{
+			const auto found = records.find(id);
+			if(found == records.end()) { return None(); }
+			return found->second;
+		}
+
+		Option<Record&> Find(const int id)
+		{
+			const auto found = records.find(id);
+			if(found == records.end()) { return None(); }
+			return found->second;
+		}
+
+	private:
+		std::map<int, Record> records;
+	};
+
+	TEST(ReferenceTests, OptionOfReferenceIsOnePointer)
+	{
+		EXPECT_EQ(sizeof(Option<Record&>), sizeof(Record*));
+		EXPECT_EQ(sizeof(Option<const Record&>), sizeof(Record*));
+	}
+
+	TEST(ReferenceTests, OptionCannotReferToTemporary)
+	{
+		EXPECT_FALSE((std::is_constructible_v<Option<const Record&>, Record&&>));
+		EXPECT_FALSE((std::is_constructible_v<Either<int, const Record&>, Record&&>));
+		EXPECT_TRUE((std::is_constructible_v<Option<const Record&>, const Record&>));
+	}
+
+	TEST(ReferenceTests, OptionMapAndBindPassReferencedObject)
+	{
+		const RecordCache cache;
+		Record::Reset();
+
+		const auto id = cache.Find(3).Map([](const Record& record) { return record.id; });
+		const auto again = cache.Find(3)
+			.Bind([&](const Record& record) { return cache.Find(record.id + 1); })
+			.Map([](const Record& record) { return record.id; });
+		const auto missing = cache.Find(30).Map([](const Record& record) { return record.id; });
+
+		EXPECT_EQ(id, Option<int>(3));
+		EXPECT_EQ(again, Option<int>(4));
+		EXPECT_EQ(missing, None());
+		EXPECT_EQ(Record::copies, 0);
+		EXPECT_EQ(Record::moves, 0);
+	}
+
+	TEST(ReferenceTests, OptionRefersToObjectItself)
+	{
+		RecordCache cache;
+		cache.Find(2).ThrowIfNone().id = 20;
+		std::move(cache.Find(5)).Match([](None) {}, [](Record& record) { record.id = 50; });
+
+		EXPECT_EQ(cache.Find(2).ThrowIfNone().id, 20);
+		EXPECT_EQ(cache.Find(5).ThrowIfNone().id, 50);
+	}
+
+	TEST(ReferenceTests, AssigningOptionRebindsIt)
+	{
+		Record first(1);
+		Record second(2);
+		Option<Record&> option = first;
+		Record::Reset();
+
+		option = second;
+		option = Option<Record&>(second);
+
+		EXPECT_EQ(first.id, 1);
+		EXPECT_EQ(&option.ThrowIfNone(), &second);
+		EXPECT_EQ(Record::copies, 0);
+
+		option = None();
+		EXPECT_TRUE(option.IsNone());
+	}
+
+	TEST(ReferenceTests, OptionsOfReferencesCompareObjects)
+	{
+		Record a(1);
+		Record b(1);
+		Record c(2);
+
+		EXPECT_EQ(Option<Record&>(a), Option<Record&>(b));
+		EXPECT_FALSE(Option<Record&>(a) == Option<Record&>(c));
+		EXPECT_EQ(Option<Record&>(), None());
+	}
+
+	TEST(ReferenceTests, EitherOfRightReferencePassesObject)
+	{
+		Record record(7);
+		Record::Reset();
+
+		Either<int, Record&> either = record;
+		const auto id = either.Map([](const Record& r) { return static_cast<long>(r.id); });
+		std::move(either).Map([](Record& r) { r.id++; return 0L; });
+		const auto left = Either<int, Record&>(-1).Map([](const Record& r) { return static_cast<long>(r.id); });
+
+		EXPECT_EQ(id, (Either<int, long>(7L)));
+		EXPECT_EQ(record.id, 8);
+		EXPECT_EQ(left, (Either<int, long>(-1)));
+		EXPECT_EQ(&either.ThrowIfLeft(), &record);
+		EXPECT_EQ(Record::copies, 0);
+		EXPECT_EQ(Record::moves, 0);
+	}
+
+	TEST(ReferenceTests, EitherOfLeftReferencePassesObject)
+	{
+		const Record failure(99);
+		Record::Reset();
+
+		const Either<const Record&, int> either = failure;
+		const auto mapped = either.Map([](const int i) { return i + 1; });
+		const Record* left = nullptr;
+		mapped.Match([&](const Record& r) { left = &r; }, [](int) {});
+
+		EXPECT_TRUE(mapped.IsLeft());
+		EXPECT_EQ(left, &failure);
+		EXPECT_EQ(Record::copies, 0);
+	}
+
+	TEST(ReferenceTests, AssigningEitherRebindsIt)
+	{
+		Record first(1);
+		Record second(2);
+		Either<int, Record&> either = first;
+
+		either = Either<int, Record&>(second);
+		EXPECT_EQ(first.id, 1);
+		EXPECT_EQ(&either.ThrowIfLeft(), &second);
+
+		either = Either<int, Record&>(3);
+		EXPECT_TRUE(either.IsLeft());
+		EXPECT_EQ(sizeof(Either<int, Record&>), 2 * sizeof(Record*));
+	}
+}
@@ -0,0 +1,111 @@
+#include "pch.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../lib/Stream.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	using Record = Either<std::string, long>;
+
+	// Yields count records, of which every one whose index is a multiple of leftEvery (if not 0) fails to parse, and counts how many were pulled
+	EitherStream<std::string, long> Records(const long count, const long leftEvery, long& pulled)
+	{
+		for(long i = 0; i < count; i++)
+		{
+			pulled++;
+			if(leftEvery != 0 && i % leftEvery == 0) { co_yield Record("bad record " + std::to_string(i)); }
+			else { co_yield i; }
+		}
+	}
+
+	OptionStream<int> Numbers(const std::vector<Option<int>>& numbers)
+	{
+		for(const auto& number : numbers) { co_yield number; }
+	}
+
+	TEST(EitherStreamTests, RunsStagesElementByElement)
+	{
+		long pulled = 0;
+		std::vector<Record> seen;
+		auto stream = Records(10, 4, pulled)
+			.Map([](const long l) { return l * 10; })
+			.Bind([](const long l) { return l == 30 ? Record("thirty") : Record(l + 1); })
+			.Filter([](const long l) { return l != 51; });
+
+		auto next = stream.Next();
+		EXPECT_EQ(pulled, 1);
+		EXPECT_EQ(next, Option<Record>(Record("bad record 0")));
+
+		for(auto& record : stream) { seen.push_back(std::move(record)); }
+		EXPECT_EQ(pulled, 10);
+		EXPECT_EQ(seen, (std::vector<Record>{ 11L, 21L, Record("thirty"), Record("bad record 4"), 61L, 71L, Record("bad record 8"), 91L }));
+		EXPECT_EQ(stream.Next(), None());
+	}
+
+	TEST(EitherStreamTests, StopsPullingAtFirstLeft)
+	{
+		long pulled = 0;
+		const auto collected = Records(1000, 0, pulled)
+			.Bind([](const long l) { return l < 5 ? Record(l) : Record("too big"); })
+			.CollectOrFirstLeft();
+		EXPECT_EQ(collected, (Either<std::string, std::vector<long>>("too big")));
+		EXPECT_EQ(pulled, 6);
+
+		pulled = 0;
+		std::vector<long> taken;
+		auto doubled = Records(1000, 0, pulled).Map([](const long l) { return (l + 1) * 2; });
+		for(auto& record : std::move(doubled).Bind([](const long l) { return l < 10 ? Record(l) : Record("too big"); }).TakeWhileRight())
+		{
+			taken.push_back(record.ThrowIfLeft());
+		}
+		EXPECT_EQ(taken, (std::vector<long>{ 2, 4, 6, 8 }));
+		EXPECT_EQ(pulled, 5);
+
+		pulled = 0;
+		EXPECT_EQ(Records(5, 0, pulled).CollectOrFirstLeft(), (Either<std::string, std::vector<long>>(std::vector<long>{ 0, 1, 2, 3, 4 })));
+	}
+
+	TEST(EitherStreamTests, ChunksRightValues)
+	{
+		long pulled = 0;
+		std::vector<Either<std::string, std::vector<long>>> chunks;
+		for(auto& chunk : Records(11, 5, pulled).Chunk(3)) { chunks.push_back(std::move(chunk)); }
+
+		using Chunk = Either<std::string, std::vector<long>>;
+		EXPECT_EQ(chunks, (std::vector<Chunk>{
+			Chunk("bad record 0"), Chunk(std::vector<long>{ 1, 2, 3 }), Chunk(std::vector<long>{ 4 }),
+			Chunk("bad record 5"), Chunk(std::vector<long>{ 6, 7, 8 }), Chunk(std::vector<long>{ 9 }), Chunk("bad record 10") }));
+	}
+
+#ifndef LIBMONAD_NO_EXCEPTIONS
+	TEST(EitherStreamTests, PassesOnExceptions)
+	{
+		long pulled = 0;
+		auto stream = Records(10, 0, pulled).Map([](const long l) { if(l == 2) { throw std::runtime_error("stage failed"); } return l; });
+
+		EXPECT_EQ(stream.Next(), Option<Record>(0L));
+		EXPECT_EQ(stream.Next(), Option<Record>(1L));
+		EXPECT_THROW(stream.Next(), std::runtime_error);
+		EXPECT_EQ(stream.Next(), None());
+	}
+#endif
+
+	TEST(OptionStreamTests, MapsFiltersAndCollects)
+	{
+		const std::vector<Option<int>> numbers = { 1, 2, None(), 4, 5 };
+		std::vector<Option<int>> seen;
+		for(auto& number : Numbers(numbers).Map([](const int i) { return i * 3; }).Filter([](const int i) { return i % 2 == 1; }))
+		{
+			seen.push_back(number);
+		}
+
+		EXPECT_EQ(seen, (std::vector<Option<int>>{ 3, None(), 15 }));
+		EXPECT_EQ(Numbers(numbers).CollectOrNone(), None());
+		EXPECT_EQ(Numbers(numbers).TakeWhileSome().CollectOrNone(), Option<std::vector<int>>(std::vector<int>{ 1, 2 }));
+		EXPECT_EQ(Numbers(numbers).Bind([](const int i) { return i > 1 ? Option<int>(i) : Option<int>(); }).Chunk(2).Next(), Option<Option<std::vector<int>>>(Option<std::vector<int>>()));
+	}
+}
@@ -0,0 +1,239 @@
+#include "pch.h"
+
+#include <memory>
+#include <string>
+
+#include "../lib/Task.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	// Left value is an error code
+	using Result = Either<int, long>;
+
+	constexpr int Negative = -1;
+	constexpr int Odd = -2;
+
+	Result Parse(const long l) { return l < 0 ? Result(Negative) : Result(l); }
+	Result Halve(const long l) { return l % 2 == 0 ? Result(l / 2) : Result(Odd); }
+
+	EitherTask<int, long> Quarter(const long input)
+	{
+		const long parsed = co_await Parse(input);
+		const long half = co_await Halve(parsed);
+		co_return co_await Halve(half);
+	}
+
+	TEST(EitherTaskTests, ReturnsResultWhenEveryAwaitIsRight)
+	{
+		const Result result = Quarter(36);
+
+		EXPECT_EQ(result, Result(9L));
+	}
+
+	TEST(EitherTaskTests, EndsWithFirstLeft)
+	{
+		int reached = 0;
+		auto run = [&](const long input) -> EitherTask<int, long>
+		{
+			const long parsed = co_await Parse(input);
+			reached++;
+			const long half = co_await Halve(parsed);
+			reached++;
+			co_return half;
+		};
+
+		EXPECT_EQ(run(-4).Result(), Result(Negative));
+		EXPECT_EQ(reached, 0);
+		EXPECT_EQ(run(3).Result(), Result(Odd));
+		EXPECT_EQ(reached, 1);
+	}
+
+	TEST(EitherTaskTests, MatchesBindChain)
+	{
+		for(long i = -20; i < 20; i++)
+		{
+			const auto chained = Parse(i).Bind(Halve).Bind(Halve);
+
+			EXPECT_EQ(Quarter(i).Result(), chained) << i;
+		}
+	}
+
+	TEST(EitherTaskTests, CoReturnsLeftValue)
+	{
+		auto run = [](const long input) -> EitherTask<int, long>
+		{
+			if(co_await Parse(input) > 100) { co_return Odd; }
+			co_return input;
+		};
+
+		EXPECT_EQ(run(101).Result(), Result(Odd));
+		EXPECT_EQ(run(5).Result(), Result(5L));
+	}
+
+	TEST(EitherTaskTests, AwaitsLvalueWithoutMovingFromIt)
+	{
+		const Either<int, std::string> text = std::string("kept");
+		auto run = [&]() -> EitherTask<int, size_t>
+		{
+			const std::string& value = co_await text;
+			co_return value.size();
+		};
+
+		EXPECT_EQ(run().Result(), (Either<int, size_t>(size_t(4))));
+		EXPECT_EQ(text, (Either<int, std::string>(std::string("kept"))));
+	}
+
+	TEST(EitherTaskTests, MovesOutOfRvalue)
+	{
+		auto make = [](const int i) { return i == 0 ? Either<int, std::unique_ptr<int>>(Negative) : Either<int, std::unique_ptr<int>>(std::make_unique<int>(i)); };
+		auto run = [&](const int i) -> EitherTask<int, std::unique_ptr<int>>
+		{
+			auto pointer = co_await make(i);
+			*pointer *= 2;
+			co_return std::move(pointer);
+		};
+
+		EXPECT_EQ(*run(21).Result().ThrowIfLeft(), 42);
+		EXPECT_TRUE(run(0).Result().IsLeft());
+	}
+
+	TEST(EitherTaskTests, ConvertsAwaitedLeftValue)
+	{
+		auto run = []() -> EitherTask<long, int>
+		{
+			const auto value = co_await Either<int, std::string>(std::string("5"));
+			co_await Either<short, std::string>(short(3));
+			co_return static_cast<int>(value.size());
+		};
+
+		EXPECT_EQ(run().Result(), (Either<long, int>(3L)));
+	}
+
+	TEST(EitherTaskTests, AwaitsAnotherTask)
+	{
+		auto run = [](const long input) -> EitherTask<int, std::string>
+		{
+			co_return std::to_string(co_await Quarter(input));
+		};
+
+		EXPECT_EQ(run(8).Result(), (Either<int, std::string>(std::string("2"))));
+		EXPECT_EQ(run(6).Result(), (Either<int, std::string>(Odd)));
+	}
+
+	TEST(EitherTaskTests, DestroysLocalsWhenEndedByLeft)
+	{
+		auto destroyed = 0;
+		struct Counted
+		{
+			int* destroyed;
+			~Counted() { (*destroyed)++; }
+		};
+
+		auto run = [&]() -> EitherTask<int, long>
+		{
+			Counted counted{ &destroyed };
+			co_await Parse(-1);
+			co_return 1L;
+		};
+
+		{
+			auto task = run();
+			EXPECT_EQ(destroyed, 0);
+		}
+		EXPECT_EQ(destroyed, 1);
+	}
+
+#ifndef LIBMONAD_NO_EXCEPTIONS
+	TEST(EitherTaskTests, RethrowsEscapedException)
+	{
+		auto run = []() -> EitherTask<int, long>
+		{
+			if(co_await Parse(1) == 1) { throw std::runtime_error("thrown"); }
+			co_return 1L;
+		};
+
+		auto task = run();
+		EXPECT_THROW(std::move(task).Result(), std::runtime_error);
+	}
+#endif
+
+	OptionTask<int> Add(const Option<int>& a, const Option<int>& b)
+	{
+		co_return co_await a + co_await b;
+	}
+
+	TEST(OptionTaskTests, ReturnsResultWhenEveryAwaitIsSome)
+	{
+		const Option<int> result = Add(Option<int>(2), Option<int>(3));
+
+		EXPECT_EQ(result, Option<int>(5));
+	}
+
+	TEST(OptionTaskTests, EndsWithFirstNone)
+	{
+		EXPECT_EQ(Add(None(), Option<int>(3)).Result(), None());
+		EXPECT_EQ(Add(Option<int>(2), None()).Result(), None());
+	}
+
+	TEST(OptionTaskTests, CoReturnsNone)
+	{
+		auto run = [](const Option<int>& a) -> OptionTask<int>
+		{
+			if(co_await a < 0) { co_return None(); }
+			co_return co_await Add(a, Option<int>(1));
+		};
+
+		EXPECT_EQ(run(Option<int>(-2)).Result(), None());
+		EXPECT_EQ(run(Option<int>(2)).Result(), Option<int>(3));
+	}
+
+	// Counts what goes through it and passes it on to the thread's pool
+	class CountingAllocator final : public FrameAllocator
+	{
+	public:
+		void* Allocate(const std::size_t size) override
+		{
+			allocated++;
+			return ThreadFramePool().Allocate(size);
+		}
+
+		void Deallocate(void* frame, const std::size_t size) noexcept override
+		{
+			freed++;
+			ThreadFramePool().Deallocate(frame, size);
+		}
+
+		int allocated = 0;
+		int freed = 0;
+	};
+
+	TEST(FramePoolTests, FramesAreFreedByTheAllocatorTheyCameFrom)
+	{
+		CountingAllocator counting;
+		const auto previous = SetFrameAllocator(&counting);
+		auto task = Quarter(36);
+		SetFrameAllocator(previous);
+
+		EXPECT_EQ(std::move(task).Result(), Result(9L));
+		task = Quarter(4);
+		EXPECT_EQ(counting.freed, counting.allocated);
+	}
+
+	TEST(FramePoolTests, ReusesFreedFramesOfTheSameSizeClass)
+	{
+		FramePool pool;
+		const auto first = pool.Allocate(100);
+		pool.Deallocate(first, 100);
+		EXPECT_EQ(pool.Cached(), 1u);
+
+		const auto second = pool.Allocate(120);
+		EXPECT_EQ(second, first);
+		EXPECT_EQ(pool.Cached(), 0u);
+
+		const auto large = pool.Allocate(FramePool::MaxPooledSize + 1);
+		pool.Deallocate(large, FramePool::MaxPooledSize + 1);
+		pool.Deallocate(second, 120);
+		EXPECT_EQ(pool.Cached(), 1u);
+	}
+}
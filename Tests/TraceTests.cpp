@@ -0,0 +1,91 @@
+#include "pch.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+// These tests are built into their own executable with LIBMONAD_TRACE=1
+#include "../lib/Trace.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	using Parsed = Either<std::string, long>;
+
+	Parsed ParseDigits(const std::string& text)
+	{
+		if(text.empty() || text.find_first_not_of("0123456789") != std::string::npos) { return std::string("not a number"); }
+		return std::stol(text);
+	}
+
+	Option<long> IfEven(const long l) { return l % 2 == 0 ? Option<long>(l) : None(); }
+
+	std::uint64_t LatencyTotal(const StageTrace& stage)
+	{
+		std::uint64_t total = 0;
+		for(const auto count : stage.latency) { total += count; }
+		return total;
+	}
+
+	TEST(TraceTests, CountsOutcomesOfEachStage)
+	{
+		std::vector<Parsed> halved;
+		for(const auto* text : { "12", "x", "7", "40", "" })
+		{
+			halved.push_back(Traced<"tests.parse">(ParseDigits)(text)
+				.Map(Traced<"tests.halve">([](const long l) { return l / 2; })));
+		}
+
+		const auto snapshot = Trace::Snapshot();
+		const auto* parse = snapshot.Find("tests.parse");
+		const auto* halve = snapshot.Find("tests.halve");
+		EXPECT_EQ(halved[3], Parsed(20L));
+		ASSERT_NE(parse, nullptr);
+		ASSERT_NE(halve, nullptr);
+		EXPECT_EQ(parse->lefts, 2u);
+		EXPECT_EQ(parse->rights, 3u);
+		EXPECT_DOUBLE_EQ(parse->LeftRate(), 0.4);
+		EXPECT_EQ(halve->Calls(), 3u);
+		EXPECT_EQ(halve->lefts, 0u);
+		EXPECT_EQ(LatencyTotal(*parse), 5u);
+		EXPECT_GT(parse->LatencyPercentile(0.99), 0u);
+	}
+
+	TEST(TraceTests, AddsUpEveryThread)
+	{
+		auto even = Traced<"tests.even">(IfEven);
+		std::vector<std::thread> threads;
+		for(int t = 0; t < 4; t++)
+		{
+			threads.emplace_back([even]() mutable
+			{
+				for(long i = 0; i < 1000; i++) { static_cast<void>(Option<long>(i).Bind(even)); }
+			});
+		}
+		for(auto& thread : threads) { thread.join(); }
+
+		// The threads have ended, so what they recorded is kept by the registry
+		const auto snapshot = Trace::Snapshot();
+		const auto* stage = snapshot.Find("tests.even");
+		ASSERT_NE(stage, nullptr);
+		EXPECT_EQ(stage->lefts, 2000u);
+		EXPECT_EQ(stage->rights, 2000u);
+
+		Trace::Reset();
+		EXPECT_EQ(Trace::Snapshot().Find("tests.even")->Calls(), 0u);
+	}
+
+	TEST(TraceTests, WritesSnapshots)
+	{
+		TraceSnapshot snapshot;
+		snapshot.stages.push_back({ "load", 1, 999, {} });
+		snapshot.stages[0].latency[4] = 1000;
+
+		EXPECT_EQ(snapshot.ToText(), "load calls=1000 lefts=1 left_rate=0.0010 p50<=16 p99<=16\n");
+		EXPECT_NE(snapshot.ToJson().find("{\"name\":\"load\",\"lefts\":1,\"rights\":999,\"latency\":[0,0,0,0,1000,0"), std::string::npos);
+		EXPECT_NE(snapshot.ToHints().find("#define LIBMONAD_LEFT_HINT [[unlikely]]"), std::string::npos);
+
+		snapshot.stages[0].lefts = 500;
+		EXPECT_EQ(snapshot.ToHints().find("#define"), std::string::npos);
+	}
+}
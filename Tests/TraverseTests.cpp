@@ -0,0 +1,138 @@
+#include "pch.h"
+
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "../lib/Traverse.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	using Result = Either<std::string, long>;
+
+	// Fails, with a message naming the number, for multiples of failEvery
+	auto FailMultiplesOf(const long failEvery)
+	{
+		return [failEvery](const long l) { return l % failEvery == 0 ? Result("bad " + std::to_string(l)) : Result(l * 2); };
+	}
+
+	std::vector<long> Numbers(const long from, const long count)
+	{
+		std::vector<long> numbers(count);
+		std::iota(numbers.begin(), numbers.end(), from);
+		return numbers;
+	}
+
+	TEST(TraverseTests, CollectsRightValuesInOrder)
+	{
+		const auto result = Traverse(Numbers(1, 5), FailMultiplesOf(100));
+
+		EXPECT_EQ(result, (Either<std::string, std::vector<long>>(std::vector<long>{ 2, 4, 6, 8, 10 })));
+	}
+
+	TEST(TraverseTests, StopsAtFirstLeft)
+	{
+		int calls = 0;
+		const auto result = Traverse(Numbers(1, 100), [&](const long l) { calls++; return FailMultiplesOf(7)(l); });
+
+		EXPECT_EQ(result, (Either<std::string, std::vector<long>>(std::string("bad 7"))));
+		EXPECT_EQ(calls, 7);
+	}
+
+	TEST(TraverseTests, OptionStopsAtFirstNone)
+	{
+		auto halve = [](const int i) { return i % 2 == 0 ? Option<int>(i / 2) : Option<int>(); };
+
+		EXPECT_EQ(Traverse(std::vector<int>{ 2, 4, 6 }, halve), Option<std::vector<int>>(std::vector<int>{ 1, 2, 3 }));
+		EXPECT_TRUE(Traverse(std::vector<int>{ 2, 3, 6 }, halve).IsNone());
+	}
+
+	TEST(TraverseTests, SequenceMovesOutOfRvalueRange)
+	{
+		std::vector<Either<int, std::unique_ptr<int>>> eithers;
+		for(int i = 0; i < 3; i++) { eithers.emplace_back(std::make_unique<int>(i)); }
+
+		auto result = Sequence(std::move(eithers)).ThrowIfLeft();
+
+		ASSERT_EQ(result.size(), 3);
+		EXPECT_EQ(*result[2], 2);
+	}
+
+	TEST(TraverseTests, SequenceOfOptions)
+	{
+		const std::vector<Option<int>> some = { 1, 2, 3 };
+		const std::vector<Option<int>> withNone = { 1, None(), 3 };
+
+		EXPECT_EQ(Sequence(some), Option<std::vector<int>>(std::vector<int>{ 1, 2, 3 }));
+		EXPECT_TRUE(Sequence(withNone).IsNone());
+	}
+
+	TEST(ParallelTraverseTests, MatchesSequential)
+	{
+		ThreadPool pool(4);
+		const auto numbers = Numbers(1, 10000);
+
+		for(const std::size_t chunkSize : { 0, 1, 7, 10000 })
+		{
+			EXPECT_EQ(Traverse(pool, numbers, FailMultiplesOf(100000), chunkSize), Traverse(numbers, FailMultiplesOf(100000)));
+		}
+	}
+
+	TEST(ParallelTraverseTests, LowestIndexLeftWins)
+	{
+		ThreadPool pool(8);
+		const auto numbers = Numbers(1, 20000);
+
+		// Every chunk but the first holds a left, and later ones are quicker to find theirs
+		for(int run = 0; run < 20; run++)
+		{
+			const auto result = Traverse(pool, numbers, [](const long l) { return l % 997 == 0 ? Result("bad " + std::to_string(l)) : Result(l); }, 500);
+
+			EXPECT_EQ(result, (Either<std::string, std::vector<long>>(std::string("bad 997"))));
+		}
+	}
+
+	TEST(ParallelTraverseTests, EarlyLeftCancelsLaterElements)
+	{
+		ThreadPool pool(4);
+		std::atomic<long> calls = 0;
+		const auto result = Traverse(pool, Numbers(0, 1000000), [&](const long l)
+		{
+			calls++;
+			return l == 10 ? Result(std::string("stop")) : Result(l);
+		}, 100);
+
+		EXPECT_EQ(result, (Either<std::string, std::vector<long>>(std::string("stop"))));
+		EXPECT_LT(calls.load(), 1000000 / 2);
+	}
+
+	TEST(ParallelTraverseTests, SequenceOfOptions)
+	{
+		ThreadPool pool(3);
+		std::vector<Option<int>> options(5000, Option<int>(1));
+
+		EXPECT_EQ(Sequence(pool, options), Option<std::vector<int>>(std::vector<int>(5000, 1)));
+
+		options[4321] = None();
+		EXPECT_TRUE(Sequence(pool, options).IsNone());
+	}
+
+	TEST(ParallelTraverseTests, EmptyRange)
+	{
+		ThreadPool pool(2);
+
+		EXPECT_EQ(Traverse(pool, std::vector<long>(), FailMultiplesOf(3)), (Either<std::string, std::vector<long>>(std::vector<long>())));
+	}
+
+#if LIBMONAD_ERROR_POLICY == LIBMONAD_ERROR_POLICY_THROW
+	TEST(ParallelTraverseTests, RethrowsOnCallingThread)
+	{
+		ThreadPool pool(2);
+
+		EXPECT_THROW(Traverse(pool, Numbers(0, 1000), [](const long l) { if(l == 500) { throw std::runtime_error("500"); } return Result(l); }, 10), std::runtime_error);
+	}
+#endif
+}
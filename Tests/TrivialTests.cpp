@@ -0,0 +1,135 @@
+#include "pch.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../lib/Error.h"
+#include "../lib/Either.h"
+#include "../lib/Option.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	// Copies trivially, but is not trivially destructible
+	struct Logged
+	{
+		~Logged() {}
+		int value;
+	};
+
+	// Copying is user provided, moving is trivial
+	struct CopyCounted
+	{
+		CopyCounted() = default;
+		CopyCounted(const CopyCounted& other) : value(other.value) {}
+		CopyCounted(CopyCounted&&) = default;
+		CopyCounted& operator=(const CopyCounted& other) { value = other.value; return *this; }
+		CopyCounted& operator=(CopyCounted&&) = default;
+		int value = 0;
+	};
+
+	/**
+	 * \brief Whether copying, moving and destroying T are each trivial, as a list of five flags
+	 */
+	template <typename T>
+	constexpr bool Trivial[5] = {
+		std::is_trivially_copy_constructible_v<T>, std::is_trivially_move_constructible_v<T>,
+		std::is_trivially_copy_assignable_v<T>, std::is_trivially_move_assignable_v<T>, std::is_trivially_destructible_v<T> };
+
+	template <typename A, typename B>
+	constexpr bool SameTriviality()
+	{
+		for(auto i = 0; i < 5; i++) { if(Trivial<A>[i] != Trivial<B>[i]) { return false; } }
+		return true;
+	}
+
+	static_assert(std::is_trivially_copyable_v<None>);
+
+	// Trivially copyable whenever the values are
+	static_assert(std::is_trivially_copyable_v<Either<int, float>>);
+	static_assert(std::is_trivially_copyable_v<Either<int, long>>);
+	static_assert(std::is_trivially_copyable_v<Either<None, double>>);
+	static_assert(std::is_trivially_copyable_v<Either<Error, long>>);
+	static_assert(std::is_trivially_copyable_v<Either<int, long&>>);
+	static_assert(std::is_trivially_copyable_v<Option<int>>);
+	static_assert(std::is_trivially_copyable_v<Option<double>>);
+	static_assert(std::is_trivially_copyable_v<Option<int*>>);
+	static_assert(std::is_trivially_copyable_v<Option<const std::string&>>);
+	static_assert(std::is_trivially_copyable_v<Option<Either<int, float>>>);
+	static_assert(std::is_trivially_copyable_v<Either<int, Option<float>>>);
+
+	// And not when either value is not
+	static_assert(!std::is_trivially_copyable_v<Either<int, std::string>>);
+	static_assert(!std::is_trivially_copyable_v<Either<std::string, int>>);
+	static_assert(!std::is_trivially_copyable_v<Option<std::string>>);
+	static_assert(!std::is_trivially_copyable_v<Option<std::unique_ptr<int>>>);
+
+	// Each of copying, moving and destroying is trivial exactly when it is for the value
+	static_assert(SameTriviality<Option<CopyCounted>, CopyCounted>());
+	static_assert(SameTriviality<Either<CopyCounted, int>, CopyCounted>());
+	static_assert(SameTriviality<Either<int, std::string>, std::string>());
+
+	// Except that none is trivial when destroying the value is not, though it can still be copied
+	static_assert(!std::is_trivially_destructible_v<Either<int, Logged>> && !std::is_trivially_copy_constructible_v<Either<int, Logged>>);
+	static_assert(std::is_copy_constructible_v<Either<int, Logged>> && std::is_copy_assignable_v<Either<int, Logged>>);
+	static_assert(!std::is_trivially_destructible_v<Option<Logged>> && std::is_copy_constructible_v<Option<Logged>>);
+
+	// Still usable at compile time
+	constexpr bool AssignsAcrossStates()
+	{
+		Either<int, float> either = 1;
+		either = Either<int, float>(2.5f);
+		return either.IsRight() && either.ThrowIfLeft() == 2.5f;
+	}
+	static_assert(AssignsAcrossStates());
+
+	TEST(TrivialTests, AssignmentSwitchesHeldValue)
+	{
+		Either<int, float> either = 3;
+		const Either<int, float> right = 1.5f;
+
+		either = right;
+		EXPECT_EQ(either, right);
+
+		either = Either<int, float>(4);
+		EXPECT_EQ(either, (Either<int, float>(4)));
+
+		Option<int> option = 5;
+		option = None();
+		EXPECT_EQ(option, None());
+	}
+
+	TEST(TrivialTests, VectorGrowthKeepsValues)
+	{
+		std::vector<Either<int, float>> eithers;
+		std::vector<Option<double>> options;
+		for(auto i = 0; i < 1000; i++)
+		{
+			eithers.push_back(i % 3 == 0 ? Either<int, float>(i) : Either<int, float>(static_cast<float>(i)));
+			options.push_back(i % 3 == 0 ? Option<double>() : Option<double>(i));
+		}
+		const auto copied = eithers;
+
+		for(auto i = 0; i < 1000; i++)
+		{
+			EXPECT_EQ(copied[i].IsLeft(), i % 3 == 0);
+			EXPECT_EQ(options[i].IsNone(), i % 3 == 0);
+		}
+		EXPECT_EQ(copied[7], (Either<int, float>(7.0f)));
+	}
+
+	TEST(TrivialTests, CopiesAsBytes)
+	{
+		const Either<int, float> eithers[2] = { 7, 0.5f };
+		unsigned char buffer[sizeof(eithers)];
+		std::memcpy(buffer, eithers, sizeof(eithers));
+
+		Either<int, float> copied[2];
+		std::memcpy(copied, buffer, sizeof(copied));
+
+		EXPECT_EQ(copied[0], eithers[0]);
+		EXPECT_EQ(copied[1], eithers[1]);
+	}
+}
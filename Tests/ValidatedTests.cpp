@@ -0,0 +1,108 @@
+#include "pch.h"
+
+#include <memory>
+#include <string>
+
+#include "../lib/Error.h"
+#include "../lib/Validated.h"
+using namespace libmonad;
+
+namespace Tests
+{
+	const ErrorCode TooShort = RegisterError("too short");
+	const ErrorCode OutOfRange = RegisterError("out of range");
+
+	struct Signup
+	{
+		std::string name;
+		long age;
+		long score;
+	};
+
+	Validated<Error, std::string> CheckName(const std::string& name)
+	{
+		if(name.size() < 2) { return Error(TooShort, "name"); }
+		return name;
+	}
+
+	Validated<Error, long> CheckRange(const long value, const long low, const long high, const std::string_view field)
+	{
+		if(value < low || value > high) { return Error(OutOfRange, field); }
+		return value;
+	}
+
+	Validated<Error, Signup> CheckSignup(const std::string& name, const long age, const long score)
+	{
+		return Combine([](const std::string& n, const long a, const long s) { return Signup{ n, a, s }; },
+			CheckName(name), CheckRange(age, 18, 130, "age"), CheckRange(score, 0, 100, "score"));
+	}
+
+	TEST(SmallVectorTests, SpillsToHeapPastInlineCapacity)
+	{
+		SmallVector<std::string, 2> strings = { "a", "b" };
+		EXPECT_TRUE(strings.IsInline());
+
+		strings.PushBack(strings[0]);
+		strings.EmplaceBack(3, 'c');
+		EXPECT_FALSE(strings.IsInline());
+		EXPECT_EQ(strings.Size(), 4);
+		EXPECT_EQ(strings[2], "a");
+		EXPECT_EQ(strings[3], "ccc");
+
+		auto moved = std::move(strings);
+		EXPECT_EQ(strings.Size(), 0);
+		EXPECT_TRUE(strings.IsInline());
+		EXPECT_EQ(moved.Size(), 4);
+
+		SmallVector<std::string, 2> copied;
+		copied = moved;
+		EXPECT_EQ(copied, moved);
+	}
+
+	TEST(SmallVectorTests, MovesInlineElements)
+	{
+		SmallVector<std::unique_ptr<int>, 4> pointers;
+		pointers.EmplaceBack(std::make_unique<int>(7));
+
+		const auto moved = std::move(pointers);
+		EXPECT_TRUE(moved.IsInline());
+		EXPECT_EQ(*moved[0], 7);
+		EXPECT_TRUE(pointers.Empty());
+	}
+
+	TEST(ValidatedTests, CombinesValidValues)
+	{
+		const auto signup = CheckSignup("Ada", 36, 99);
+
+		EXPECT_TRUE(signup.IsValid());
+		EXPECT_TRUE(signup.Errors().Empty());
+		EXPECT_EQ(signup.ThrowIfInvalid().name, "Ada");
+		EXPECT_EQ(signup.Map([](const Signup& s) { return s.age + s.score; }).ThrowIfInvalid(), 135);
+	}
+
+	TEST(ValidatedTests, AccumulatesEveryError)
+	{
+		const auto signup = CheckSignup("A", 12, 101);
+
+		ASSERT_TRUE(signup.IsInvalid());
+		ASSERT_EQ(signup.Errors().Size(), 3);
+		EXPECT_EQ(signup.Errors()[0], Error(TooShort, "name"));
+		EXPECT_EQ(signup.Errors()[1], Error(OutOfRange, "age"));
+		EXPECT_EQ(signup.Errors()[2], Error(OutOfRange, "score"));
+		EXPECT_TRUE(signup.Errors().IsInline());
+
+		const auto oneBad = CheckSignup("Ada", 36, -1);
+		EXPECT_EQ(oneBad.Match([](const auto& errors) { return errors.Size(); }, [](const Signup&) { return std::size_t(0); }), 1);
+	}
+
+	TEST(ValidatedTests, ConvertsToAndFromEither)
+	{
+		const Validated<Error, long> fromRight{ ErrorOr<long>(5L) };
+		const Validated<Error, long> fromLeft{ ErrorOr<long>(Error(OutOfRange)) };
+
+		EXPECT_EQ(fromRight, (Validated<Error, long>(5L)));
+		EXPECT_EQ(fromLeft.Errors()[0], Error(OutOfRange));
+		EXPECT_EQ(fromRight.ToEither(), (Either<SmallVector<Error, 4>, long>(5L)));
+		EXPECT_TRUE(fromLeft.ToEither().IsLeft());
+	}
+}
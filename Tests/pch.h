@@ -5,3 +5,17 @@
 #pragma once
 
 #include "gtest/gtest.h"
+#include "../lib/ErrorPolicy.h"
+
+// What using a bottom either, or extracting a value that is not there, does depends on the error policy the tests are built with.
+// EXPECT_MONAD_ERROR expects the statement to throw, or to abort with the message. Under the unchecked policy the statement is not run.
+#if LIBMONAD_ERROR_POLICY == LIBMONAD_ERROR_POLICY_THROW
+#define EXPECT_MONAD_ERROR(statement, message) EXPECT_THROW(statement, std::exception)
+#define EXPECT_NO_MONAD_ERROR(statement) EXPECT_NO_THROW(statement)
+#elif LIBMONAD_ERRORS_CHECKED
+#define EXPECT_MONAD_ERROR(statement, message) EXPECT_DEATH(statement, message)
+#define EXPECT_NO_MONAD_ERROR(statement) statement
+#else
+#define EXPECT_MONAD_ERROR(statement, message) static_cast<void>(0)
+#define EXPECT_NO_MONAD_ERROR(statement) statement
+#endif
@@ -0,0 +1,613 @@
+#pragma once
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "Either.h"
+#include "ErrorPolicy.h"
+#include "Executor.h"
+#include "Option.h"
+
+namespace libmonad
+{
+	template <typename T>
+	class Async;
+
+	template <typename T>
+	class AsyncPromise;
+
+	/**
+	 * \brief An Either<L, R> that arrives later
+	 */
+	template <typename L, typename R>
+	using AsyncEither = Async<Either<L, R>>;
+
+	/**
+	 * \brief An Option<T> that arrives later
+	 */
+	template <typename T>
+	using AsyncOption = Async<Option<T>>;
+
+	template <typename L, typename R>
+	using EitherPromise = AsyncPromise<Either<L, R>>;
+
+	template <typename T>
+	using OptionPromise = AsyncPromise<Option<T>>;
+
+	template <typename T>
+	struct IsAsync : std::false_type {};
+
+	template <typename T>
+	struct IsAsync<Async<T>> : std::true_type {};
+
+	/**
+	 * \brief What a Bind stage's result stands for: T itself, or the Either (or Option) an Async<T> holds
+	 */
+	template <typename T>
+	struct AsyncResult { using Type = T; };
+
+	template <typename T>
+	struct AsyncResult<Async<T>> { using Type = T; };
+
+	namespace detail
+	{
+		/**
+		 * \brief Whether Out is an Either with the left type L
+		 */
+		template <typename Out, typename L>
+		struct KeepsLeft : std::false_type {};
+
+		template <typename L, typename R>
+		struct KeepsLeft<Either<L, R>, L> : std::true_type {};
+
+		/**
+		 * \brief What an Async needs to know about the Either or Option it holds
+		 */
+		template <typename T>
+		struct AsyncTraits;
+
+		template <typename L, typename R>
+		struct AsyncTraits<Either<L, R>>
+		{
+			using Value = R;
+
+			template <typename U>
+			using Mapped = MappedEither<L, U>;
+
+			// What a stage may produce from it: an Either with the same left type, which a left value is passed on as
+			template <typename Out>
+			static constexpr bool Continues = KeepsLeft<Out, L>::value;
+
+			static bool HasValue(const Either<L, R>& either) { return either.IsRight(); }
+			static R TakeValue(Either<L, R>&& either) { return std::move(either).ThrowIfLeft(); }
+
+			template <typename Out>
+			static Out PassOnFailure(Either<L, R>&& either)
+			{
+				return std::move(either).Match([](L&& left) { return Out(inPlaceLeft, std::move(left)); }, [](R&&) { return Out(); });
+			}
+		};
+
+		template <typename T>
+		struct AsyncTraits<Option<T>>
+		{
+			using Value = T;
+
+			template <typename U>
+			using Mapped = MappedOption<U>;
+
+			template <typename Out>
+			static constexpr bool Continues = IsOption<Out>::value;
+
+			static bool HasValue(const Option<T>& option) { return option.IsSome(); }
+			static T TakeValue(Option<T>&& option) { return std::move(option).ThrowIfNone(); }
+
+			template <typename Out>
+			static Out PassOnFailure(Option<T>&&) { return Out(); }
+		};
+
+		/**
+		 * \brief Called on the completing thread once the value it waits for has arrived
+		 */
+		struct Continuation
+		{
+			void (*ready)(Continuation& continuation);
+		};
+
+		// Stand in for a continuation to say the value has arrived, or that a thread is blocked waiting for it
+		inline Continuation readyTag{ nullptr };
+		inline Continuation waitingTag{ nullptr };
+
+		/**
+		 * \brief The value an Async and its promise share, and the one continuation waiting for it. Attaching the continuation and
+		 * completing both swap a single pointer, so whichever comes second runs the continuation, and neither takes a lock. The
+		 * continuation posts its stage to the executor, which takes no lock either for the WorkStealingExecutor.
+		 * \tparam T Either<L, R> or Option<T>
+		 */
+		template <typename T>
+		class AsyncState
+		{
+		public:
+			explicit AsyncState(Executor& executor) : executor(executor) {}
+			virtual ~AsyncState() = default;
+
+			AsyncState(const AsyncState&) = delete;
+			AsyncState& operator=(const AsyncState&) = delete;
+
+			void AddRef() { references.fetch_add(1, std::memory_order_relaxed); }
+			void Release() { if(references.fetch_sub(1, std::memory_order_acq_rel) == 1) { delete this; } }
+
+			/**
+			 * \brief Stores the value, then runs the continuation on this thread if one is attached
+			 */
+			void Complete(T result)
+			{
+				value = std::move(result);
+				Publish();
+			}
+
+#ifndef LIBMONAD_NO_EXCEPTIONS
+			/**
+			 * \brief Stores the exception a stage threw in place of a value, then runs the continuation on this thread if one is attached
+			 */
+			void CompleteWithException(std::exception_ptr thrown)
+			{
+				exception = std::move(thrown);
+				Publish();
+			}
+
+			/**
+			 * \brief The exception a stage threw in place of a value, if it did
+			 */
+			const std::exception_ptr& Exception() const { return exception; }
+#endif
+
+			/**
+			 * \brief Attaches the continuation, or runs it on this thread if the value has already arrived
+			 */
+			void Then(Continuation& next)
+			{
+				Continuation* expected = nullptr;
+				if(!continuation.compare_exchange_strong(expected, &next, std::memory_order_acq_rel, std::memory_order_acquire)) { next.ready(next); }
+			}
+
+			/**
+			 * \brief Blocks until the value has arrived
+			 */
+			void Wait()
+			{
+				Continuation* expected = nullptr;
+				if(continuation.compare_exchange_strong(expected, &waitingTag, std::memory_order_acq_rel, std::memory_order_acquire)) { expected = &waitingTag; }
+				while(expected != &readyTag)
+				{
+					continuation.wait(expected, std::memory_order_acquire);
+					expected = continuation.load(std::memory_order_acquire);
+				}
+			}
+
+			bool IsReady() const { return continuation.load(std::memory_order_acquire) == &readyTag; }
+
+			T& Value() { return value; }
+
+			Executor& executor;
+
+		private:
+			void Publish()
+			{
+				const auto previous = continuation.exchange(&readyTag, std::memory_order_acq_rel);
+				if(previous == &waitingTag) { continuation.notify_all(); }
+				else if(previous != nullptr) { previous->ready(*previous); }
+			}
+
+			std::atomic<std::size_t> references{1};
+			std::atomic<Continuation*> continuation{nullptr};
+			T value;
+#ifndef LIBMONAD_NO_EXCEPTIONS
+			std::exception_ptr exception;
+#endif
+		};
+
+		/**
+		 * \brief A Map or Bind stage: the state of its own result, and the continuation waiting for its input.
+		 * An input with a value schedules the transformation on the executor. A left value or none is passed straight on,
+		 * on the thread that completed the input, so the stages after it are never scheduled either. A transformation that throws
+		 * completes the stage with the exception, which is passed on the same way.
+		 */
+		template <typename In, typename Out, typename F>
+		class Stage final : public AsyncState<Out>, Continuation, Work
+		{
+		public:
+			Stage(AsyncState<In>* source, F transform)
+				: AsyncState<Out>(source->executor), Continuation{ &SourceReady }, Work{ &Run }, source(source), transform(std::move(transform)) {}
+
+			/**
+			 * \brief Waits for the input, holding a reference to the stage until it has completed
+			 */
+			void Attach()
+			{
+				this->AddRef();
+				source->Then(*this);
+			}
+
+		private:
+			using Result = std::decay_t<std::invoke_result_t<F&, typename AsyncTraits<In>::Value&&>>;
+
+			static void SourceReady(Continuation& continuation)
+			{
+				auto& self = static_cast<Stage&>(continuation);
+#ifndef LIBMONAD_NO_EXCEPTIONS
+				if(self.source->Exception())
+				{
+					self.FinishWithException(self.source->Exception());
+					return;
+				}
+#endif
+				if(AsyncTraits<In>::HasValue(self.source->Value())) { self.executor.Post(self); }
+				else { self.Finish(AsyncTraits<In>::template PassOnFailure<Out>(std::move(self.source->Value()))); }
+			}
+
+			static void Run(Work& work)
+			{
+				auto& self = static_cast<Stage&>(work);
+#ifdef LIBMONAD_NO_EXCEPTIONS
+				self.Continue(self.Transform());
+#else
+				// Only the transformation is guarded: once the stage has completed, it may already have been freed
+				std::optional<Result> result;
+				try { result.emplace(self.Transform()); }
+				catch(...)
+				{
+					self.FinishWithException(std::current_exception());
+					return;
+				}
+				self.Continue(std::move(*result));
+#endif
+			}
+
+			Result Transform() { return std::invoke(transform, AsyncTraits<In>::TakeValue(std::move(source->Value()))); }
+
+			void Continue(Result&& result)
+			{
+				if constexpr (IsAsync<Result>::value)
+				{
+					// An asynchronous stage completes this one when its own value arrives
+					std::exchange(source, nullptr)->Release();
+					inner = result.Detach();
+					Continuation::ready = &InnerReady;
+					inner->Then(*this);
+				}
+				else
+				{
+					Finish(Out(std::move(result)));
+				}
+			}
+
+			static void InnerReady(Continuation& continuation)
+			{
+				auto& self = static_cast<Stage&>(continuation);
+#ifndef LIBMONAD_NO_EXCEPTIONS
+				if(self.inner->Exception())
+				{
+					self.FinishWithException(self.inner->Exception());
+					return;
+				}
+#endif
+				self.Finish(std::move(self.inner->Value()));
+			}
+
+			void Finish(Out result)
+			{
+				ReleaseInputs();
+				this->Complete(std::move(result));
+				this->Release();
+			}
+
+#ifndef LIBMONAD_NO_EXCEPTIONS
+			void FinishWithException(std::exception_ptr thrown)
+			{
+				ReleaseInputs();
+				this->CompleteWithException(std::move(thrown));
+				this->Release();
+			}
+#endif
+
+			void ReleaseInputs()
+			{
+				if(source) { std::exchange(source, nullptr)->Release(); }
+				if(inner) { std::exchange(inner, nullptr)->Release(); }
+			}
+
+			AsyncState<In>* source;
+			AsyncState<Out>* inner = nullptr;
+			F transform;
+		};
+
+		/**
+		 * \brief What a Match given no action for exceptions does with one a stage threw: reports it through the error policy
+		 */
+		struct ReportThrown
+		{
+			void operator()(std::exception_ptr) const { Fail("a stage before an Async Match threw, and the Match was given no action for it"); }
+		};
+
+		/**
+		 * \brief A Match: the continuation waiting for the input, and the work that calls one of the actions with it
+		 */
+		template <typename In, typename FF, typename FV, typename FE>
+		class Matcher final : Continuation, Work
+		{
+		public:
+			Matcher(AsyncState<In>* source, FF ifFailure, FV ifValue, FE ifThrown)
+				: Continuation{ &SourceReady }, Work{ &Run }, source(source), ifFailure(std::move(ifFailure)), ifValue(std::move(ifValue)),
+				ifThrown(std::move(ifThrown)) {}
+
+			void Attach() { source->Then(*this); }
+
+		private:
+			static void SourceReady(Continuation& continuation)
+			{
+				auto& self = static_cast<Matcher&>(continuation);
+				self.source->executor.Post(self);
+			}
+
+			static void Run(Work& work)
+			{
+				auto& self = static_cast<Matcher&>(work);
+#ifdef LIBMONAD_NO_EXCEPTIONS
+				std::move(self.source->Value()).Match(std::move(self.ifFailure), std::move(self.ifValue));
+#else
+				if(self.source->Exception()) { std::invoke(std::move(self.ifThrown), self.source->Exception()); }
+				else { std::move(self.source->Value()).Match(std::move(self.ifFailure), std::move(self.ifValue)); }
+#endif
+				self.source->Release();
+				delete &self;
+			}
+
+			AsyncState<In>* source;
+			FF ifFailure;
+			FV ifValue;
+			FE ifThrown;
+		};
+	}
+
+	/**
+	 * \brief An Either or an Option that arrives later, from an AsyncPromise. Map, Bind and Match attach continuations that run
+	 * on the executor once it arrives, and may be attached before or after it does. Each Async has one consumer:
+	 * Map, Bind, Match and Get take it over, so call them on an rvalue, eg. std::move(pending).Map(f). A Map or Bind transformation
+	 * that throws skips the stages after it, and Get rethrows what it threw, or Match hands it to its third action.
+	 * \tparam T Either<L, R> or Option<T>
+	 */
+	template <typename T>
+	class Async
+	{
+		static_assert(IsEither<T>::value || IsOption<T>::value, "Async holds an Either or an Option");
+		using Traits = detail::AsyncTraits<T>;
+
+	public:
+		using ResultType = T;
+
+		Async(Async&& other) noexcept : state(other.Detach()) {}
+		Async& operator=(Async&& other) noexcept
+		{
+			if(this != &other)
+			{
+				if(state) { state->Release(); }
+				state = other.Detach();
+			}
+			return *this;
+		}
+		~Async() { if(state) { state->Release(); } }
+
+		/**
+		 * \brief An Async whose value has already arrived
+		 * \param value the value
+		 * \param executor executor its stages run on
+		 */
+		static Async Ready(T value, Executor& executor = DefaultExecutor());
+
+		/**
+		 * \brief Whether the value has arrived
+		 */
+		bool IsReady() const { return state && state->IsReady(); }
+
+		/**
+		 * \brief Transforms the right value (or value) once it arrives, on the executor. A left value (or none) is passed on without scheduling anything.
+		 * \tparam F transformation function that takes the value and returns a plain value, or an Either (or Option) to flatten
+		 * \param transform transformation function
+		 * \return Async of the transformed result
+		 */
+		template <typename F>
+		auto Map(F&& transform) &&
+		{
+			using U = std::decay_t<std::invoke_result_t<std::decay_t<F>&, typename Traits::Value&&>>;
+			static_assert(Traits::template Continues<typename Traits::template Mapped<U>>, "Map transformation must keep the left type");
+			return std::move(*this).template Then<typename Traits::template Mapped<U>>(std::forward<F>(transform));
+		}
+
+		/**
+		 * \brief Transforms the right value (or value) once it arrives, on the executor, into an Either (or Option) that may arrive later itself.
+		 * A left value (or none) is passed on without scheduling anything.
+		 * \tparam F transformation function that takes the value and returns an Either (or Option), or an Async of one
+		 * \param transform transformation function
+		 * \return Async of the transformed result
+		 */
+		template <typename F>
+		auto Bind(F&& transform) &&
+		{
+			using Result = std::decay_t<std::invoke_result_t<std::decay_t<F>&, typename Traits::Value&&>>;
+			static_assert(IsEither<Result>::value || IsOption<Result>::value || IsAsync<Result>::value,
+				"Bind transformation must return an Either, an Option or an Async of one, use Map to return a plain value");
+			static_assert(Traits::template Continues<typename AsyncResult<Result>::Type>,
+				"Bind transformation must return what it is given: an Either with the same left type, or an Option");
+			return std::move(*this).template Then<typename AsyncResult<Result>::Type>(std::forward<F>(transform));
+		}
+
+		/**
+		 * \brief Once the value arrives, performs one of the actions with it on the executor. Neither action may throw. If a stage
+		 * before it threw, the exception is reported through the error policy, as nothing else could be handed it: to receive it,
+		 * give Match an action for it too, or use Get.
+		 * \param ifFailure action to perform with a left value (or none)
+		 * \param ifValue action to perform with a right value (or value)
+		 */
+		template <typename FF, typename FV>
+		void Match(FF&& ifFailure, FV&& ifValue) &&
+		{
+			std::move(*this).Match(std::forward<FF>(ifFailure), std::forward<FV>(ifValue), detail::ReportThrown{});
+		}
+
+		/**
+		 * \brief Once the value arrives, performs one of the actions with it on the executor, or with what a stage before it threw
+		 * \param ifFailure action to perform with a left value (or none)
+		 * \param ifValue action to perform with a right value (or value)
+		 * \param ifThrown action to perform with the std::exception_ptr a stage threw
+		 */
+		template <typename FF, typename FV, typename FE>
+		void Match(FF&& ifFailure, FV&& ifValue, FE&& ifThrown) &&
+		{
+			CheckState();
+			auto* matcher = new detail::Matcher<T, std::decay_t<FF>, std::decay_t<FV>, std::decay_t<FE>>(
+				Detach(), std::forward<FF>(ifFailure), std::forward<FV>(ifValue), std::forward<FE>(ifThrown));
+			matcher->Attach();
+		}
+
+		/**
+		 * \brief Blocks until the value arrives, rethrowing what a stage threw instead
+		 * \return the value
+		 */
+		T Get() &&
+		{
+			CheckState();
+			state->Wait();
+#ifndef LIBMONAD_NO_EXCEPTIONS
+			if(const auto thrown = state->Exception())
+			{
+				Detach()->Release();
+				std::rethrow_exception(thrown);
+			}
+#endif
+			T result = std::move(state->Value());
+			Detach()->Release();
+			return result;
+		}
+
+	private:
+		friend class AsyncPromise<T>;
+
+		template <typename In, typename Out, typename F>
+		friend class detail::Stage;
+
+		template <typename U>
+		friend class Async;
+
+		explicit Async(detail::AsyncState<T>* state) : state(state) {}
+
+		detail::AsyncState<T>* Detach() { return std::exchange(state, nullptr); }
+
+		void CheckState() const
+		{
+			if constexpr (ErrorsChecked)
+			{
+				if(!state) { Fail("Async has been moved from"); }
+			}
+		}
+
+		template <typename Out, typename F>
+		Async<Out> Then(F&& transform) &&
+		{
+			CheckState();
+			auto* stage = new detail::Stage<T, Out, std::decay_t<F>>(Detach(), std::forward<F>(transform));
+			stage->Attach();
+			return Async<Out>(stage);
+		}
+
+		detail::AsyncState<T>* state;
+	};
+
+	/**
+	 * \brief Where an Async's value comes from: whoever produces the value completes the promise, from any thread
+	 * \tparam T Either<L, R> or Option<T>
+	 */
+	template <typename T>
+	class AsyncPromise
+	{
+	public:
+		/**
+		 * \brief A promise whose stages run on the given executor
+		 * \param executor executor that runs Map, Bind and Match stages
+		 */
+		explicit AsyncPromise(Executor& executor = DefaultExecutor()) : state(new detail::AsyncState<T>(executor)) {}
+
+		AsyncPromise(AsyncPromise&& other) noexcept : state(std::exchange(other.state, nullptr)), retrieved(other.retrieved) {}
+		AsyncPromise& operator=(AsyncPromise&& other) noexcept
+		{
+			if(this != &other)
+			{
+				if(state) { state->Release(); }
+				state = std::exchange(other.state, nullptr);
+				retrieved = other.retrieved;
+			}
+			return *this;
+		}
+
+		/**
+		 * \brief A promise destroyed without completing breaks it, as std::promise does, so nothing waits for it forever: under
+		 * LIBMONAD_ERROR_POLICY_THROW its Async completes with a std::runtime_error that Get rethrows, and otherwise it is reported
+		 * through the error policy
+		 */
+		~AsyncPromise()
+		{
+			if(!state) { return; }
+#if LIBMONAD_ERROR_POLICY == LIBMONAD_ERROR_POLICY_THROW
+			const auto broken = std::exchange(state, nullptr);
+			broken->CompleteWithException(std::make_exception_ptr(std::runtime_error("AsyncPromise destroyed without completing")));
+			broken->Release();
+#else
+			Fail("AsyncPromise destroyed without completing");
+#endif
+		}
+
+		/**
+		 * \brief The Async the promise completes. Call it once, before completing.
+		 */
+		Async<T> GetAsync()
+		{
+			if constexpr (ErrorsChecked)
+			{
+				if(!state || retrieved) { Fail("GetAsync called twice, or after Complete"); }
+			}
+			retrieved = true;
+			state->AddRef();
+			return Async<T>(state);
+		}
+
+		/**
+		 * \brief Hands the value to the Async, running what waits for it. Call it once.
+		 * \param value the value
+		 */
+		void Complete(T value)
+		{
+			if constexpr (ErrorsChecked)
+			{
+				if(!state) { Fail("AsyncPromise completed twice"); }
+			}
+			const auto completed = std::exchange(state, nullptr);
+			completed->Complete(std::move(value));
+			completed->Release();
+		}
+
+	private:
+		detail::AsyncState<T>* state;
+		bool retrieved = false;
+	};
+
+	template <typename T>
+	Async<T> Async<T>::Ready(T value, Executor& executor)
+	{
+		auto* state = new detail::AsyncState<T>(executor);
+		state->Complete(std::move(value));
+		return Async<T>(state);
+	}
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Option.h"
+
+namespace libmonad
+{
+	namespace detail
+	{
+		// Kept apart so that the producer's and the consumer's own state never share a cache line
+		constexpr std::size_t CacheLine = 64;
+
+		/**
+		 * \brief Whether an AtomicOption<T> fits in one atomic word: the value is trivially copyable and leaves room for
+		 * a flag, or reserves a NoneSentinel of its own to mean empty
+		 */
+		template <typename T>
+		constexpr bool PacksIntoWord = std::is_trivially_copyable_v<T> && std::atomic<std::uint64_t>::is_always_lock_free &&
+			(sizeof(T) <= sizeof(std::uint32_t) || (NoneSentinel<T>::Enabled && sizeof(T) <= sizeof(std::uint64_t)));
+
+		/**
+		 * \brief Holds the value of an AtomicOption in one atomic word, its bits alongside a flag or, for a type with a
+		 * NoneSentinel, as they are. Every operation is a single load or exchange of the word, so it is safe between any
+		 * number of threads.
+		 * \tparam T type of value
+		 */
+		template <typename T, bool = PacksIntoWord<T>>
+		class AtomicOptionStorage
+		{
+		public:
+			static constexpr bool IsLockFree = true;
+
+			Option<T> Exchange(T value) { return Unpack(word.exchange(Pack(value), std::memory_order_acq_rel)); }
+
+			Option<T> TryTake()
+			{
+				// Only loads while empty, so a polling consumer does not take the cache line from the producer
+				if(word.load(std::memory_order_relaxed) == Empty()) { return None(); }
+				return Unpack(word.exchange(Empty(), std::memory_order_acq_rel));
+			}
+
+			bool HasValue() const { return word.load(std::memory_order_acquire) != Empty(); }
+
+		private:
+			static constexpr bool Flagged = !NoneSentinel<T>::Enabled;
+			static constexpr std::uint64_t Present = Flagged ? std::uint64_t(1) << 32 : 0;
+
+			static std::uint64_t Bits(const T& value)
+			{
+				std::uint64_t bits = 0;
+				std::memcpy(&bits, &value, sizeof(T));
+				return bits;
+			}
+
+			static std::uint64_t Empty()
+			{
+				if constexpr (Flagged) { return 0; }
+				else { return Bits(NoneSentinel<T>::Value()); }
+			}
+
+			static std::uint64_t Pack(const T& value) { return Bits(value) | Present; }
+
+			static Option<T> Unpack(const std::uint64_t bits)
+			{
+				if(bits == Empty()) { return None(); }
+				alignas(T) std::byte raw[sizeof(T)];
+				std::memcpy(raw, &bits, sizeof(T));
+				return *std::launder(reinterpret_cast<T*>(raw));
+			}
+
+			std::atomic<std::uint64_t> word{Empty()};
+		};
+
+		/**
+		 * \brief Holds the value of an AtomicOption that does not fit in a word in one of three buffers. The producer fills
+		 * its own buffer and swaps it for the shared one; the consumer swaps its own, emptied, buffer for the shared one when
+		 * that holds something new. Each side makes a single exchange of a byte and never waits for the other, but there
+		 * can only be one of each.
+		 * \tparam T type of value
+		 */
+		template <typename T>
+		class AtomicOptionStorage<T, false>
+		{
+		public:
+			static constexpr bool IsLockFree = std::atomic<std::uint8_t>::is_always_lock_free;
+
+			Option<T> Exchange(T value)
+			{
+				buffers[back].value = std::move(value);
+				const auto previous = shared.exchange(static_cast<std::uint8_t>(back | Fresh), std::memory_order_acq_rel);
+				back = previous & Index;
+
+				// A value the consumer never took comes back with the buffer, which must be left empty for the next one
+				if(previous & Fresh) { return std::exchange(buffers[back].value, Option<T>()); }
+				return None();
+			}
+
+			Option<T> TryTake()
+			{
+				// Only the consumer clears Fresh, so once seen it is still set when the buffers are swapped
+				if(!(shared.load(std::memory_order_relaxed) & Fresh)) { return None(); }
+				front = shared.exchange(front, std::memory_order_acq_rel) & Index;
+				return std::exchange(buffers[front].value, Option<T>());
+			}
+
+			bool HasValue() const { return (shared.load(std::memory_order_acquire) & Fresh) != 0; }
+
+		private:
+			static constexpr std::uint8_t Index = 3;
+			static constexpr std::uint8_t Fresh = 4;
+
+			struct alignas(CacheLine) Buffer
+			{
+				Option<T> value;
+			};
+
+			Buffer buffers[3];
+			alignas(CacheLine) std::atomic<std::uint8_t> shared{0};
+			alignas(CacheLine) std::uint8_t back = 1;
+			alignas(CacheLine) std::uint8_t front = 2;
+		};
+	}
+
+	/**
+	 * \brief A slot through which one thread hands the latest of its values to another without locking. Publishing
+	 * replaces any value not yet taken; taking leaves the slot empty. Values of four bytes or less, and values of up to
+	 * eight bytes that reserve a NoneSentinel, are kept in a single atomic word; anything else is handed over through
+	 * three buffers, which is lock-free for exactly one producer and one consumer.
+	 * \tparam T type of value
+	 */
+	template <typename T>
+	class AtomicOption
+	{
+	public:
+		/**
+		 * \brief Whether no operation ever waits on a lock
+		 */
+		static constexpr bool IsLockFree = detail::AtomicOptionStorage<T>::IsLockFree;
+
+		AtomicOption() = default;
+		AtomicOption(const AtomicOption&) = delete;
+		AtomicOption& operator=(const AtomicOption&) = delete;
+
+		/**
+		 * \brief Makes a value available to the consumer, with everything written before it. Producer only.
+		 */
+		void Publish(T value) { storage.Exchange(std::move(value)); }
+
+		/**
+		 * \brief Makes a value available to the consumer. Producer only.
+		 * \return the value it replaced if the consumer never took it, otherwise None
+		 */
+		Option<T> Exchange(T value) { return storage.Exchange(std::move(value)); }
+
+		/**
+		 * \brief Takes the latest value published, with everything written before it, leaving the slot empty. Consumer only.
+		 * \return the value, or None if nothing has been published since the last one was taken
+		 */
+		Option<T> TryTake() { return storage.TryTake(); }
+
+		/**
+		 * \brief Whether a value is waiting to be taken. Only a hint, as another thread may change that straight after.
+		 */
+		bool HasValue() const { return storage.HasValue(); }
+
+	private:
+		detail::AtomicOptionStorage<T> storage;
+	};
+}
@@ -0,0 +1,208 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace libmonad
+{
+	/**
+	 * \brief Bits packed 64 to a word that something else owns, eg. a ValidityBitmap or a mapped file, with the same scans.
+	 * Bits past the end must be clear.
+	 */
+	class BitmapView
+	{
+	public:
+		static constexpr std::size_t BitsPerWord = 64;
+
+		BitmapView() = default;
+
+		/**
+		 * \brief Views size bits packed into words
+		 * \param words (size + 63) / 64 words, lowest element in the lowest bit of the first word
+		 * \param size number of bits
+		 */
+		BitmapView(const std::uint64_t* words, const std::size_t size) : words(words), size(size) {}
+
+		/**
+		 * \brief Number of bits
+		 */
+		std::size_t Size() const { return size; }
+
+		/**
+		 * \brief Number of words the bits are packed into
+		 */
+		std::size_t WordCount() const { return (size + BitsPerWord - 1) / BitsPerWord; }
+
+		const std::uint64_t* Words() const { return words; }
+
+		/**
+		 * \brief Determines if bit i is set
+		 */
+		bool Test(const std::size_t i) const { return (words[i / BitsPerWord] >> (i % BitsPerWord)) & 1; }
+
+		/**
+		 * \brief Counts the set bits a word at a time
+		 * \return number of set bits
+		 */
+		std::size_t Count() const
+		{
+			std::size_t count = 0;
+			for(std::size_t w = 0; w < WordCount(); w++) { count += std::popcount(words[w]); }
+			return count;
+		}
+
+		/**
+		 * \brief Calls ifSet with the index of each set bit, in order. Clear words are skipped whole and full words are run without testing bits.
+		 * \param ifSet function taking the index of a set bit
+		 */
+		template <typename F>
+		void ForEachSet(F&& ifSet) const
+		{
+			for(std::size_t w = 0; w < WordCount(); w++)
+			{
+				auto word = words[w];
+				const auto base = w * BitsPerWord;
+				if(word == 0) { continue; }
+				if(word == ~std::uint64_t(0))
+				{
+					for(std::size_t i = base; i < base + BitsPerWord; i++) { ifSet(i); }
+					continue;
+				}
+				while(word != 0)
+				{
+					ifSet(base + std::countr_zero(word));
+					word &= word - 1;
+				}
+			}
+		}
+
+		/**
+		 * \brief Calls ifSet or ifClear with the index of every bit, in order
+		 * \param ifSet function taking the index of a set bit
+		 * \param ifClear function taking the index of a clear bit
+		 */
+		template <typename FS, typename FC>
+		void ForEach(FS&& ifSet, FC&& ifClear) const
+		{
+			for(std::size_t w = 0; w < WordCount(); w++)
+			{
+				const auto word = words[w];
+				const auto base = w * BitsPerWord;
+				const auto end = base + BitsPerWord < size ? base + BitsPerWord : size;
+				if(word == 0)
+				{
+					for(std::size_t i = base; i < end; i++) { ifClear(i); }
+				}
+				else if(word == ~std::uint64_t(0))
+				{
+					for(std::size_t i = base; i < end; i++) { ifSet(i); }
+				}
+				else
+				{
+					for(std::size_t i = base; i < end; i++)
+					{
+						if((word >> (i - base)) & 1) { ifSet(i); } else { ifClear(i); }
+					}
+				}
+			}
+		}
+
+	private:
+		const std::uint64_t* words = nullptr;
+		std::size_t size = 0;
+	};
+
+	/**
+	 * \brief One bit per element of a column, packed 64 to a word, saying whether the element holds a value (right or some).
+	 * Bits past the end of the column are always clear, so whole words can be counted and scanned.
+	 */
+	class ValidityBitmap
+	{
+	public:
+		static constexpr std::size_t BitsPerWord = 64;
+
+		ValidityBitmap() = default;
+
+		/**
+		 * \brief A bitmap of size bits, all set or all clear
+		 * \param size number of bits
+		 * \param set whether every bit starts set
+		 */
+		explicit ValidityBitmap(const std::size_t size, const bool set = false)
+			: words((size + BitsPerWord - 1) / BitsPerWord, set ? ~std::uint64_t(0) : 0), size(size)
+		{
+			ClearTail();
+		}
+
+		/**
+		 * \brief Number of bits
+		 */
+		std::size_t Size() const { return size; }
+
+		/**
+		 * \brief Determines if bit i is set
+		 */
+		bool Test(const std::size_t i) const { return (words[i / BitsPerWord] >> (i % BitsPerWord)) & 1; }
+
+		void Set(const std::size_t i) { words[i / BitsPerWord] |= std::uint64_t(1) << (i % BitsPerWord); }
+
+		void Reset(const std::size_t i) { words[i / BitsPerWord] &= ~(std::uint64_t(1) << (i % BitsPerWord)); }
+
+		/**
+		 * \brief Adds a bit to the end
+		 * \param set whether the new bit is set
+		 */
+		void PushBack(const bool set)
+		{
+			if(size % BitsPerWord == 0) { words.push_back(0); }
+			if(set) { Set(size); }
+			size++;
+		}
+
+		void Reserve(const std::size_t bits) { words.reserve((bits + BitsPerWord - 1) / BitsPerWord); }
+
+		/**
+		 * \brief Counts the set bits a word at a time
+		 * \return number of set bits
+		 */
+		std::size_t Count() const { return View().Count(); }
+
+		/**
+		 * \brief The packed words, lowest element in the lowest bit of the first word
+		 */
+		const std::vector<std::uint64_t>& Words() const { return words; }
+
+		/**
+		 * \brief Views the bits, eg. to scan them alongside bits that are not in a ValidityBitmap
+		 */
+		BitmapView View() const { return { words.data(), size }; }
+
+		/**
+		 * \brief Calls ifSet with the index of each set bit, in order. Clear words are skipped whole and full words are run without testing bits.
+		 * \param ifSet function taking the index of a set bit
+		 */
+		template <typename F>
+		void ForEachSet(F&& ifSet) const { View().ForEachSet(std::forward<F>(ifSet)); }
+
+		/**
+		 * \brief Calls ifSet or ifClear with the index of every bit, in order
+		 * \param ifSet function taking the index of a set bit
+		 * \param ifClear function taking the index of a clear bit
+		 */
+		template <typename FS, typename FC>
+		void ForEach(FS&& ifSet, FC&& ifClear) const { View().ForEach(std::forward<FS>(ifSet), std::forward<FC>(ifClear)); }
+
+		friend bool operator==(const ValidityBitmap& a, const ValidityBitmap& b) = default;
+
+	private:
+		void ClearTail()
+		{
+			if(size % BitsPerWord != 0) { words.back() &= (std::uint64_t(1) << (size % BitsPerWord)) - 1; }
+		}
+
+		std::vector<std::uint64_t> words;
+		std::size_t size = 0;
+	};
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+/*
+ * Which way combinators such as Map, Bind and Match tell the compiler an either or option usually goes.
+ * Define LIBMONAD_BRANCH_PROFILE to the path of a header written by TraceSnapshot::ToHints() (see lib/Trace.h), or pass it to
+ * the compiler as -DLIBMONAD_BRANCH_PROFILE="\"path\"" (CMake's LIBMONAD_BRANCH_PROFILE does this), to build with the hint a traced
+ * run calls for: [[unlikely]] on the left (or none) branch when lefts were rare, [[likely]] when they were common.
+ * LIBMONAD_LEFT_HINT can also be defined directly. Left undefined, there is no hint.
+ */
+#ifdef LIBMONAD_BRANCH_PROFILE
+#include LIBMONAD_BRANCH_PROFILE
+#endif
+
+#ifndef LIBMONAD_LEFT_HINT
+#define LIBMONAD_LEFT_HINT
+#endif
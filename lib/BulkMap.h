@@ -0,0 +1,233 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "OptionColumn.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+// Kernels for wider instruction sets are compiled per function with GCC and Clang, so the rest of the program
+// does not need to be built for them. MSVC has no per function targets, so there every level runs the same
+// kernel, vectorised for whatever /arch the program is built with.
+#if defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define LIBMONAD_X86_TARGETS 1
+#define LIBMONAD_TARGET_SSE2
+#define LIBMONAD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define LIBMONAD_TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx512vl,avx512bw"), min_vector_width(512)))
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+// GCC only vectorises from -O3, so the kernels ask for it themselves
+#define LIBMONAD_X86_TARGETS 1
+#define LIBMONAD_TARGET_SSE2 __attribute__((optimize("tree-vectorize")))
+#define LIBMONAD_TARGET_AVX2 __attribute__((target("avx2,fma"), optimize("tree-vectorize")))
+#define LIBMONAD_TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx512vl,avx512bw,prefer-vector-width=512"), optimize("tree-vectorize")))
+#else
+#define LIBMONAD_X86_TARGETS 0
+#define LIBMONAD_TARGET_SSE2
+#define LIBMONAD_TARGET_AVX2
+#define LIBMONAD_TARGET_AVX512
+#endif
+
+// The scalar kernel is kept scalar, so it is a fallback that works anywhere and a baseline to measure the others against
+#if defined(__clang__)
+#define LIBMONAD_NO_VECTORIZE
+#define LIBMONAD_NO_VECTORIZE_LOOP _Pragma("clang loop vectorize(disable) interleave(disable)")
+#elif defined(__GNUC__)
+#define LIBMONAD_NO_VECTORIZE __attribute__((optimize("no-tree-vectorize")))
+#define LIBMONAD_NO_VECTORIZE_LOOP
+#else
+#define LIBMONAD_NO_VECTORIZE
+#define LIBMONAD_NO_VECTORIZE_LOOP
+#endif
+
+namespace libmonad
+{
+	/**
+	 * \brief Widest instruction set a bulk map uses
+	 */
+	enum class SimdLevel : unsigned char { Scalar, Sse2, Avx2, Avx512 };
+
+	/**
+	 * \brief Finds the widest instruction set this CPU, and the operating system, supports
+	 * \return SimdLevel::Scalar on anything other than x86
+	 */
+	inline SimdLevel DetectSimdLevel()
+	{
+#if LIBMONAD_X86_TARGETS
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512bw")) { return SimdLevel::Avx512; }
+		if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) { return SimdLevel::Avx2; }
+		if(__builtin_cpu_supports("sse2")) { return SimdLevel::Sse2; }
+		return SimdLevel::Scalar;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		int info[4];
+		__cpuid(info, 1);
+		const bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+		const bool sse2 = info[3] & (1 << 26);
+		__cpuidex(info, 7, 0);
+		if(osSavesYmm && (_xgetbv(0) & 0xe6) == 0xe6 && (info[1] & (1 << 16)) && (info[1] & (1 << 17)) && (info[1] & (1 << 30)) && (info[1] & (1 << 31))) { return SimdLevel::Avx512; }
+		if(osSavesYmm && (info[1] & (1 << 5))) { return SimdLevel::Avx2; }
+		return sse2 ? SimdLevel::Sse2 : SimdLevel::Scalar;
+#else
+		return SimdLevel::Scalar;
+#endif
+	}
+
+	/**
+	 * \brief The widest instruction set this CPU supports, found once
+	 */
+	inline SimdLevel CurrentSimdLevel()
+	{
+		static const SimdLevel level = DetectSimdLevel();
+		return level;
+	}
+
+	namespace detail
+	{
+		// Transforms n values with no gaps, leaving the compiler to vectorise the loop for the target it is compiled for.
+		// in and out may be the same array, which the vectorised loops allow for.
+
+		template <typename T, typename U, typename F>
+		LIBMONAD_NO_VECTORIZE void MapDenseScalar(const T* in, U* out, const std::size_t n, F& transform)
+		{
+			LIBMONAD_NO_VECTORIZE_LOOP
+			for(std::size_t i = 0; i < n; i++) { out[i] = static_cast<U>(transform(in[i])); }
+		}
+
+		template <typename T, typename U, typename F>
+		LIBMONAD_TARGET_SSE2 void MapDenseSse2(const T* in, U* out, const std::size_t n, F& transform)
+		{
+			for(std::size_t i = 0; i < n; i++) { out[i] = static_cast<U>(transform(in[i])); }
+		}
+
+		template <typename T, typename U, typename F>
+		LIBMONAD_TARGET_AVX2 void MapDenseAvx2(const T* in, U* out, const std::size_t n, F& transform)
+		{
+			for(std::size_t i = 0; i < n; i++) { out[i] = static_cast<U>(transform(in[i])); }
+		}
+
+		template <typename T, typename U, typename F>
+		LIBMONAD_TARGET_AVX512 void MapDenseAvx512(const T* in, U* out, const std::size_t n, F& transform)
+		{
+			for(std::size_t i = 0; i < n; i++) { out[i] = static_cast<U>(transform(in[i])); }
+		}
+
+		template <typename T, typename U, typename F>
+		using Kernel = void (*)(const T*, U*, std::size_t, F&);
+
+		/**
+		 * \brief The kernel for the given instruction set, or for the widest the CPU supports if it does not support that one
+		 */
+		template <typename T, typename U, typename F>
+		Kernel<T, U, F> KernelFor(const SimdLevel level)
+		{
+			switch(level < CurrentSimdLevel() ? level : CurrentSimdLevel())
+			{
+			case SimdLevel::Avx512: return MapDenseAvx512<T, U, F>;
+			case SimdLevel::Avx2: return MapDenseAvx2<T, U, F>;
+			case SimdLevel::Sse2: return MapDenseSse2<T, U, F>;
+			default: return MapDenseScalar<T, U, F>;
+			}
+		}
+
+		/**
+		 * \brief Runs of full words go through the vector kernel, as do words with a few nones once the nones' lanes are filled
+		 * with a value from the same word. Words with mostly nones call transform for each of their values alone,
+		 * and words of nothing but nones are skipped.
+		 */
+		template <typename T, typename U, typename F>
+		void MapWords(const std::vector<std::uint64_t>& words, const std::size_t size, const T* in, U* out, F& transform, const Kernel<T, U, F> kernel)
+		{
+			constexpr auto bits = ValidityBitmap::BitsPerWord;
+			std::size_t w = 0;
+			while(w < words.size())
+			{
+				// Only words wholly inside the column can be full, as bits past the end are clear
+				auto end = w;
+				while(end < words.size() && words[end] == ~std::uint64_t(0)) { end++; }
+				if(end > w)
+				{
+					kernel(in + w * bits, out + w * bits, (end - w) * bits, transform);
+					w = end;
+					continue;
+				}
+
+				auto word = words[w];
+				const auto base = w * bits;
+				if(std::popcount(word) >= static_cast<int>(bits / 8) && base + bits <= size)
+				{
+					// The nones' lanes are given a value transform is called with anyway, so it never sees what a none slot holds.
+					// What the kernel writes to those lanes is meaningless, as the values of nones are.
+					T lanes[bits];
+					std::copy_n(in + base, bits, lanes);
+					const auto filler = lanes[std::countr_zero(word)];
+					for(auto nones = ~word; nones != 0; nones &= nones - 1) { lanes[std::countr_zero(nones)] = filler; }
+					kernel(lanes, out + base, bits, transform);
+				}
+				else
+				{
+					while(word != 0)
+					{
+						const auto i = base + std::countr_zero(word);
+						out[i] = static_cast<U>(transform(in[i]));
+						word &= word - 1;
+					}
+				}
+				w++;
+			}
+		}
+	}
+
+	/**
+	 * \brief Transforms every value of a column of arithmetic values, using the widest vector instructions the CPU supports.
+	 * Nones are carried through unchanged and the transformation is never called with what a none slot holds, so it may trap on those values.
+	 * \tparam T arithmetic type of value
+	 * \tparam F transformation function that takes a T and returns an arithmetic value. It should be simple enough for the compiler
+	 * to vectorise, and must not have side effects, as it may be called more than once with the same value.
+	 * \param column column to transform
+	 * \param transform transformation function
+	 * \param level widest instruction set to use, by default and at most the widest the CPU supports
+	 * \return OptionColumn<U> with the same values missing
+	 */
+	template <typename T, typename F>
+	auto BulkMap(const OptionColumn<T>& column, F transform, const SimdLevel level = CurrentSimdLevel())
+	{
+		using U = std::decay_t<std::invoke_result_t<F&, T>>;
+		static_assert(std::is_arithmetic_v<T> && std::is_arithmetic_v<U>, "BulkMap is for columns of arithmetic values, use OptionColumn::Map otherwise");
+
+		std::vector<U> values(column.Size());
+		detail::MapWords(column.SomeBits().Words(), column.Size(), column.Values().data(), values.data(), transform, detail::KernelFor<T, U, F>(level));
+		return OptionColumn<U>(column.SomeBits(), std::move(values));
+	}
+
+	/**
+	 * \brief Transforms every value of an rvalue column of arithmetic values, in place when the values keep their type
+	 * \tparam T arithmetic type of value
+	 * \tparam F transformation function that takes a T and returns an arithmetic value
+	 * \param column column to transform
+	 * \param transform transformation function
+	 * \param level widest instruction set to use, by default and at most the widest the CPU supports
+	 * \return OptionColumn<U> with the same values missing
+	 */
+	template <typename T, typename F>
+	auto BulkMap(OptionColumn<T>&& column, F transform, const SimdLevel level = CurrentSimdLevel())
+	{
+		using U = std::decay_t<std::invoke_result_t<F&, T>>;
+		if constexpr (std::is_same_v<U, T>)
+		{
+			auto [someBits, values] = std::move(column).Release();
+			detail::MapWords(someBits.Words(), values.size(), values.data(), values.data(), transform, detail::KernelFor<T, T, F>(level));
+			return OptionColumn<T>(std::move(someBits), std::move(values));
+		}
+		else
+		{
+			return BulkMap(static_cast<const OptionColumn<T>&>(column), std::move(transform), level);
+		}
+	}
+}
@@ -0,0 +1,717 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "EitherColumn.h"
+#include "Error.h"
+#include "OptionColumn.h"
+
+namespace libmonad
+{
+	static_assert(std::endian::native == std::endian::little, "Column files are little-endian, and are read in place without converting them");
+
+	inline const ErrorCode CannotOpenColumnFile = RegisterError("cannot open column file");
+	inline const ErrorCode CannotWriteColumnFile = RegisterError("cannot write column file");
+	inline const ErrorCode BadColumnFile = RegisterError("bad column file");
+
+	/**
+	 * \brief How the values of a column are stored in a column file, and how they are read back without copying them.
+	 * Trivially copyable values are stored as they are in memory and read as const T&.
+	 * \tparam T type of value
+	 */
+	template <typename T>
+	struct ColumnPayload
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values and std::string can be stored in a column file");
+
+		static constexpr bool Bytes = false;
+		using View = const T&;
+	};
+
+	/**
+	 * \brief Strings, or blobs held in strings, are stored as offsets into a region of their bytes and read as std::string_view
+	 */
+	template <>
+	struct ColumnPayload<std::string>
+	{
+		static constexpr bool Bytes = true;
+		using View = std::string_view;
+	};
+
+	/**
+	 * \brief Where a section of a column file is, in bytes from the start of the file
+	 */
+	struct ColumnFileSection
+	{
+		std::uint64_t offset;
+		std::uint64_t size;
+	};
+
+	/**
+	 * \brief The start of a column file. Each section after it starts on a 64 byte boundary, and holds:
+	 *
+	 * bits        one bit per element saying whether it is right (or some), packed 64 to a little-endian word
+	 * values      the right value (or value) of every element at its own index, or for strings count + 1 offsets into valueBytes
+	 * valueBytes  the bytes of string values
+	 * leftIndices the index of each left element, in order, as 64 bit integers
+	 * lefts       the left values in the same order, or for strings leftCount + 1 offsets into leftBytes
+	 * leftBytes   the bytes of string left values
+	 *
+	 * An option column has no left sections. A version other than CurrentVersion is not read.
+	 */
+	struct ColumnFileHeader
+	{
+		enum class Kind : std::uint32_t { Option = 1, Either = 2 };
+
+		static constexpr char Signature[8] = { 'L', 'M', 'C', 'O', 'L', 'U', 'M', 'N' };
+		static constexpr std::uint32_t CurrentVersion = 1;
+		static constexpr std::uint64_t Alignment = 64;
+
+		char signature[8];
+		std::uint32_t version;
+		Kind kind;
+		// Size of a right value (or value) and a left value, or 0 for strings
+		std::uint32_t valueSize;
+		std::uint32_t leftSize;
+		std::uint64_t count;
+		std::uint64_t leftCount;
+		ColumnFileSection bits, values, valueBytes, leftIndices, lefts, leftBytes;
+	};
+
+	static_assert(std::is_trivially_copyable_v<ColumnFileHeader> && sizeof(ColumnFileHeader) == 136);
+
+	namespace detail
+	{
+		template <typename T>
+		constexpr std::uint32_t StoredSize() { return ColumnPayload<T>::Bytes ? 0 : sizeof(T); }
+
+		/**
+		 * \brief Writes the sections of a column file one after another, then the header in front of them
+		 */
+		class ColumnFileWriter
+		{
+		public:
+			explicit ColumnFileWriter(const std::filesystem::path& path) : file(path, std::ios::binary | std::ios::trunc)
+			{
+				const ColumnFileHeader placeholder{};
+				Write(&placeholder, sizeof(placeholder));
+			}
+
+			bool IsOpen() const { return file.is_open(); }
+
+			/**
+			 * \brief Writes a section, starting it on the next 64 byte boundary
+			 */
+			ColumnFileSection Write(const void* data, const std::size_t size)
+			{
+				static constexpr char padding[ColumnFileHeader::Alignment] = {};
+				const auto start = (position + ColumnFileHeader::Alignment - 1) / ColumnFileHeader::Alignment * ColumnFileHeader::Alignment;
+				file.write(padding, static_cast<std::streamsize>(start - position));
+				file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+				position = start + size;
+				return { start, size };
+			}
+
+			/**
+			 * \brief Writes an array of values, and for strings the region of their bytes after it
+			 * \return the section of the values, and of their bytes
+			 */
+			template <typename T>
+			std::pair<ColumnFileSection, ColumnFileSection> WriteArray(const std::vector<T>& array)
+			{
+				if constexpr (ColumnPayload<T>::Bytes)
+				{
+					std::vector<std::uint64_t> offsets(array.size() + 1, 0);
+					for(std::size_t i = 0; i < array.size(); i++) { offsets[i + 1] = offsets[i] + array[i].size(); }
+					const auto values = Write(offsets.data(), offsets.size() * sizeof(std::uint64_t));
+
+					const auto bytes = Write(nullptr, 0);
+					for(const auto& value : array) { file.write(value.data(), static_cast<std::streamsize>(value.size())); }
+					position += offsets.back();
+					return { values, { bytes.offset, offsets.back() } };
+				}
+				else
+				{
+					return { Write(array.data(), array.size() * sizeof(T)), {} };
+				}
+			}
+
+			ColumnFileSection WriteIndices(const std::vector<std::size_t>& indices)
+			{
+				if constexpr (sizeof(std::size_t) == sizeof(std::uint64_t)) { return Write(indices.data(), indices.size() * sizeof(std::uint64_t)); }
+				else { return Write(std::vector<std::uint64_t>(indices.begin(), indices.end()).data(), indices.size() * sizeof(std::uint64_t)); }
+			}
+
+			/**
+			 * \brief Writes the header at the start of the file
+			 * \return size of the file, or why it could not be written
+			 */
+			ErrorOr<std::size_t> Finish(ColumnFileHeader header)
+			{
+				std::copy(std::begin(ColumnFileHeader::Signature), std::end(ColumnFileHeader::Signature), header.signature);
+				header.version = ColumnFileHeader::CurrentVersion;
+				file.seekp(0);
+				file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				file.close();
+				if(!file) { return Error(CannotWriteColumnFile); }
+				return static_cast<std::size_t>(position);
+			}
+
+		private:
+			std::ofstream file;
+			std::uint64_t position = 0;
+		};
+
+		/**
+		 * \brief Reads an array of values in place in a mapped column file
+		 * \tparam T type of value
+		 */
+		template <typename T>
+		class MappedArray
+		{
+		public:
+			MappedArray() = default;
+			MappedArray(const std::byte* values, const std::byte* bytes) : values(values), bytes(bytes) {}
+
+			typename ColumnPayload<T>::View operator[](const std::size_t i) const
+			{
+				if constexpr (ColumnPayload<T>::Bytes)
+				{
+					const auto offsets = reinterpret_cast<const std::uint64_t*>(values);
+					return { reinterpret_cast<const char*>(bytes) + offsets[i], static_cast<std::size_t>(offsets[i + 1] - offsets[i]) };
+				}
+				else
+				{
+					return reinterpret_cast<const T*>(values)[i];
+				}
+			}
+
+		private:
+			const std::byte* values = nullptr;
+			const std::byte* bytes = nullptr;
+		};
+
+		/**
+		 * \brief Copies a value read in place back into a T
+		 */
+		template <typename T>
+		T Materialise(typename ColumnPayload<T>::View view) { return T(view); }
+	}
+
+	/**
+	 * \brief A file mapped read-only into memory, unmapped when the last view of it goes
+	 */
+	class MappedFile
+	{
+	public:
+		/**
+		 * \brief Maps a whole file
+		 * \param path file to map
+		 * \return the mapped file, or why it could not be mapped
+		 */
+		static ErrorOr<std::shared_ptr<const MappedFile>> Open(const std::filesystem::path& path)
+		{
+			std::shared_ptr<MappedFile> mapped(new MappedFile());
+#ifdef _WIN32
+			mapped->file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			LARGE_INTEGER size;
+			if(mapped->file == INVALID_HANDLE_VALUE || !GetFileSizeEx(mapped->file, &size))
+			{
+				return Error(CannotOpenColumnFile, static_cast<std::int64_t>(GetLastError()));
+			}
+			mapped->size = static_cast<std::size_t>(size.QuadPart);
+			if(mapped->size == 0) { return std::shared_ptr<const MappedFile>(std::move(mapped)); }
+			mapped->mapping = CreateFileMappingW(mapped->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			const auto view = mapped->mapping ? MapViewOfFile(mapped->mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+			if(view == nullptr) { return Error(CannotOpenColumnFile, static_cast<std::int64_t>(GetLastError())); }
+			mapped->data = static_cast<const std::byte*>(view);
+#else
+			const auto file = ::open(path.c_str(), O_RDONLY);
+			if(file < 0) { return Error(CannotOpenColumnFile, static_cast<std::int64_t>(errno)); }
+			struct stat status {};
+			if(::fstat(file, &status) != 0)
+			{
+				const auto error = errno;
+				::close(file);
+				return Error(CannotOpenColumnFile, static_cast<std::int64_t>(error));
+			}
+			mapped->size = static_cast<std::size_t>(status.st_size);
+			const auto view = mapped->size == 0 ? nullptr : ::mmap(nullptr, mapped->size, PROT_READ, MAP_SHARED, file, 0);
+			const auto error = errno;
+			::close(file);
+			if(view == MAP_FAILED) { return Error(CannotOpenColumnFile, static_cast<std::int64_t>(error)); }
+			mapped->data = static_cast<const std::byte*>(view);
+#endif
+			return std::shared_ptr<const MappedFile>(std::move(mapped));
+		}
+
+		~MappedFile()
+		{
+#ifdef _WIN32
+			if(data) { UnmapViewOfFile(data); }
+			if(mapping) { CloseHandle(mapping); }
+			if(file != INVALID_HANDLE_VALUE) { CloseHandle(file); }
+#else
+			if(data) { ::munmap(const_cast<std::byte*>(data), size); }
+#endif
+		}
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		const std::byte* Data() const { return data; }
+		std::size_t Size() const { return size; }
+
+	private:
+		MappedFile() = default;
+
+		const std::byte* data = nullptr;
+		std::size_t size = 0;
+#ifdef _WIN32
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = nullptr;
+#endif
+	};
+
+	namespace detail
+	{
+		/**
+		 * \brief Checks the header and every section of a mapped column file, so that views of it never read outside it
+		 */
+		class ColumnFileChecker
+		{
+		public:
+			explicit ColumnFileChecker(const MappedFile& file) : file(file) {}
+
+			/**
+			 * \brief Reads the header, if the file is a column file of the kind and value sizes expected
+			 */
+			Option<ColumnFileHeader> Header(const ColumnFileHeader::Kind kind, const std::uint32_t valueSize, const std::uint32_t leftSize) const
+			{
+				if(file.Size() < sizeof(ColumnFileHeader)) { return None(); }
+				ColumnFileHeader header;
+				std::memcpy(&header, file.Data(), sizeof(header));
+				if(!std::equal(std::begin(header.signature), std::end(header.signature), std::begin(ColumnFileHeader::Signature))) { return None(); }
+				if(header.version != ColumnFileHeader::CurrentVersion || header.kind != kind) { return None(); }
+				if(header.valueSize != valueSize || header.leftSize != leftSize || header.leftCount > header.count) { return None(); }
+				// Every element takes at least a bit, which also keeps the sizes worked out from the counts from overflowing
+				if(header.count / 8 > file.Size()) { return None(); }
+				return header;
+			}
+
+			/**
+			 * \brief Whether a section is inside the file, aligned and of the size expected
+			 */
+			bool Section(const ColumnFileSection& section, const std::uint64_t size) const
+			{
+				return section.size == size && section.offset % ColumnFileHeader::Alignment == 0
+					&& section.offset <= file.Size() && section.size <= file.Size() - section.offset;
+			}
+
+			/**
+			 * \brief Whether a bitmap of count bits is inside the file, with the bits past the end of its last word clear
+			 * as BitmapView needs
+			 */
+			bool Bits(const ColumnFileSection& section, const std::uint64_t count) const
+			{
+				const auto words = (count + BitmapView::BitsPerWord - 1) / BitmapView::BitsPerWord;
+				if(!Section(section, words * sizeof(std::uint64_t))) { return false; }
+				if(count % BitmapView::BitsPerWord == 0) { return true; }
+				const auto last = reinterpret_cast<const std::uint64_t*>(At(section))[words - 1];
+				return (last >> (count % BitmapView::BitsPerWord)) == 0;
+			}
+
+			/**
+			 * \brief Whether the indices of the left elements are inside the file, and are the clear bits in order
+			 */
+			bool LeftIndices(const ColumnFileSection& section, const BitmapView& rightBits, const std::uint64_t leftCount) const
+			{
+				if(!Section(section, leftCount * sizeof(std::uint64_t))) { return false; }
+				const auto indices = reinterpret_cast<const std::uint64_t*>(At(section));
+				std::uint64_t left = 0;
+				auto matches = true;
+				rightBits.ForEach([](std::size_t) {}, [&](const std::size_t i)
+				{
+					matches = matches && left < leftCount && indices[left] == i;
+					left++;
+				});
+				return matches && left == leftCount;
+			}
+
+			/**
+			 * \brief Whether an array of count values is inside the file, and for strings whether every offset is inside the region of bytes
+			 */
+			template <typename T>
+			bool Array(const ColumnFileSection& values, const ColumnFileSection& bytes, const std::uint64_t count) const
+			{
+				if constexpr (ColumnPayload<T>::Bytes)
+				{
+					if(!Section(values, (count + 1) * sizeof(std::uint64_t)) || !Section(bytes, bytes.size)) { return false; }
+					const auto offsets = reinterpret_cast<const std::uint64_t*>(file.Data() + values.offset);
+					if(offsets[0] != 0 || offsets[count] != bytes.size) { return false; }
+					for(std::uint64_t i = 0; i < count; i++) { if(offsets[i] > offsets[i + 1]) { return false; } }
+					return true;
+				}
+				else
+				{
+					return Section(values, count * sizeof(T));
+				}
+			}
+
+			const std::byte* At(const ColumnFileSection& section) const { return file.Data() + section.offset; }
+
+		private:
+			const MappedFile& file;
+		};
+	}
+
+	/**
+	 * \brief An either column read in place from a mapped column file. Right and left values are passed to Match and Map
+	 * straight from the mapped pages, as const references or, for strings, as std::string_view.
+	 * \tparam L Left type
+	 * \tparam R Right type
+	 */
+	template <typename L, typename R>
+	class EitherColumnView
+	{
+	public:
+		using LeftView = typename ColumnPayload<L>::View;
+		using RightView = typename ColumnPayload<R>::View;
+
+		/**
+		 * \brief Number of elements
+		 */
+		std::size_t Size() const { return rightBits.Size(); }
+
+		std::size_t RightCount() const { return Size() - LeftCount(); }
+		std::size_t LeftCount() const { return leftCount; }
+
+		bool IsLeft(const std::size_t i) const { return !rightBits.Test(i); }
+		bool IsRight(const std::size_t i) const { return rightBits.Test(i); }
+
+		/**
+		 * \brief Element i, referring to its value in the file
+		 * \param i index of the element
+		 */
+		Either<LeftView, RightView> At(const std::size_t i) const
+		{
+			if(rightBits.Test(i)) { return rights[i]; }
+			const auto left = std::lower_bound(leftIndices, leftIndices + leftCount, static_cast<std::uint64_t>(i));
+			return lefts[left - leftIndices];
+		}
+
+		/**
+		 * \brief Which elements are right
+		 */
+		BitmapView RightBits() const { return rightBits; }
+
+		/**
+		 * \brief Performs an action for every element, in order, depending on whether it is left or right
+		 * \param ifLeft action to perform with a left value
+		 * \param ifRight action to perform with a right value
+		 */
+		template <typename FL, typename FR>
+		void Match(FL&& ifLeft, FR&& ifRight) const
+		{
+			std::size_t left = 0;
+			rightBits.ForEach(
+				[&](const std::size_t i) { std::invoke(ifRight, rights[i]); },
+				[&](std::size_t) { std::invoke(ifLeft, lefts[left++]); });
+		}
+
+		/**
+		 * \brief Performs an action for every right value, in order, skipping left values a word at a time
+		 * \param ifRight action to perform with a right value
+		 */
+		template <typename F>
+		void WhenRight(F&& ifRight) const
+		{
+			rightBits.ForEachSet([&](const std::size_t i) { std::invoke(ifRight, rights[i]); });
+		}
+
+		/**
+		 * \brief Transforms every right value read from the file into a new column in memory, copying left values over
+		 * \tparam F transformation function that takes a right value and returns a T or an Either<L, T>
+		 * \param transform transformation function
+		 * \return EitherColumn<L, T>
+		 */
+		template <typename F>
+		auto Map(F&& transform) const
+		{
+			using Result = MappedEither<L, std::decay_t<std::invoke_result_t<F&, RightView>>>;
+			static_assert(std::is_same_v<typename Result::LeftType, L>, "Map transformation must keep the left type");
+
+			EitherColumn<L, typename Result::RightType> result;
+			Match(
+				[&](LeftView left) { result.PushLeft(detail::Materialise<L>(left)); },
+				[&](RightView right) { result.PushBack(Result(std::invoke(transform, right))); });
+			return result;
+		}
+
+		/**
+		 * \brief Transforms every right value read from the file into an either, so elements can become left
+		 * \tparam F transformation function that takes a right value and returns an Either<L, T>
+		 * \param transform transformation function
+		 * \return EitherColumn<L, T>
+		 */
+		template <typename F>
+		auto Bind(F&& transform) const
+		{
+			static_assert(IsEither<std::decay_t<std::invoke_result_t<F&, RightView>>>::value, "Bind transformation must return an Either, use Map to return a plain value");
+			return Map(std::forward<F>(transform));
+		}
+
+		/**
+		 * \brief Copies the whole column into memory
+		 */
+		EitherColumn<L, R> ToColumn() const
+		{
+			return Map([](RightView right) { return detail::Materialise<R>(right); });
+		}
+
+	private:
+		template <typename L2, typename R2>
+		friend ErrorOr<EitherColumnView<L2, R2>> OpenEitherColumnFile(const std::filesystem::path& path);
+
+		std::shared_ptr<const MappedFile> file;
+		BitmapView rightBits;
+		detail::MappedArray<R> rights;
+		const std::uint64_t* leftIndices = nullptr;
+		std::size_t leftCount = 0;
+		detail::MappedArray<L> lefts;
+	};
+
+	/**
+	 * \brief An option column read in place from a mapped column file. Values are passed to Match and Map
+	 * straight from the mapped pages, as const references or, for strings, as std::string_view.
+	 * \tparam T type of value
+	 */
+	template <typename T>
+	class OptionColumnView
+	{
+	public:
+		using ValueView = typename ColumnPayload<T>::View;
+
+		/**
+		 * \brief Number of elements
+		 */
+		std::size_t Size() const { return someBits.Size(); }
+
+		std::size_t SomeCount() const { return someBits.Count(); }
+
+		bool IsNone(const std::size_t i) const { return !someBits.Test(i); }
+		bool IsSome(const std::size_t i) const { return someBits.Test(i); }
+
+		/**
+		 * \brief Element i, referring to its value in the file
+		 * \param i index of the element
+		 */
+		Option<ValueView> At(const std::size_t i) const { return someBits.Test(i) ? Option<ValueView>(values[i]) : Option<ValueView>(); }
+
+		/**
+		 * \brief Which elements have a value
+		 */
+		BitmapView SomeBits() const { return someBits; }
+
+		/**
+		 * \brief Performs an action for every element, in order, depending on whether it has a value
+		 * \param ifNone action to perform for a none
+		 * \param ifSome action to perform with a value
+		 */
+		template <typename FN, typename FS>
+		void Match(FN&& ifNone, FS&& ifSome) const
+		{
+			someBits.ForEach(
+				[&](const std::size_t i) { std::invoke(ifSome, values[i]); },
+				[&](std::size_t) { std::invoke(ifNone, None()); });
+		}
+
+		/**
+		 * \brief Performs an action for every value, in order, skipping nones a word at a time
+		 * \param ifSome action to perform with a value
+		 */
+		template <typename F>
+		void WhenSome(F&& ifSome) const
+		{
+			someBits.ForEachSet([&](const std::size_t i) { std::invoke(ifSome, values[i]); });
+		}
+
+		/**
+		 * \brief Transforms every value read from the file into a new column in memory, leaving nones as they are
+		 * \tparam F transformation function that takes a value and returns a U or an Option<U>
+		 * \param transform transformation function
+		 * \return OptionColumn<U>
+		 */
+		template <typename F>
+		auto Map(F&& transform) const
+		{
+			using Result = MappedOption<std::decay_t<std::invoke_result_t<F&, ValueView>>>;
+
+			OptionColumn<typename Result::ValueType> result;
+			Match(
+				[&](None) { result.PushNone(); },
+				[&](ValueView value) { result.PushBack(Result(std::invoke(transform, value))); });
+			return result;
+		}
+
+		/**
+		 * \brief Transforms every value read from the file into an option, so elements can become none
+		 * \tparam F transformation function that takes a value and returns an Option<U>
+		 * \param transform transformation function
+		 * \return OptionColumn<U>
+		 */
+		template <typename F>
+		auto Bind(F&& transform) const
+		{
+			static_assert(IsOption<std::decay_t<std::invoke_result_t<F&, ValueView>>>::value, "Bind transformation must return an Option, use Map to return a plain value");
+			return Map(std::forward<F>(transform));
+		}
+
+		/**
+		 * \brief Copies the whole column into memory
+		 */
+		OptionColumn<T> ToColumn() const
+		{
+			return Map([](ValueView value) { return detail::Materialise<T>(value); });
+		}
+
+	private:
+		template <typename T2>
+		friend ErrorOr<OptionColumnView<T2>> OpenOptionColumnFile(const std::filesystem::path& path);
+
+		std::shared_ptr<const MappedFile> file;
+		BitmapView someBits;
+		detail::MappedArray<T> values;
+	};
+
+	/**
+	 * \brief Writes an either column to a column file, in the layout it has in memory
+	 * \param path file to write, replacing any file already there
+	 * \param column column to write, whose values must be trivially copyable or std::string
+	 * \return size of the file written, or why it could not be written
+	 */
+	template <typename L, typename R>
+	ErrorOr<std::size_t> WriteColumnFile(const std::filesystem::path& path, const EitherColumn<L, R>& column)
+	{
+		detail::ColumnFileWriter writer(path);
+		if(!writer.IsOpen()) { return Error(CannotOpenColumnFile, static_cast<std::int64_t>(errno)); }
+
+		ColumnFileHeader header{};
+		header.kind = ColumnFileHeader::Kind::Either;
+		header.valueSize = detail::StoredSize<R>();
+		header.leftSize = detail::StoredSize<L>();
+		header.count = column.Size();
+		header.leftCount = column.LeftCount();
+		header.bits = writer.Write(column.RightBits().Words().data(), column.RightBits().Words().size() * sizeof(std::uint64_t));
+		std::tie(header.values, header.valueBytes) = writer.WriteArray(column.Rights());
+		header.leftIndices = writer.WriteIndices(column.LeftIndices());
+		std::tie(header.lefts, header.leftBytes) = writer.WriteArray(column.Lefts());
+		return writer.Finish(header);
+	}
+
+	/**
+	 * \brief Writes an option column to a column file, in the layout it has in memory
+	 * \param path file to write, replacing any file already there
+	 * \param column column to write, whose values must be trivially copyable or std::string
+	 * \return size of the file written, or why it could not be written
+	 */
+	template <typename T>
+	ErrorOr<std::size_t> WriteColumnFile(const std::filesystem::path& path, const OptionColumn<T>& column)
+	{
+		detail::ColumnFileWriter writer(path);
+		if(!writer.IsOpen()) { return Error(CannotOpenColumnFile, static_cast<std::int64_t>(errno)); }
+
+		ColumnFileHeader header{};
+		header.kind = ColumnFileHeader::Kind::Option;
+		header.valueSize = detail::StoredSize<T>();
+		header.count = column.Size();
+		header.bits = writer.Write(column.SomeBits().Words().data(), column.SomeBits().Words().size() * sizeof(std::uint64_t));
+		std::tie(header.values, header.valueBytes) = writer.WriteArray(column.Values());
+		return writer.Finish(header);
+	}
+
+	/**
+	 * \brief Maps a column file written from an EitherColumn<L, R> to read it in place
+	 * \param path file to map
+	 * \return a view of the column, or why the file could not be mapped or is not a column of L and R
+	 */
+	template <typename L, typename R>
+	ErrorOr<EitherColumnView<L, R>> OpenEitherColumnFile(const std::filesystem::path& path)
+	{
+		return MappedFile::Open(path).Bind([](std::shared_ptr<const MappedFile>&& file) -> ErrorOr<EitherColumnView<L, R>>
+		{
+			const detail::ColumnFileChecker check(*file);
+			const auto read = check.Header(ColumnFileHeader::Kind::Either, detail::StoredSize<R>(), detail::StoredSize<L>());
+			if(read.IsNone()) { return Error(BadColumnFile, "header"); }
+			const auto& header = read.ThrowIfNone();
+
+			if(!check.Bits(header.bits, header.count)) { return Error(BadColumnFile, "bits"); }
+			const BitmapView bits(reinterpret_cast<const std::uint64_t*>(check.At(header.bits)), header.count);
+			if(header.count - bits.Count() != header.leftCount) { return Error(BadColumnFile, "bits"); }
+			if(!check.Array<R>(header.values, header.valueBytes, header.count)) { return Error(BadColumnFile, "values"); }
+			if(!check.LeftIndices(header.leftIndices, bits, header.leftCount)) { return Error(BadColumnFile, "left index"); }
+			if(!check.Array<L>(header.lefts, header.leftBytes, header.leftCount)) { return Error(BadColumnFile, "lefts"); }
+
+			EitherColumnView<L, R> view;
+			view.rightBits = bits;
+			view.rights = { check.At(header.values), check.At(header.valueBytes) };
+			view.leftIndices = reinterpret_cast<const std::uint64_t*>(check.At(header.leftIndices));
+			view.leftCount = header.leftCount;
+			view.lefts = { check.At(header.lefts), check.At(header.leftBytes) };
+			view.file = std::move(file);
+			return view;
+		});
+	}
+
+	/**
+	 * \brief Maps a column file written from an OptionColumn<T> to read it in place
+	 * \param path file to map
+	 * \return a view of the column, or why the file could not be mapped or is not a column of T
+	 */
+	template <typename T>
+	ErrorOr<OptionColumnView<T>> OpenOptionColumnFile(const std::filesystem::path& path)
+	{
+		return MappedFile::Open(path).Bind([](std::shared_ptr<const MappedFile>&& file) -> ErrorOr<OptionColumnView<T>>
+		{
+			const detail::ColumnFileChecker check(*file);
+			const auto read = check.Header(ColumnFileHeader::Kind::Option, detail::StoredSize<T>(), 0);
+			if(read.IsNone()) { return Error(BadColumnFile, "header"); }
+			const auto& header = read.ThrowIfNone();
+
+			if(!check.Bits(header.bits, header.count)) { return Error(BadColumnFile, "bits"); }
+			const BitmapView bits(reinterpret_cast<const std::uint64_t*>(check.At(header.bits)), header.count);
+			if(bits.Count() > header.count) { return Error(BadColumnFile, "bits"); }
+			if(!check.Array<T>(header.values, header.valueBytes, header.count)) { return Error(BadColumnFile, "values"); }
+
+			OptionColumnView<T> view;
+			view.someBits = bits;
+			view.values = { check.At(header.values), check.At(header.valueBytes) };
+			view.file = std::move(file);
+			return view;
+		});
+	}
+}
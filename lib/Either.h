@@ -1,8 +1,115 @@
 #pragma once
 #include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "BranchHints.h"
+#include "ErrorPolicy.h"
+#include "Instrument.h"
 
 namespace libmonad
-{	
+{
+	template <typename L, typename R>
+	class Either;
+
+	/**
+	 * \brief Determines if a type is an Either
+	 * \tparam T type to check
+	 */
+	template <typename T>
+	struct IsEither : std::false_type {};
+
+	template <typename L, typename R>
+	struct IsEither<Either<L, R>> : std::true_type {};
+
+	/**
+	 * \brief The either that mapping to T produces: T itself when T is already an Either, otherwise Either<L, T>
+	 * \tparam L Left type
+	 * \tparam T type the transformation returned
+	 */
+	template <typename L, typename T>
+	using MappedEither = std::conditional_t<IsEither<T>::value, T, Either<L, T>>;
+
+	/**
+	 * \brief What matching produces: the common type of what the left and right functions return
+	 * \tparam FL function called with the left value
+	 * \tparam FR function called with the right value
+	 * \tparam LArg how the left value is passed
+	 * \tparam RArg how the right value is passed
+	 */
+	template <typename FL, typename FR, typename LArg, typename RArg>
+	using MatchResult = std::common_type_t<std::invoke_result_t<FL, LArg>, std::invoke_result_t<FR, RArg>>;
+
+	/**
+	 * \brief How a T held by Self is passed on: as T& from an lvalue, const T& from a const lvalue and T&& from an rvalue
+	 * \tparam Self type, including reference, of the object holding the value
+	 * \tparam T type of the value held
+	 */
+	template <typename Self, typename T>
+	using ForwardLike = std::conditional_t<std::is_lvalue_reference_v<Self>,
+		std::conditional_t<std::is_const_v<std::remove_reference_t<Self>>, const T&, T&>, T&&>;
+
+	/**
+	 * \brief How an Either holds a value of T: the value itself
+	 * \tparam T type of value
+	 */
+	template <typename T>
+	struct EitherSlot
+	{
+		template <typename... Args>
+		constexpr explicit EitherSlot(std::in_place_t, Args&&... args) : value(std::forward<Args>(args)...) {}
+
+		T value;
+
+		template <typename Self>
+		static constexpr ForwardLike<Self, T> Get(Self&& self) { return std::forward<Self>(self).value; }
+	};
+
+	/**
+	 * \brief How an Either holds a reference: a pointer to the object, so the either is one pointer plus its tag
+	 * and assigning the either rebinds the reference rather than assigning to the object
+	 * \tparam T type of object referred to
+	 */
+	template <typename T>
+	struct EitherSlot<T&>
+	{
+		constexpr EitherSlot(std::in_place_t, T& object) noexcept : pointer(std::addressof(object)) {}
+
+		template <typename Self>
+		static constexpr T& Get(Self&& self) { return *self.pointer; }
+
+		T* pointer;
+	};
+
+	/**
+	 * \brief Selects the Either constructor that makes its left value in place from the arguments that follow
+	 */
+	struct InPlaceLeft { explicit InPlaceLeft() = default; };
+	inline constexpr InPlaceLeft inPlaceLeft{};
+
+	/**
+	 * \brief Selects the Either constructor that makes its right value in place from the arguments that follow
+	 */
+	struct InPlaceRight { explicit InPlaceRight() = default; };
+	inline constexpr InPlaceRight inPlaceRight{};
+
+	/**
+	 * \brief Whether copying, moving and destroying values of each of Ts is trivial. An Either or Option holding them
+	 * then copies, moves and destroys them as bytes, and is trivially copyable when they all are.
+	 * \tparam Ts types of value held
+	 */
+	template <typename... Ts>
+	struct TrivialSpecialMembers
+	{
+		static constexpr bool Destructible = (std::is_trivially_destructible_v<Ts> && ...);
+		// A value that is not trivially destructible is held in a union whose destructor is deleted, which would delete a defaulted copy too
+		static constexpr bool CopyConstructible = Destructible && (std::is_trivially_copy_constructible_v<Ts> && ...);
+		static constexpr bool MoveConstructible = Destructible && (std::is_trivially_move_constructible_v<Ts> && ...);
+		static constexpr bool CopyAssignable = CopyConstructible && (std::is_trivially_copy_assignable_v<Ts> && ...);
+		static constexpr bool MoveAssignable = MoveConstructible && (std::is_trivially_move_assignable_v<Ts> && ...);
+	};
+
 	/**
 	 * \brief An Either can contain either Left type or a Right type
 	 * \tparam L Left type 
@@ -12,24 +119,120 @@ namespace libmonad
 	class Either
 	{
 	public:
+		using LeftType = L;
+		using RightType = R;
+
 		/**
 		 * \brief Initialize either with left type value
 		 * \param left value
 		 */
 		// ReSharper disable once CppNonExplicitConvertingConstructor
-		Either(L left);
+		constexpr Either(L left);
 
 		/**
 		 * \brief Initialize either with right type value
 		 * \param right value
 		 */
 		// ReSharper disable once CppNonExplicitConvertingConstructor
-		Either(R right);
+		constexpr Either(R right);
+
+		/**
+		 * \brief An either of a reference cannot refer to a temporary
+		 */
+		Either(std::remove_reference_t<L>&&) requires std::is_reference_v<L> = delete;
+		Either(std::remove_reference_t<R>&&) requires std::is_reference_v<R> = delete;
+
+		/**
+		 * \brief Initialize either with a left value made from arguments in place, so it is never copied or moved
+		 * \param args arguments for the left value's constructor
+		 */
+		template <typename... Args>
+		constexpr explicit Either(InPlaceLeft, Args&&... args) requires std::is_constructible_v<L, Args...>
+			: leftValue(std::in_place, std::forward<Args>(args)...), state(State::Left) {}
+
+		/**
+		 * \brief Initialize either with a right value made from arguments in place, so it is never copied or moved
+		 * \param args arguments for the right value's constructor
+		 */
+		template <typename... Args>
+		constexpr explicit Either(InPlaceRight, Args&&... args) requires std::is_constructible_v<R, Args...>
+			: rightValue(std::in_place, std::forward<Args>(args)...), state(State::Right) {}
 
 		/**
 		 * \brief Initialize either with no value
 		 */
-		Either();	
+		constexpr Either();
+
+		/**
+		 * \brief Copies whichever value the other either holds
+		 * \param other either to copy
+		 */
+		constexpr Either(const Either& other);
+
+		/**
+		 * \brief Moves whichever value the other either holds
+		 * \param other either to move from
+		 */
+		constexpr Either(Either&& other) noexcept(std::is_nothrow_move_constructible_v<L> && std::is_nothrow_move_constructible_v<R>);
+
+		/**
+		 * \brief Copy assign from another either, switching the held value type if needed
+		 * \param other either to copy
+		 * \return this either
+		 */
+		constexpr Either& operator=(const Either& other);
+
+		/**
+		 * \brief Move assign from another either, switching the held value type if needed
+		 * \param other either to move from
+		 * \return this either
+		 */
+		constexpr Either& operator=(Either&& other) noexcept(std::is_nothrow_move_constructible_v<L> && std::is_nothrow_move_constructible_v<R>
+			&& std::is_nothrow_move_assignable_v<L> && std::is_nothrow_move_assignable_v<R>);
+
+		/**
+		 * \brief Destroys the held value only
+		 */
+		constexpr ~Either();
+
+		// The same, but trivial when they are for both values, so that an either of trivially copyable values is trivially copyable
+		// and can be copied with memcpy, eg. by std::vector
+
+		constexpr Either(const Either&) requires TrivialSpecialMembers<EitherSlot<L>, EitherSlot<R>>::CopyConstructible = default;
+		constexpr Either(Either&&) requires TrivialSpecialMembers<EitherSlot<L>, EitherSlot<R>>::MoveConstructible = default;
+		constexpr Either& operator=(const Either&) requires TrivialSpecialMembers<EitherSlot<L>, EitherSlot<R>>::CopyAssignable = default;
+		constexpr Either& operator=(Either&&) requires TrivialSpecialMembers<EitherSlot<L>, EitherSlot<R>>::MoveAssignable = default;
+		constexpr ~Either() requires TrivialSpecialMembers<EitherSlot<L>, EitherSlot<R>>::Destructible = default;
+
+		/**
+		 * \brief Destroys the held value and makes a left value in its place from arguments.
+		 * If making it throws, the either is left holding nothing.
+		 * \param args arguments for the left value's constructor
+		 * \return the new left value
+		 */
+		template <typename... Args>
+		constexpr L& EmplaceLeft(Args&&... args) requires std::is_constructible_v<L, Args...>
+		{
+			Destroy();
+			std::construct_at(std::addressof(leftValue), std::in_place, std::forward<Args>(args)...);
+			state = State::Left;
+			return LeftOf(*this);
+		}
+
+		/**
+		 * \brief Destroys the held value and makes a right value in its place from arguments.
+		 * If making it throws, the either is left holding nothing.
+		 * \param args arguments for the right value's constructor
+		 * \return the new right value
+		 */
+		template <typename... Args>
+		constexpr R& EmplaceRight(Args&&... args) requires std::is_constructible_v<R, Args...>
+		{
+			Destroy();
+			std::construct_at(std::addressof(rightValue), std::in_place, std::forward<Args>(args)...);
+			state = State::Right;
+			return RightOf(*this);
+		}
 
 		/**
 		 * \brief Transforms a right type value
@@ -38,7 +241,16 @@ namespace libmonad
 		 * \return Either if right type as R
 		 */
 		template <class T>
-		Either<L, T> Map(std::function<Either<L, T>(R)> transform);
+		Either<L, T> Map(std::function<Either<L, T>(R)> transform) const &;
+
+		/**
+		 * \brief Transforms a right type value, moving it into the transformation function and moving a left value through
+		 * \tparam T type to transform to
+		 * \param transform transformation function that transforms either right type from T to L
+		 * \return Either if right type as R
+		 */
+		template <class T>
+		Either<L, T> Map(std::function<Either<L, T>(R)> transform) &&;
 
 		/**
 		 * \brief Transforms a right type value
@@ -47,7 +259,128 @@ namespace libmonad
 		 * \return Either if right type as R
 		 */
 		template <typename T>
-		Either<L, T> Bind(std::function<Either<L,T>(R)> transform);
+		Either<L, T> Bind(std::function<Either<L,T>(R)> transform) const &;
+
+		/**
+		 * \brief Transforms a right type value, moving it into the transformation function and moving a left value through
+		 * \tparam T type to transform to
+		 * \param transform transformation function that transforms either right type from T to L
+		 * \return Either if right type as R
+		 */
+		template <typename T>
+		Either<L, T> Bind(std::function<Either<L,T>(R)> transform) &&;
+
+		/**
+		 * \brief Transforms a right type value, deducing the type to transform to from the transformation function.
+		 * Called on an rvalue either, the right value is moved into the transformation and a left value is moved through.
+		 * \tparam F transformation function that takes the right value and returns a T or an Either<L, T>
+		 * \param transform transformation function
+		 * \return Either<L, T>
+		 */
+		template <typename F, typename = std::enable_if_t<std::is_invocable_v<F, R&>>>
+		constexpr auto Map(F&& transform) & { return MapImpl(*this, std::forward<F>(transform)); }
+
+		template <typename F, typename = std::enable_if_t<std::is_invocable_v<F, const R&>>>
+		constexpr auto Map(F&& transform) const & { return MapImpl(*this, std::forward<F>(transform)); }
+
+		template <typename F, typename = std::enable_if_t<std::is_invocable_v<F, R&&>>>
+		constexpr auto Map(F&& transform) && { return MapImpl(std::move(*this), std::forward<F>(transform)); }
+
+		/**
+		 * \brief Transforms a right type value into another either, deducing the type of either from the transformation function.
+		 * Called on an rvalue either, the right value is moved into the transformation and a left value is moved through.
+		 * \tparam F transformation function that takes the right value and returns an Either<L, T>
+		 * \param transform transformation function
+		 * \return Either<L, T>
+		 */
+		template <typename F, typename = std::enable_if_t<std::is_invocable_v<F, R&>>>
+		constexpr auto Bind(F&& transform) & { return BindImpl(*this, std::forward<F>(transform)); }
+
+		template <typename F, typename = std::enable_if_t<std::is_invocable_v<F, const R&>>>
+		constexpr auto Bind(F&& transform) const & { return BindImpl(*this, std::forward<F>(transform)); }
+
+		template <typename F, typename = std::enable_if_t<std::is_invocable_v<F, R&&>>>
+		constexpr auto Bind(F&& transform) && { return BindImpl(std::move(*this), std::forward<F>(transform)); }
+
+		/**
+		 * \brief What value to return, whichever type of value the either contains.
+		 * Called on an rvalue either, the value is moved into whichever function is called.
+		 * \param ifLeft what to return if either contains left value
+		 * \param ifRight what to return if either contains right value
+		 * \return the common type of what ifLeft and ifRight return
+		 */
+		template <typename FL, typename FR>
+		constexpr MatchResult<FL, FR, L&, R&> When(FL&& ifLeft, FR&& ifRight) &
+		{
+			return MatchImpl(*this, std::forward<FL>(ifLeft), std::forward<FR>(ifRight));
+		}
+
+		template <typename FL, typename FR>
+		constexpr MatchResult<FL, FR, const L&, const R&> When(FL&& ifLeft, FR&& ifRight) const &
+		{
+			return MatchImpl(*this, std::forward<FL>(ifLeft), std::forward<FR>(ifRight));
+		}
+
+		template <typename FL, typename FR>
+		constexpr MatchResult<FL, FR, L&&, R&&> When(FL&& ifLeft, FR&& ifRight) &&
+		{
+			return MatchImpl(std::move(*this), std::forward<FL>(ifLeft), std::forward<FR>(ifRight));
+		}
+
+		/**
+		 * \brief perform action depending on the type value.
+		 * Called on an rvalue either, the value is moved into whichever action is performed.
+		 * \param  ifLeft action to perform if Left
+		 * \param  ifRight action to perform if Right
+		 * \return the common type of what ifLeft and ifRight return, usually void
+		 */
+		template <typename FL, typename FR>
+		constexpr MatchResult<FL, FR, L&, R&> Match(FL&& ifLeft, FR&& ifRight) &
+		{
+			return MatchImpl(*this, std::forward<FL>(ifLeft), std::forward<FR>(ifRight));
+		}
+
+		template <typename FL, typename FR>
+		constexpr MatchResult<FL, FR, const L&, const R&> Match(FL&& ifLeft, FR&& ifRight) const &
+		{
+			return MatchImpl(*this, std::forward<FL>(ifLeft), std::forward<FR>(ifRight));
+		}
+
+		template <typename FL, typename FR>
+		constexpr MatchResult<FL, FR, L&&, R&&> Match(FL&& ifLeft, FR&& ifRight) &&
+		{
+			return MatchImpl(std::move(*this), std::forward<FL>(ifLeft), std::forward<FR>(ifRight));
+		}
+
+		/**
+		 * \brief what left value to return if either contains right value.
+		 * Called on an rvalue either, the left value is moved out or the right value is moved into ifRight.
+		 * \param ifRight value to return if either contains right value
+		 * \return left value
+		 */
+		template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<L, F, R&>>>
+		constexpr L WhenRight(F&& ifRight) & { return WhenRightImpl(*this, std::forward<F>(ifRight)); }
+
+		template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<L, F, const R&>>>
+		constexpr L WhenRight(F&& ifRight) const & { return WhenRightImpl(*this, std::forward<F>(ifRight)); }
+
+		template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<L, F, R&&>>>
+		constexpr L WhenRight(F&& ifRight) && { return WhenRightImpl(std::move(*this), std::forward<F>(ifRight)); }
+
+		/**
+		 * \brief what right value to return if either contains a left value.
+		 * Called on an rvalue either, the right value is moved out or the left value is moved into ifLeft.
+		 * \param ifLeft what right value to return if either contains a left value
+		 * \return right value
+		 */
+		template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<R, F, L&>>>
+		constexpr R WhenLeft(F&& ifLeft) & { return WhenLeftImpl(*this, std::forward<F>(ifLeft)); }
+
+		template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<R, F, const L&>>>
+		constexpr R WhenLeft(F&& ifLeft) const & { return WhenLeftImpl(*this, std::forward<F>(ifLeft)); }
+
+		template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<R, F, L&&>>>
+		constexpr R WhenLeft(F&& ifLeft) && { return WhenLeftImpl(std::move(*this), std::forward<F>(ifLeft)); }
 
 		/**
 		 * \brief What left value to return 
@@ -55,21 +388,24 @@ namespace libmonad
 		 * \param ifRight what to return if either contains right value
 		 * \return left value
 		 */
-		L When(std::function<L(L)> ifLeft, std::function<L(R)> ifRight);
+		L When(std::function<L(L)> ifLeft, std::function<L(R)> ifRight) const &;
+		L When(std::function<L(L)> ifLeft, std::function<L(R)> ifRight) &&;
 
 		/**
 		 * \brief perform action depending on the type value
 		 * \param  ifLeft action to perform if Left
 		 * \param  ifRight action to perform if Right
 		 */
-		void Match(std::function<void(L)> ifLeft, std::function<void(R)> ifRight);
+		void Match(std::function<void(L)> ifLeft, std::function<void(R)> ifRight) const &;
+		void Match(std::function<void(L)> ifLeft, std::function<void(R)> ifRight) &&;
 
 		/**
 		 * \brief what left value to return if either contains right value
 		 * \param ifRight value to return if either contains right value
 		 * \return left value
 		 */
-		L WhenRight(std::function<L(R)> ifRight);		
+		L WhenRight(std::function<L(R)> ifRight) const &;
+		L WhenRight(std::function<L(R)> ifRight) &&;
 		
 		/**
 		 * \brief What right value to return
@@ -77,130 +413,399 @@ namespace libmonad
 		 * \param ifRight the right value to return if either contains the right value
 		 * \return right value
 		 */
-		R When(std::function<R(L)> ifLeft, std::function<R(R)> ifRight);
+		R When(std::function<R(L)> ifLeft, std::function<R(R)> ifRight) const &;
+		R When(std::function<R(L)> ifLeft, std::function<R(R)> ifRight) &&;
 
 		/**
 		 * \brief what right value to return if either contains a left value
 		 * \param ifLeft what right value to return if either contains a left value
 		 * \return right value
 		 */
-		R WhenLeft(std::function<R(L)> ifLeft);
+		R WhenLeft(std::function<R(L)> ifLeft) const &;
+		R WhenLeft(std::function<R(L)> ifLeft) &&;
 
 		/**
-		 * Returns right value by default or throws if left value
+		 * Returns right value by default or throws if left value (what happens exactly depends on LIBMONAD_ERROR_POLICY).
+		 * Called on an rvalue either, the right value is moved out.
 		 * @return 
 		 */
-		R ThrowIfLeft();
+		constexpr R& ThrowIfLeft() &;
+		constexpr const R& ThrowIfLeft() const &;
+		constexpr R ThrowIfLeft() &&;
 
 		/**
 		 * \brief Determine of either contains the left type value
 		 * \return true if either contains left value
 		 */
-		bool IsLeft() const;
+		constexpr bool IsLeft() const;
 
 		/**
 		 * \brief Determines of the either contains the right type value
 		 * \return true if the either contains a right value 
 		 */
-		bool IsRight() const;
+		constexpr bool IsRight() const;
 
 		/**
 		 * \brief Determines of either is initialized or not
 		 * \return true either not initialized - no value assigned to either
 		 */
-		bool IsBottom() const;
+		constexpr bool IsBottom() const;
+
+		/**
+		 * \brief Two eithers are equal if they hold the same type of value and those values are equal, or are both bottom
+		 * \return true if equal
+		 */
+		friend constexpr bool operator==(const Either& a, const Either& b)
+		{
+			if(a.state != b.state) { return false; }
+			if(a.state == State::Left) { return LeftOf(a) == LeftOf(b); }
+			if(a.state == State::Right) { return RightOf(a) == RightOf(b); }
+			return true;
+		}
 		
 	private:
-		void CheckIfInitialized() const;
-		L leftValue;
-		R rightValue;
-		
-		bool isLeft;
-		bool isBottom;
+		/**
+		 * \brief Which value, if any, the either currently holds
+		 */
+		enum class State : unsigned char { Bottom, Left, Right };
+
+		constexpr void CheckIfInitialized() const;
+
+		// The held value, forwarded with self's value category, or the object referred to when it is a reference
+
+		template <typename Self>
+		static constexpr ForwardLike<Self, L> LeftOf(Self&& self) { return EitherSlot<L>::Get(std::forward<Self>(self).leftValue); }
+
+		template <typename Self>
+		static constexpr ForwardLike<Self, R> RightOf(Self&& self) { return EitherSlot<R>::Get(std::forward<Self>(self).rightValue); }
+
+		// Each combinator is implemented once here, for self being an lvalue, const lvalue or rvalue either.
+		// The held value is forwarded with self's value category, so an rvalue either moves its value.
+
+		template <typename Self, typename F>
+		static constexpr auto MapImpl(Self&& self, F&& transform);
+
+		template <typename Self, typename F>
+		static constexpr auto BindImpl(Self&& self, F&& transform);
+
+		template <typename Self, typename FL, typename FR>
+		static constexpr decltype(auto) MatchImpl(Self&& self, FL&& ifLeft, FR&& ifRight);
+
+		template <typename Self, typename F>
+		static constexpr L WhenRightImpl(Self&& self, F&& ifRight);
+
+		template <typename Self, typename F>
+		static constexpr R WhenLeftImpl(Self&& self, F&& ifLeft);
+
+		/**
+		 * \brief Construct the value held by other into this either, which must be bottom
+		 */
+		template <typename Other>
+		constexpr void ConstructFrom(Other&& other);
+
+		/**
+		 * \brief Destroy the held value, if any, leaving the either bottom
+		 */
+		constexpr void Destroy() noexcept;
+
+		// Only the member named by state is alive, so the either is as large as its largest payload plus the tag
+		union
+		{
+			EitherSlot<L> leftValue;
+			EitherSlot<R> rightValue;
+		};
+
+		State state;
+
+		// Counts constructions, copies, moves and destructions when built with LIBMONAD_INSTRUMENT, and is nothing otherwise
+		LIBMONAD_NO_UNIQUE_ADDRESS detail::Counted<Either> counted;
 	};
 
 	template <typename L, typename R>
-	Either<L, R>::Either(L left): leftValue(left), isLeft(true), isBottom(false) {}
+	constexpr Either<L, R>::Either(L left): leftValue(std::in_place, std::forward<L>(left)), state(State::Left) {}
+
+	template <typename L, typename R>
+	constexpr Either<L, R>::Either(R right) : rightValue(std::in_place, std::forward<R>(right)), state(State::Right) {}
+
+	template <typename L, typename R>
+	constexpr Either<L, R>::Either() : state(State::Bottom) {}
+
+	template <typename L, typename R>
+	constexpr Either<L, R>::Either(const Either& other) : state(State::Bottom), counted(other.counted)
+	{
+		ConstructFrom(other);
+	}
+
+	template <typename L, typename R>
+	constexpr Either<L, R>::Either(Either&& other) noexcept(std::is_nothrow_move_constructible_v<L> && std::is_nothrow_move_constructible_v<R>)
+		: state(State::Bottom), counted(std::move(other.counted))
+	{
+		ConstructFrom(std::move(other));
+	}
+
+	template <typename L, typename R>
+	constexpr Either<L, R>& Either<L, R>::operator=(const Either& other)
+	{
+		if(this == &other) { return *this; }
+
+		counted = other.counted;
+		if(state == other.state)
+		{
+			if(state == State::Left) { leftValue = other.leftValue; }
+			else if(state == State::Right) { rightValue = other.rightValue; }
+			return *this;
+		}
+
+		Destroy();
+		ConstructFrom(other);
+		return *this;
+	}
+
+	template <typename L, typename R>
+	constexpr Either<L, R>& Either<L, R>::operator=(Either&& other) noexcept(std::is_nothrow_move_constructible_v<L> && std::is_nothrow_move_constructible_v<R>
+		&& std::is_nothrow_move_assignable_v<L> && std::is_nothrow_move_assignable_v<R>)
+	{
+		if(this == &other) { return *this; }
+
+		counted = std::move(other.counted);
+		if(state == other.state)
+		{
+			if(state == State::Left) { leftValue = std::move(other.leftValue); }
+			else if(state == State::Right) { rightValue = std::move(other.rightValue); }
+			return *this;
+		}
+
+		Destroy();
+		ConstructFrom(std::move(other));
+		return *this;
+	}
+
+	template <typename L, typename R>
+	constexpr Either<L, R>::~Either()
+	{
+		Destroy();
+	}
 
 	template <typename L, typename R>
-	Either<L, R>::Either(R right) : rightValue(right), isLeft(false), isBottom(false) {}
+	template <typename Other>
+	constexpr void Either<L, R>::ConstructFrom(Other&& other)
+	{
+		// Only set the state once the value exists, so a throwing copy leaves this either bottom
+		if(other.state == State::Left)
+		{
+			std::construct_at(std::addressof(leftValue), std::forward<Other>(other).leftValue);
+		}
+		else if(other.state == State::Right)
+		{
+			std::construct_at(std::addressof(rightValue), std::forward<Other>(other).rightValue);
+		}
+		state = other.state;
+	}
 
 	template <typename L, typename R>
-	Either<L, R>::Either() : isLeft(false), isBottom(true) {}
+	constexpr void Either<L, R>::Destroy() noexcept
+	{
+		if(state == State::Left) { std::destroy_at(std::addressof(leftValue)); }
+		else if(state == State::Right) { std::destroy_at(std::addressof(rightValue)); }
+		state = State::Bottom;
+	}
 
 	template <typename L, typename R>
 	template <typename T>
-	Either<L, T> Either<L, R>::Map(std::function<Either<L,T>(R)> transform)
+	Either<L, T> Either<L, R>::Map(std::function<Either<L,T>(R)> transform) const &
 	{
-		CheckIfInitialized();
-		if(isLeft) { return leftValue; }
-		return Either<L, T>(transform(rightValue));;
+		return MapImpl(*this, std::move(transform));
 	}
 
 	template <typename L, typename R>
 	template <typename T>
-	Either<L, T> Either<L, R>::Bind(std::function<Either<L,T>(R)> transform)
+	Either<L, T> Either<L, R>::Map(std::function<Either<L,T>(R)> transform) &&
 	{
-		CheckIfInitialized();
-		if(isLeft) { return leftValue; }
-		return transform(rightValue);
-	}	
+		return MapImpl(std::move(*this), std::move(transform));
+	}
+
+	template <typename L, typename R>
+	template <typename T>
+	Either<L, T> Either<L, R>::Bind(std::function<Either<L,T>(R)> transform) const &
+	{
+		return BindImpl(*this, std::move(transform));
+	}
 
 	template <typename L, typename R>
-	void Either<L, R>::CheckIfInitialized() const
+	template <typename T>
+	Either<L, T> Either<L, R>::Bind(std::function<Either<L,T>(R)> transform) &&
 	{
-		if(isBottom) { throw std::exception("Either is not initialized. Assign it a value");}
+		return BindImpl(std::move(*this), std::move(transform));
 	}
 
 	template <typename L, typename R>
-	R Either<L, R>::When(std::function<R(L)> ifLeft, std::function<R(R)> ifRight )
+	template <typename Self, typename F>
+	constexpr auto Either<L, R>::MapImpl(Self&& self, F&& transform)
 	{
-		CheckIfInitialized();
-		return isLeft ? ifLeft(leftValue) : ifRight(rightValue);
+		using Result = MappedEither<L, std::decay_t<std::invoke_result_t<F, ForwardLike<Self, R>>>>;
+		static_assert(std::is_same_v<typename Result::LeftType, L>, "Map transformation must keep the left type");
+
+		LIBMONAD_INSTRUMENT_CALL("Either::Map");
+		self.CheckIfInitialized();
+		if(self.state == State::Left) LIBMONAD_LEFT_HINT { return Result(inPlaceLeft, LeftOf(std::forward<Self>(self))); }
+		return Result(std::invoke(std::forward<F>(transform), RightOf(std::forward<Self>(self))));
 	}
 
 	template <typename L, typename R>
-	L Either<L, R>::When(std::function<L(L)> ifLeft, std::function<L(R)> ifRight)
+	template <typename Self, typename F>
+	constexpr auto Either<L, R>::BindImpl(Self&& self, F&& transform)
 	{
-		CheckIfInitialized();
-		return isLeft ? ifLeft(leftValue) : ifRight(rightValue);
-	}	
+		using Result = std::decay_t<std::invoke_result_t<F, ForwardLike<Self, R>>>;
+		static_assert(IsEither<Result>::value, "Bind transformation must return an Either, use Map to return a plain value");
+		static_assert(std::is_same_v<typename Result::LeftType, L>, "Bind transformation must keep the left type");
+
+		LIBMONAD_INSTRUMENT_CALL("Either::Bind");
+		self.CheckIfInitialized();
+		if(self.state == State::Left) LIBMONAD_LEFT_HINT { return Result(inPlaceLeft, LeftOf(std::forward<Self>(self))); }
+		return Result(std::invoke(std::forward<F>(transform), RightOf(std::forward<Self>(self))));
+	}
 
 	template <typename L, typename R>
-	void Either<L, R>::Match(std::function<void(L)> ifLeft, std::function<void(R)> ifRight)
+	template <typename Self, typename FL, typename FR>
+	constexpr decltype(auto) Either<L, R>::MatchImpl(Self&& self, FL&& ifLeft, FR&& ifRight)
 	{
-		CheckIfInitialized();
-		isLeft ? ifLeft(leftValue) : ifRight(rightValue);
+		using Result = MatchResult<FL, FR, ForwardLike<Self, L>, ForwardLike<Self, R>>;
+
+		LIBMONAD_INSTRUMENT_CALL("Either::Match");
+		self.CheckIfInitialized();
+		if(self.state == State::Left) LIBMONAD_LEFT_HINT { return static_cast<Result>(std::invoke(std::forward<FL>(ifLeft), LeftOf(std::forward<Self>(self)))); }
+		return static_cast<Result>(std::invoke(std::forward<FR>(ifRight), RightOf(std::forward<Self>(self))));
+	}
+
+	template <typename L, typename R>
+	template <typename Self, typename F>
+	constexpr L Either<L, R>::WhenRightImpl(Self&& self, F&& ifRight)
+	{
+		LIBMONAD_INSTRUMENT_CALL("Either::WhenRight");
+		self.CheckIfInitialized();
+		if(self.state == State::Left) LIBMONAD_LEFT_HINT { return LeftOf(std::forward<Self>(self)); }
+		return std::invoke(std::forward<F>(ifRight), RightOf(std::forward<Self>(self)));
+	}
+
+	template <typename L, typename R>
+	template <typename Self, typename F>
+	constexpr R Either<L, R>::WhenLeftImpl(Self&& self, F&& ifLeft)
+	{
+		LIBMONAD_INSTRUMENT_CALL("Either::WhenLeft");
+		self.CheckIfInitialized();
+		if(self.state == State::Left) LIBMONAD_LEFT_HINT { return std::invoke(std::forward<F>(ifLeft), LeftOf(std::forward<Self>(self))); }
+		return RightOf(std::forward<Self>(self));
+	}
+
+	template <typename L, typename R>
+	constexpr void Either<L, R>::CheckIfInitialized() const
+	{
+		if constexpr (ErrorsChecked)
+		{
+			if(state == State::Bottom) { Fail("Either is not initialized. Assign it a value"); }
+		}
+	}
+
+	template <typename L, typename R>
+	R Either<L, R>::When(std::function<R(L)> ifLeft, std::function<R(R)> ifRight) const &
+	{
+		return MatchImpl(*this, ifLeft, ifRight);
+	}
+
+	template <typename L, typename R>
+	R Either<L, R>::When(std::function<R(L)> ifLeft, std::function<R(R)> ifRight) &&
+	{
+		return MatchImpl(std::move(*this), ifLeft, ifRight);
+	}
+
+	template <typename L, typename R>
+	L Either<L, R>::When(std::function<L(L)> ifLeft, std::function<L(R)> ifRight) const &
+	{
+		return MatchImpl(*this, ifLeft, ifRight);
+	}
+
+	template <typename L, typename R>
+	L Either<L, R>::When(std::function<L(L)> ifLeft, std::function<L(R)> ifRight) &&
+	{
+		return MatchImpl(std::move(*this), ifLeft, ifRight);
+	}
+
+	template <typename L, typename R>
+	void Either<L, R>::Match(std::function<void(L)> ifLeft, std::function<void(R)> ifRight) const &
+	{
+		MatchImpl(*this, ifLeft, ifRight);
+	}
+
+	template <typename L, typename R>
+	void Either<L, R>::Match(std::function<void(L)> ifLeft, std::function<void(R)> ifRight) &&
+	{
+		MatchImpl(std::move(*this), ifLeft, ifRight);
+	}
+
+	template <typename L, typename R>
+	R Either<L, R>::WhenLeft(std::function<R(L)> ifLeft) const &
+	{
+		return WhenLeftImpl(*this, ifLeft);
+	}
+
+	template <typename L, typename R>
+	R Either<L, R>::WhenLeft(std::function<R(L)> ifLeft) &&
+	{
+		return WhenLeftImpl(std::move(*this), ifLeft);
+	}
+
+	template <typename L, typename R>
+	L Either<L, R>::WhenRight(std::function<L(R)> ifRight) const &
+	{
+		return WhenRightImpl(*this, ifRight);
+	}
+
+	template <typename L, typename R>
+	L Either<L, R>::WhenRight(std::function<L(R)> ifRight) &&
+	{
+		return WhenRightImpl(std::move(*this), ifRight);
 	}
 
 	template <typename L, typename R>
-	R Either<L, R>::WhenLeft(std::function<R(L)> ifLeft )
+	constexpr R& Either<L, R>::ThrowIfLeft() &
 	{
 		CheckIfInitialized();
-		return isLeft ? ifLeft(leftValue) : rightValue;
+		if constexpr (ErrorsChecked)
+		{
+			if (IsLeft()) { Fail("ThrowIfLeft"); }
+		}
+		return RightOf(*this);
 	}
 
 	template <typename L, typename R>
-	L Either<L, R>::WhenRight(std::function<L(R)> ifRight)
+	constexpr const R& Either<L, R>::ThrowIfLeft() const &
 	{
 		CheckIfInitialized();
-		return isLeft ? leftValue : ifRight(rightValue);
+		if constexpr (ErrorsChecked)
+		{
+			if (IsLeft()) { Fail("ThrowIfLeft"); }
+		}
+		return RightOf(*this);
 	}
 
 	template <typename L, typename R>
-	R Either<L, R>::ThrowIfLeft()
+	constexpr R Either<L, R>::ThrowIfLeft() &&
 	{
-		if (IsLeft()) throw std::exception("ThrowIfLeft");
-		return rightValue;
+		CheckIfInitialized();
+		if constexpr (ErrorsChecked)
+		{
+			if (IsLeft()) { Fail("ThrowIfLeft"); }
+		}
+		return RightOf(std::move(*this));
 	}
 
 	template <typename L, typename R>
-	bool Either<L, R>::IsLeft() const { return !isBottom && isLeft; }
+	constexpr bool Either<L, R>::IsLeft() const { return state == State::Left; }
 
 	template <typename L, typename R>
-	bool Either<L, R>::IsRight() const { return !isBottom && !isLeft; }
+	constexpr bool Either<L, R>::IsRight() const { return state == State::Right; }
 
 	template <typename L, typename R>
-	bool Either<L, R>::IsBottom() const { return isBottom; }
+	constexpr bool Either<L, R>::IsBottom() const { return state == State::Bottom; }
 }
 
@@ -0,0 +1,369 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Bitmap.h"
+#include "Either.h"
+
+namespace libmonad
+{
+	/**
+	 * \brief A column of eithers stored as separate arrays rather than as std::vector<Either<L, R>>.
+	 * A bitmap says which elements are right, right values are stored at their own index in one dense array,
+	 * and left values, expected to be rare, are stored in index order in another alongside their indices.
+	 * Bulk Map, Bind and Match scan the bitmap a word at a time, skipping 64 lefts at once.
+	 * \tparam L Left type
+	 * \tparam R Right type, which must be default constructible to fill the slots of left elements
+	 */
+	template <typename L, typename R>
+	class EitherColumn
+	{
+	public:
+		EitherColumn() = default;
+
+		/**
+		 * \brief Copies a vector of eithers into a column
+		 * \param eithers eithers to copy, none of which may be bottom
+		 */
+		explicit EitherColumn(const std::vector<Either<L, R>>& eithers);
+
+		/**
+		 * \brief Moves a vector of eithers into a column
+		 * \param eithers eithers to move from, none of which may be bottom
+		 */
+		explicit EitherColumn(std::vector<Either<L, R>>&& eithers);
+
+		/**
+		 * \brief Adds an either to the end of the column
+		 * \param either either to add, which must not be bottom
+		 */
+		void PushBack(Either<L, R> either);
+
+		void PushLeft(L left);
+		void PushRight(R right);
+
+		/**
+		 * \brief Number of elements
+		 */
+		std::size_t Size() const { return rightBits.Size(); }
+
+		/**
+		 * \brief Number of right elements, counted a word of the bitmap at a time
+		 */
+		std::size_t RightCount() const { return rightBits.Count(); }
+
+		/**
+		 * \brief Number of left elements
+		 */
+		std::size_t LeftCount() const { return lefts.size(); }
+
+		bool IsLeft(const std::size_t i) const { return !rightBits.Test(i); }
+		bool IsRight(const std::size_t i) const { return rightBits.Test(i); }
+
+		/**
+		 * \brief Copies out element i
+		 * \param i index of the element
+		 * \return element i as an either
+		 */
+		Either<L, R> At(std::size_t i) const;
+
+		/**
+		 * \brief Which elements are right
+		 */
+		const ValidityBitmap& RightBits() const { return rightBits; }
+
+		/**
+		 * \brief The right value of every element, at its own index. The values of left elements are default constructed and meaningless.
+		 */
+		const std::vector<R>& Rights() const { return rights; }
+
+		/**
+		 * \brief The indices of the left elements, in order
+		 */
+		const std::vector<std::size_t>& LeftIndices() const { return leftIndices; }
+
+		/**
+		 * \brief The left values, in the same order as their indices
+		 */
+		const std::vector<L>& Lefts() const { return lefts; }
+
+		/**
+		 * \brief Transforms every right value, carrying left values over unchanged.
+		 * Called on an rvalue column, right values are moved into the transformation and left values are moved over.
+		 * \tparam F transformation function that takes a right value and returns a T or an Either<L, T>
+		 * \param transform transformation function
+		 * \return EitherColumn<L, T>
+		 */
+		template <typename F>
+		auto Map(F&& transform) const & { return MapImpl(*this, std::forward<F>(transform)); }
+
+		template <typename F>
+		auto Map(F&& transform) && { return MapImpl(std::move(*this), std::forward<F>(transform)); }
+
+		/**
+		 * \brief Transforms every right value into an either, so elements can become left.
+		 * Called on an rvalue column, right values are moved into the transformation and left values are moved over.
+		 * \tparam F transformation function that takes a right value and returns an Either<L, T>
+		 * \param transform transformation function
+		 * \return EitherColumn<L, T>
+		 */
+		template <typename F>
+		auto Bind(F&& transform) const & { return BindImpl(*this, std::forward<F>(transform)); }
+
+		template <typename F>
+		auto Bind(F&& transform) && { return BindImpl(std::move(*this), std::forward<F>(transform)); }
+
+		/**
+		 * \brief Performs an action for every element, in order, depending on whether it is left or right
+		 * \param ifLeft action to perform with a left value
+		 * \param ifRight action to perform with a right value
+		 */
+		template <typename FL, typename FR>
+		void Match(FL&& ifLeft, FR&& ifRight) const;
+
+		/**
+		 * \brief Performs an action for every right value, in order, skipping left values a word at a time
+		 * \param ifRight action to perform with a right value
+		 */
+		template <typename F>
+		void WhenRight(F&& ifRight) const;
+
+		/**
+		 * \brief Converts the column back into a vector of eithers
+		 * \return one either per element
+		 */
+		std::vector<Either<L, R>> ToVector() const &;
+		std::vector<Either<L, R>> ToVector() &&;
+
+		friend bool operator==(const EitherColumn& a, const EitherColumn& b)
+		{
+			if(a.rightBits != b.rightBits || a.leftIndices != b.leftIndices || a.lefts != b.lefts) { return false; }
+			bool equal = true;
+			a.rightBits.ForEachSet([&](const std::size_t i) { equal = equal && a.rights[i] == b.rights[i]; });
+			return equal;
+		}
+
+	private:
+		template <typename L2, typename R2>
+		friend class EitherColumn;
+
+		template <typename Self, typename F>
+		static auto MapImpl(Self&& self, F&& transform);
+
+		template <typename Self, typename F>
+		static auto BindImpl(Self&& self, F&& transform);
+
+		template <typename Self>
+		static std::vector<Either<L, R>> ToVectorImpl(Self&& self);
+
+		/**
+		 * \brief Merges the lefts a Bind produced into the lefts carried over, keeping them in index order
+		 */
+		template <typename Carried>
+		void MergeLefts(const std::vector<std::size_t>& carriedIndices, Carried&& carried, std::vector<std::size_t>&& newIndices, std::vector<L>&& newLefts);
+
+		ValidityBitmap rightBits;
+		std::vector<R> rights;
+		std::vector<std::size_t> leftIndices;
+		std::vector<L> lefts;
+	};
+
+	template <typename L, typename R>
+	EitherColumn<L, R>::EitherColumn(const std::vector<Either<L, R>>& eithers)
+	{
+		rightBits.Reserve(eithers.size());
+		rights.reserve(eithers.size());
+		for(const auto& either : eithers) { PushBack(either); }
+	}
+
+	template <typename L, typename R>
+	EitherColumn<L, R>::EitherColumn(std::vector<Either<L, R>>&& eithers)
+	{
+		rightBits.Reserve(eithers.size());
+		rights.reserve(eithers.size());
+		for(auto& either : eithers) { PushBack(std::move(either)); }
+	}
+
+	template <typename L, typename R>
+	void EitherColumn<L, R>::PushBack(Either<L, R> either)
+	{
+		std::move(either).Match(
+			[this](L&& left) { PushLeft(std::move(left)); },
+			[this](R&& right) { PushRight(std::move(right)); });
+	}
+
+	template <typename L, typename R>
+	void EitherColumn<L, R>::PushLeft(L left)
+	{
+		leftIndices.push_back(Size());
+		lefts.push_back(std::move(left));
+		rights.emplace_back();
+		rightBits.PushBack(false);
+	}
+
+	template <typename L, typename R>
+	void EitherColumn<L, R>::PushRight(R right)
+	{
+		rights.push_back(std::move(right));
+		rightBits.PushBack(true);
+	}
+
+	template <typename L, typename R>
+	Either<L, R> EitherColumn<L, R>::At(const std::size_t i) const
+	{
+		if(rightBits.Test(i)) { return rights[i]; }
+		const auto left = std::lower_bound(leftIndices.begin(), leftIndices.end(), i);
+		return lefts[left - leftIndices.begin()];
+	}
+
+	template <typename L, typename R>
+	template <typename Self, typename F>
+	auto EitherColumn<L, R>::MapImpl(Self&& self, F&& transform)
+	{
+		using T = std::decay_t<std::invoke_result_t<F&, ForwardLike<Self, R>>>;
+		if constexpr (IsEither<T>::value)
+		{
+			return BindImpl(std::forward<Self>(self), std::forward<F>(transform));
+		}
+		else if constexpr (std::is_same_v<T, R> && !std::is_lvalue_reference_v<Self>)
+		{
+			// An rvalue column mapped to the same type is transformed in place, reusing its arrays
+			self.rightBits.ForEachSet([&](const std::size_t i)
+			{
+				self.rights[i] = std::invoke(transform, std::move(self.rights[i]));
+			});
+			return std::move(self);
+		}
+		else
+		{
+			EitherColumn<L, T> result;
+			result.rightBits = self.rightBits;
+			result.rights.resize(self.Size());
+			self.rightBits.ForEachSet([&](const std::size_t i)
+			{
+				result.rights[i] = std::invoke(transform, static_cast<ForwardLike<Self, R>>(self.rights[i]));
+			});
+			result.leftIndices = self.leftIndices;
+			result.lefts = std::forward<Self>(self).lefts;
+			return result;
+		}
+	}
+
+	template <typename L, typename R>
+	template <typename Self, typename F>
+	auto EitherColumn<L, R>::BindImpl(Self&& self, F&& transform)
+	{
+		using Result = std::decay_t<std::invoke_result_t<F&, ForwardLike<Self, R>>>;
+		static_assert(IsEither<Result>::value, "Bind transformation must return an Either, use Map to return a plain value");
+		static_assert(std::is_same_v<typename Result::LeftType, L>, "Bind transformation must keep the left type");
+		using T = typename Result::RightType;
+		constexpr bool inPlace = std::is_same_v<T, R> && !std::is_lvalue_reference_v<Self>;
+
+		// An rvalue column bound to the same type is transformed in place, reusing its arrays
+		EitherColumn<L, T> result;
+		auto& target = [&]() -> EitherColumn<L, T>& { if constexpr (inPlace) { return self; } else { return result; } }();
+		if constexpr (!inPlace)
+		{
+			result.rightBits = self.rightBits;
+			result.rights.resize(self.Size());
+		}
+
+		std::vector<std::size_t> newIndices;
+		std::vector<L> newLefts;
+		self.rightBits.ForEachSet([&](const std::size_t i)
+		{
+			std::invoke(transform, static_cast<ForwardLike<Self, R>>(self.rights[i])).Match(
+				[&](L&& left)
+				{
+					target.rightBits.Reset(i);
+					newIndices.push_back(i);
+					newLefts.push_back(std::move(left));
+				},
+				[&](T&& right) { target.rights[i] = std::move(right); });
+		});
+
+		if constexpr (inPlace)
+		{
+			if(newLefts.empty()) { return std::move(self); }
+			result.rightBits = std::move(self.rightBits);
+			result.rights = std::move(self.rights);
+		}
+		result.MergeLefts(self.leftIndices, std::forward<Self>(self).lefts, std::move(newIndices), std::move(newLefts));
+		return result;
+	}
+
+	template <typename L, typename R>
+	template <typename Carried>
+	void EitherColumn<L, R>::MergeLefts(const std::vector<std::size_t>& carriedIndices, Carried&& carried, std::vector<std::size_t>&& newIndices, std::vector<L>&& newLefts)
+	{
+		if(newLefts.empty())
+		{
+			leftIndices = carriedIndices;
+			lefts = std::forward<Carried>(carried);
+			return;
+		}
+
+		leftIndices.reserve(carriedIndices.size() + newIndices.size());
+		lefts.reserve(carriedIndices.size() + newIndices.size());
+
+		std::size_t c = 0, n = 0;
+		while(c < carriedIndices.size() || n < newIndices.size())
+		{
+			if(n == newIndices.size() || (c < carriedIndices.size() && carriedIndices[c] < newIndices[n]))
+			{
+				leftIndices.push_back(carriedIndices[c]);
+				lefts.push_back(static_cast<ForwardLike<Carried, L>>(carried[c++]));
+			}
+			else
+			{
+				leftIndices.push_back(newIndices[n]);
+				lefts.push_back(std::move(newLefts[n++]));
+			}
+		}
+	}
+
+	template <typename L, typename R>
+	template <typename FL, typename FR>
+	void EitherColumn<L, R>::Match(FL&& ifLeft, FR&& ifRight) const
+	{
+		std::size_t left = 0;
+		rightBits.ForEach(
+			[&](const std::size_t i) { std::invoke(ifRight, rights[i]); },
+			[&](std::size_t) { std::invoke(ifLeft, lefts[left++]); });
+	}
+
+	template <typename L, typename R>
+	template <typename F>
+	void EitherColumn<L, R>::WhenRight(F&& ifRight) const
+	{
+		rightBits.ForEachSet([&](const std::size_t i) { std::invoke(ifRight, rights[i]); });
+	}
+
+	template <typename L, typename R>
+	std::vector<Either<L, R>> EitherColumn<L, R>::ToVector() const &
+	{
+		return ToVectorImpl(*this);
+	}
+
+	template <typename L, typename R>
+	std::vector<Either<L, R>> EitherColumn<L, R>::ToVector() &&
+	{
+		return ToVectorImpl(std::move(*this));
+	}
+
+	template <typename L, typename R>
+	template <typename Self>
+	std::vector<Either<L, R>> EitherColumn<L, R>::ToVectorImpl(Self&& self)
+	{
+		std::vector<Either<L, R>> eithers;
+		eithers.reserve(self.Size());
+		std::size_t left = 0;
+		self.rightBits.ForEach(
+			[&](const std::size_t i) { eithers.emplace_back(static_cast<ForwardLike<Self, R>>(self.rights[i])); },
+			[&](std::size_t) { eithers.emplace_back(static_cast<ForwardLike<Self, L>>(self.lefts[left++])); });
+		return eithers;
+	}
+}
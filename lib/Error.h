@@ -0,0 +1,195 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#include "Either.h"
+#include "Option.h"
+
+namespace libmonad
+{
+	/**
+	 * \brief Identifies an error message interned with RegisterError. Code 0 is reserved for an unknown error.
+	 */
+	struct ErrorCode
+	{
+		std::uint32_t value = 0;
+
+		friend constexpr bool operator==(ErrorCode a, ErrorCode b) { return a.value == b.value; }
+	};
+
+	namespace detail
+	{
+		class ErrorRegistry
+		{
+		public:
+			static ErrorRegistry& Instance()
+			{
+				static ErrorRegistry registry;
+				return registry;
+			}
+
+			ErrorCode Register(const std::string_view message)
+			{
+				std::lock_guard lock(mutex);
+				if(const auto found = codes.find(message); found != codes.end()) { return found->second; }
+				const auto& interned = messages.emplace_back(message);
+				const ErrorCode code{ static_cast<std::uint32_t>(messages.size()) };
+				codes.emplace(interned, code);
+				return code;
+			}
+
+			std::string_view Message(const ErrorCode code)
+			{
+				std::lock_guard lock(mutex);
+				if(code.value == 0 || code.value > messages.size()) { return {}; }
+				return messages[code.value - 1];
+			}
+
+		private:
+			std::mutex mutex;
+			std::deque<std::string> messages;
+			std::unordered_map<std::string_view, ErrorCode> codes;
+		};
+	}
+
+	/**
+	 * \brief Interns an error message, eg. inline const ErrorCode NotFound = RegisterError("not found");
+	 * Registering the same message again gives the same code.
+	 * \param message message the code stands for
+	 * \return code for the message
+	 */
+	inline ErrorCode RegisterError(const std::string_view message)
+	{
+		return detail::ErrorRegistry::Instance().Register(message);
+	}
+
+	/**
+	 * \brief A cheap left value: a code for an interned message plus a little context, either up to 11 characters of text
+	 * or an integer such as an index or errno. It is 16 bytes, trivially copyable and never allocates.
+	 * The message is only looked up and formatted when it is printed.
+	 */
+	class Error
+	{
+	public:
+		static constexpr std::size_t MaxContextLength = 11;
+
+		constexpr Error() = default;
+
+		/**
+		 * \brief An error with no context
+		 * \param code code of the error
+		 */
+		constexpr Error(const ErrorCode code) : code(code) {}
+
+		/**
+		 * \brief An error with text for context, cut short at MaxContextLength characters
+		 * \param code code of the error
+		 * \param context eg. the name of what was not found
+		 */
+		Error(ErrorCode code, std::string_view context);
+
+		/**
+		 * \brief An error with an integer for context
+		 * \param code code of the error
+		 * \param context eg. the index of what failed
+		 */
+		Error(ErrorCode code, std::int64_t context);
+
+		constexpr ErrorCode Code() const { return code; }
+
+		/**
+		 * \brief The context given as text, if any
+		 */
+		Option<std::string_view> Text() const;
+
+		/**
+		 * \brief The context given as an integer, if any
+		 */
+		Option<std::int64_t> Integer() const;
+
+		/**
+		 * \brief Formats the error, eg. "not found: config.json" or "bad record (42)"
+		 * \return the message and its context
+		 */
+		std::string Message() const;
+
+		friend bool operator==(const Error& a, const Error& b)
+		{
+			return a.code == b.code && a.context == b.context && std::memcmp(a.buffer, b.buffer, sizeof a.buffer) == 0;
+		}
+
+		friend std::ostream& operator<<(std::ostream& stream, const Error& error) { return stream << error.Message(); }
+
+	private:
+		// What the buffer holds: nothing, 1 to MaxContextLength characters of text, or an integer
+		static constexpr std::uint8_t NoContext = 0;
+		static constexpr std::uint8_t IntegerContext = 0xff;
+
+		ErrorCode code;
+		std::uint8_t context = NoContext;
+		char buffer[MaxContextLength] = {};
+	};
+
+	static_assert(sizeof(Error) <= 16 && std::is_trivially_copyable_v<Error>, "Error must stay small and trivially copyable");
+
+	inline Error::Error(const ErrorCode code, const std::string_view context) : code(code)
+	{
+		const auto length = std::min(context.size(), MaxContextLength);
+		std::memcpy(buffer, context.data(), length);
+		this->context = static_cast<std::uint8_t>(length);
+	}
+
+	inline Error::Error(const ErrorCode code, const std::int64_t context) : code(code), context(IntegerContext)
+	{
+		std::memcpy(buffer, &context, sizeof context);
+	}
+
+	inline Option<std::string_view> Error::Text() const
+	{
+		if(context == NoContext || context == IntegerContext) { return None(); }
+		return std::string_view(buffer, context);
+	}
+
+	inline Option<std::int64_t> Error::Integer() const
+	{
+		if(context != IntegerContext) { return None(); }
+		std::int64_t value;
+		std::memcpy(&value, buffer, sizeof value);
+		return value;
+	}
+
+	inline std::string Error::Message() const
+	{
+		const auto registered = detail::ErrorRegistry::Instance().Message(code);
+		std::string message = registered.empty() ? "error " + std::to_string(code.value) : std::string(registered);
+		if(context == IntegerContext) { message += " (" + std::to_string(Integer().ThrowIfNone()) + ")"; }
+		else if(context != NoContext) { message.append(": ").append(buffer, context); }
+		return message;
+	}
+
+	/**
+	 * \brief An Either whose left value is an Error, eg. ErrorOr<long> Parse(std::string_view text)
+	 */
+	template <typename T>
+	using ErrorOr = Either<Error, T>;
+
+	/**
+	 * \brief Turns an option into an either, with the given error in place of none
+	 * \param option option to convert
+	 * \param error left value if the option is none
+	 * \return the option's value, or the error
+	 */
+	template <typename T>
+	ErrorOr<T> OrError(Option<T> option, const Error error)
+	{
+		return std::move(option).Match([&](None) { return ErrorOr<T>(error); }, [](T&& value) { return ErrorOr<T>(std::move(value)); });
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#if !defined(__cpp_exceptions) && !defined(_CPPUNWIND)
+#define LIBMONAD_NO_EXCEPTIONS
+#else
+#include <stdexcept>
+#endif
+
+/*
+ * What happens when a bottom Either is used, or ThrowIfLeft/ThrowIfNone find no value to return.
+ * Define LIBMONAD_ERROR_POLICY to one of these before including any libmonad header, or pass it to the compiler:
+ *
+ * LIBMONAD_ERROR_POLICY_THROW   throws std::runtime_error with the message (the default, unless exceptions are disabled)
+ * LIBMONAD_ERROR_POLICY_ABORT   writes the message to stderr and aborts (the default when exceptions are disabled)
+ * LIBMONAD_ERROR_POLICY_ASSERT  aborts with the message in debug builds; in release (NDEBUG) builds nothing is checked at all
+ * LIBMONAD_ERROR_POLICY_HANDLER calls the function given to SetErrorHandler, then aborts if it returns
+ */
+#define LIBMONAD_ERROR_POLICY_THROW 0
+#define LIBMONAD_ERROR_POLICY_ABORT 1
+#define LIBMONAD_ERROR_POLICY_ASSERT 2
+#define LIBMONAD_ERROR_POLICY_HANDLER 3
+
+#ifndef LIBMONAD_ERROR_POLICY
+#ifdef LIBMONAD_NO_EXCEPTIONS
+#define LIBMONAD_ERROR_POLICY LIBMONAD_ERROR_POLICY_ABORT
+#else
+#define LIBMONAD_ERROR_POLICY LIBMONAD_ERROR_POLICY_THROW
+#endif
+#endif
+
+#if LIBMONAD_ERROR_POLICY == LIBMONAD_ERROR_POLICY_THROW && defined(LIBMONAD_NO_EXCEPTIONS)
+#error "LIBMONAD_ERROR_POLICY_THROW needs exceptions, choose another error policy"
+#endif
+
+#if LIBMONAD_ERROR_POLICY == LIBMONAD_ERROR_POLICY_ASSERT && defined(NDEBUG)
+#define LIBMONAD_ERRORS_CHECKED 0
+#else
+#define LIBMONAD_ERRORS_CHECKED 1
+#endif
+
+namespace libmonad
+{
+	/**
+	 * \brief Whether the error policy checks for errors at all. When false, using a bottom either or
+	 * extracting a value that is not there is undefined behaviour, and the checks are compiled out
+	 */
+	inline constexpr bool ErrorsChecked = LIBMONAD_ERRORS_CHECKED;
+
+	/**
+	 * \brief Function called with the error message under LIBMONAD_ERROR_POLICY_HANDLER
+	 */
+	using ErrorHandler = void (*)(const char* message);
+
+	/**
+	 * \brief The error handler LIBMONAD_ERROR_POLICY_HANDLER calls
+	 * \return the handler, or nullptr if none has been set
+	 */
+	inline ErrorHandler& CurrentErrorHandler()
+	{
+		static ErrorHandler handler = nullptr;
+		return handler;
+	}
+
+	/**
+	 * \brief Sets the error handler LIBMONAD_ERROR_POLICY_HANDLER calls
+	 * \param handler function to call with the error message
+	 * \return the previous handler
+	 */
+	inline ErrorHandler SetErrorHandler(const ErrorHandler handler)
+	{
+		const auto previous = CurrentErrorHandler();
+		CurrentErrorHandler() = handler;
+		return previous;
+	}
+
+	/**
+	 * \brief Reports an error according to the error policy. Does not return
+	 * \param message what went wrong
+	 */
+	[[noreturn]] inline void Fail(const char* message)
+	{
+#if LIBMONAD_ERROR_POLICY == LIBMONAD_ERROR_POLICY_THROW
+		throw std::runtime_error(message);
+#else
+#if LIBMONAD_ERROR_POLICY == LIBMONAD_ERROR_POLICY_HANDLER
+		if(const auto handler = CurrentErrorHandler()) { handler(message); }
+#endif
+		std::fprintf(stderr, "libmonad: %s\n", message);
+		std::abort();
+#endif
+	}
+
+	[[noreturn]] inline void Fail(const std::string& message)
+	{
+		Fail(message.c_str());
+	}
+}
@@ -0,0 +1,298 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace libmonad
+{
+	/**
+	 * \brief A piece of work to run on an executor. The executor keeps only a pointer to it, so posting it allocates nothing
+	 * (beyond a work stealing executor's deque growing now and then): it must stay alive until it has run.
+	 */
+	struct Work
+	{
+		/**
+		 * \brief Function the executor calls with the work
+		 */
+		void (*run)(Work& work);
+
+		/**
+		 * \brief Links the work into an executor's list while it waits to run
+		 */
+		Work* next = nullptr;
+	};
+
+	/**
+	 * \brief Runs work, eg. the Map, Bind and Match stages of an Async once their value has arrived
+	 */
+	class Executor
+	{
+	public:
+		virtual ~Executor() = default;
+
+		/**
+		 * \brief Runs the work, now or later, on this thread or another. Completing an Async posts the stages waiting for it
+		 * from the completing thread, so this should not block.
+		 * \param work work to run
+		 */
+		virtual void Post(Work& work) = 0;
+	};
+
+	/**
+	 * \brief Runs work straight away on the thread that posts it
+	 */
+	class InlineExecutor final : public Executor
+	{
+	public:
+		void Post(Work& work) override { work.run(work); }
+	};
+
+	namespace detail
+	{
+		/**
+		 * \brief A Chase-Lev deque of work: the thread that owns it pushes and pops at the bottom, and other threads steal from the top,
+		 * all without a lock (Lê, Pop, Cohen and Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models", 2013).
+		 * It grows when full, and keeps the arrays it has outgrown until it is destroyed, as a thief may still be reading one.
+		 */
+		class WorkDeque
+		{
+		public:
+			explicit WorkDeque(const std::size_t capacity = 256) { Grow(capacity, 0, 0); }
+
+			WorkDeque(const WorkDeque&) = delete;
+			WorkDeque& operator=(const WorkDeque&) = delete;
+
+			/**
+			 * \brief Adds work at the bottom. Only the owner may call it.
+			 */
+			void Push(Work* work)
+			{
+				const auto b = bottom.load(std::memory_order_relaxed);
+				const auto t = top.load(std::memory_order_acquire);
+				auto* array = current.load(std::memory_order_relaxed);
+				if(b - t > static_cast<std::int64_t>(array->mask)) { array = Grow((array->mask + 1) * 2, t, b); }
+				array->slots[static_cast<std::size_t>(b) & array->mask].store(work, std::memory_order_relaxed);
+				bottom.store(b + 1, std::memory_order_release);
+			}
+
+			/**
+			 * \brief Takes the newest work from the bottom. Only the owner may call it.
+			 * \return the work, or nullptr if there is none
+			 */
+			Work* Pop()
+			{
+				const auto b = bottom.load(std::memory_order_relaxed) - 1;
+				const auto* array = current.load(std::memory_order_relaxed);
+				bottom.store(b, std::memory_order_seq_cst);
+				auto t = top.load(std::memory_order_seq_cst);
+				if(t > b)
+				{
+					bottom.store(b + 1, std::memory_order_release);
+					return nullptr;
+				}
+				auto* work = array->slots[static_cast<std::size_t>(b) & array->mask].load(std::memory_order_relaxed);
+				if(t == b)
+				{
+					// The last one, which a thief may be taking too
+					if(!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) { work = nullptr; }
+					bottom.store(b + 1, std::memory_order_release);
+				}
+				return work;
+			}
+
+			/**
+			 * \brief Takes the oldest work from the top. Any thread may call it.
+			 * \param contended set when another thread took the work first, so there may be more to steal
+			 * \return the work, or nullptr if there is none or another thread took it first
+			 */
+			Work* Steal(bool& contended)
+			{
+				auto t = top.load(std::memory_order_seq_cst);
+				const auto b = bottom.load(std::memory_order_seq_cst);
+				if(t >= b) { return nullptr; }
+				const auto* array = current.load(std::memory_order_acquire);
+				auto* work = array->slots[static_cast<std::size_t>(t) & array->mask].load(std::memory_order_relaxed);
+				if(!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				{
+					contended = true;
+					return nullptr;
+				}
+				return work;
+			}
+
+		private:
+			struct Array
+			{
+				explicit Array(const std::size_t capacity) : mask(capacity - 1), slots(std::make_unique<std::atomic<Work*>[]>(capacity)) {}
+
+				const std::size_t mask;
+				std::unique_ptr<std::atomic<Work*>[]> slots;
+			};
+
+			// Copies the work between top and bottom into an array twice the size, and makes it the current one
+			Array* Grow(const std::size_t capacity, const std::int64_t t, const std::int64_t b)
+			{
+				auto* grown = arrays.emplace_back(std::make_unique<Array>(capacity)).get();
+				if(const auto* old = current.load(std::memory_order_relaxed))
+				{
+					for(auto i = t; i < b; i++)
+					{
+						grown->slots[static_cast<std::size_t>(i) & grown->mask].store(
+							old->slots[static_cast<std::size_t>(i) & old->mask].load(std::memory_order_relaxed), std::memory_order_relaxed);
+					}
+				}
+				current.store(grown, std::memory_order_release);
+				return grown;
+			}
+
+			// Apart, so thieves moving the top do not slow the owner moving the bottom
+			alignas(64) std::atomic<std::int64_t> top{0};
+			alignas(64) std::atomic<std::int64_t> bottom{0};
+			std::atomic<Array*> current{nullptr};
+			std::vector<std::unique_ptr<Array>> arrays;
+		};
+	}
+
+	/**
+	 * \brief A fixed number of threads, each with its own deque of work. A thread runs the work it posts itself first, newest first,
+	 * and once its own deque is empty takes the work posted from outside, then steals the oldest work from the other threads' deques.
+	 * Posting takes no lock: a thread pushes onto its own deque, and other threads push onto a shared list that the executor's
+	 * threads take whole. A sleeping thread is only woken if there is one.
+	 */
+	class WorkStealingExecutor final : public Executor
+	{
+	public:
+		/**
+		 * \brief Starts the threads
+		 * \param threads number of threads, by default one per hardware thread
+		 */
+		explicit WorkStealingExecutor(std::size_t threads = std::thread::hardware_concurrency());
+
+		/**
+		 * \brief Runs the work already posted, then stops the threads
+		 */
+		~WorkStealingExecutor() override;
+
+		WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+		WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+		/**
+		 * \brief Number of threads
+		 */
+		std::size_t Size() const { return queueCount; }
+
+		void Post(Work& work) override;
+
+	private:
+		void Run(std::size_t index);
+		Work* Take(std::size_t index);
+
+		// Which executor's thread, if any, the calling thread is, and its deque
+		static inline thread_local const WorkStealingExecutor* current = nullptr;
+		static inline thread_local std::size_t currentQueue = 0;
+
+		// Fixed before any thread starts, as the threads read it while the others are still being started
+		const std::size_t queueCount;
+		std::unique_ptr<detail::WorkDeque[]> queues;
+		std::vector<std::thread> threads;
+
+		// Work posted from threads that are not the executor's, newest first, linked through Work::next
+		alignas(64) std::atomic<Work*> posted{nullptr};
+
+		// Changes whenever work is posted, so a thread that found no work can sleep until some may have arrived
+		alignas(64) std::atomic<std::uint32_t> postings{0};
+		std::atomic<std::uint32_t> sleeping{0};
+		std::atomic<bool> stopping{false};
+	};
+
+	inline WorkStealingExecutor::WorkStealingExecutor(const std::size_t threads)
+		: queueCount(threads == 0 ? 1 : threads), queues(std::make_unique<detail::WorkDeque[]>(queueCount))
+	{
+		this->threads.reserve(queueCount);
+		for(std::size_t i = 0; i < queueCount; i++) { this->threads.emplace_back([this, i] { Run(i); }); }
+	}
+
+	inline WorkStealingExecutor::~WorkStealingExecutor()
+	{
+		stopping.store(true, std::memory_order_seq_cst);
+		postings.fetch_add(1, std::memory_order_seq_cst);
+		postings.notify_all();
+		for(auto& thread : threads) { thread.join(); }
+	}
+
+	inline void WorkStealingExecutor::Post(Work& work)
+	{
+		if(current == this) { queues[currentQueue].Push(&work); }
+		else
+		{
+			auto* head = posted.load(std::memory_order_relaxed);
+			do { work.next = head; }
+			while(!posted.compare_exchange_weak(head, &work, std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		// Pairs with a sleeping thread counting itself before it checks postings one last time, so one of them sees the other
+		postings.fetch_add(1, std::memory_order_seq_cst);
+		if(sleeping.load(std::memory_order_seq_cst) != 0) { postings.notify_one(); }
+	}
+
+	inline Work* WorkStealingExecutor::Take(const std::size_t index)
+	{
+		auto& own = queues[index];
+		for(;;)
+		{
+			if(const auto work = own.Pop()) { return work; }
+
+			// Newest first, so pushing them in turn leaves the oldest at the bottom to be popped first
+			if(posted.load(std::memory_order_relaxed) != nullptr)
+			{
+				for(auto* work = posted.exchange(nullptr, std::memory_order_acquire); work != nullptr;)
+				{
+					const auto next = work->next;
+					own.Push(work);
+					work = next;
+				}
+				continue;
+			}
+
+			auto contended = false;
+			for(std::size_t i = 1; i < queueCount; i++)
+			{
+				if(const auto work = queues[(index + i) % queueCount].Steal(contended)) { return work; }
+			}
+			if(!contended) { return nullptr; }
+		}
+	}
+
+	inline void WorkStealingExecutor::Run(const std::size_t index)
+	{
+		current = this;
+		currentQueue = index;
+		for(;;)
+		{
+			// Read before looking for work, so that work posted after the deques were found empty changes it and ends the wait
+			const auto seen = postings.load(std::memory_order_acquire);
+			if(const auto work = Take(index))
+			{
+				work->run(*work);
+				continue;
+			}
+			if(stopping.load(std::memory_order_acquire)) { return; }
+			sleeping.fetch_add(1, std::memory_order_seq_cst);
+			if(postings.load(std::memory_order_seq_cst) == seen) { postings.wait(seen, std::memory_order_acquire); }
+			sleeping.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * \brief The executor Async stages run on unless given another: a work stealing executor with one thread per hardware thread,
+	 * started when first used
+	 */
+	inline Executor& DefaultExecutor()
+	{
+		static WorkStealingExecutor executor;
+		return executor;
+	}
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <new>
+
+namespace libmonad
+{
+	/**
+	 * \brief Where coroutine frames that the compiler cannot elide are allocated, eg. those of EitherTask and OptionTask
+	 */
+	class FrameAllocator
+	{
+	public:
+		virtual ~FrameAllocator() = default;
+
+		/**
+		 * \brief Allocates a frame
+		 * \param size size of the frame in bytes
+		 * \return memory aligned for any fundamental type
+		 */
+		virtual void* Allocate(std::size_t size) = 0;
+
+		/**
+		 * \brief Frees a frame this allocator allocated
+		 * \param frame the frame
+		 * \param size size the frame was allocated with
+		 */
+		virtual void Deallocate(void* frame, std::size_t size) noexcept = 0;
+	};
+
+	/**
+	 * \brief Allocates frames with the global operator new, as a coroutine does by default
+	 */
+	class NewDeleteFrameAllocator final : public FrameAllocator
+	{
+	public:
+		void* Allocate(const std::size_t size) override { return ::operator new(size); }
+		void Deallocate(void* frame, const std::size_t size) noexcept override { ::operator delete(frame, size); }
+	};
+
+	/**
+	 * \brief Keeps freed frames in lists by size, so that the next frame of about the same size reuses one without a call to operator new.
+	 * Frames are rounded up to a multiple of 64 bytes, and frames larger than MaxPooledSize are not pooled.
+	 * Not thread safe: each thread has its own, see ThreadFramePool().
+	 */
+	class FramePool final : public FrameAllocator
+	{
+	public:
+		static constexpr std::size_t Granularity = 64;
+		static constexpr std::size_t MaxPooledSize = 1024;
+
+		FramePool() = default;
+		FramePool(const FramePool&) = delete;
+		FramePool& operator=(const FramePool&) = delete;
+
+		/**
+		 * \brief Frees the frames kept for reuse
+		 */
+		~FramePool() override;
+
+		void* Allocate(std::size_t size) override;
+		void Deallocate(void* frame, std::size_t size) noexcept override;
+
+		/**
+		 * \brief Number of freed frames kept for reuse
+		 */
+		std::size_t Cached() const;
+
+	private:
+		struct FreeFrame { FreeFrame* next; };
+
+		static constexpr std::size_t Classes = MaxPooledSize / Granularity;
+		static constexpr std::size_t ClassOf(const std::size_t size) { return (size + Granularity - 1) / Granularity - 1; }
+
+		std::array<FreeFrame*, Classes> free{};
+	};
+
+	inline FramePool::~FramePool()
+	{
+		for(std::size_t c = 0; c < Classes; c++)
+		{
+			while(const auto frame = free[c])
+			{
+				free[c] = frame->next;
+				::operator delete(frame, (c + 1) * Granularity);
+			}
+		}
+	}
+
+	inline void* FramePool::Allocate(const std::size_t size)
+	{
+		if(size == 0 || size > MaxPooledSize) { return ::operator new(size); }
+		const auto c = ClassOf(size);
+		if(const auto frame = free[c])
+		{
+			free[c] = frame->next;
+			return frame;
+		}
+		return ::operator new((c + 1) * Granularity);
+	}
+
+	inline void FramePool::Deallocate(void* frame, const std::size_t size) noexcept
+	{
+		if(size == 0 || size > MaxPooledSize)
+		{
+			::operator delete(frame, size);
+			return;
+		}
+		const auto c = ClassOf(size);
+		free[c] = ::new(frame) FreeFrame{ free[c] };
+	}
+
+	inline std::size_t FramePool::Cached() const
+	{
+		std::size_t count = 0;
+		for(auto frame : free)
+		{
+			for(; frame != nullptr; frame = frame->next) { count++; }
+		}
+		return count;
+	}
+
+	/**
+	 * \brief The calling thread's own frame pool
+	 */
+	inline FramePool& ThreadFramePool()
+	{
+		thread_local FramePool pool;
+		return pool;
+	}
+
+	namespace detail
+	{
+		// nullptr stands for the pool of whichever thread allocates or frees the frame, so a frame may be freed
+		// on another thread than the one it was allocated on, and outlive the thread that allocated it
+		inline FrameAllocator*& CurrentFrameAllocator()
+		{
+			thread_local FrameAllocator* allocator = nullptr;
+			return allocator;
+		}
+
+		// Each frame starts with the allocator it came from, padded to keep the frame aligned
+		struct FrameHeader { FrameAllocator* allocator; };
+		inline constexpr std::size_t FrameHeaderSize = alignof(std::max_align_t) > sizeof(FrameHeader) ? alignof(std::max_align_t) : sizeof(FrameHeader);
+
+		inline void* AllocateFrame(const std::size_t size)
+		{
+			const auto allocator = CurrentFrameAllocator();
+			auto* const block = static_cast<std::byte*>(allocator ? allocator->Allocate(size + FrameHeaderSize) : ThreadFramePool().Allocate(size + FrameHeaderSize));
+			::new(block) FrameHeader{ allocator };
+			return block + FrameHeaderSize;
+		}
+
+		inline void DeallocateFrame(void* frame, const std::size_t size) noexcept
+		{
+			auto* const block = static_cast<std::byte*>(frame) - FrameHeaderSize;
+			const auto allocator = reinterpret_cast<FrameHeader*>(block)->allocator;
+			if(allocator) { allocator->Deallocate(block, size + FrameHeaderSize); }
+			else { ThreadFramePool().Deallocate(block, size + FrameHeaderSize); }
+		}
+	}
+
+	/**
+	 * \brief Sets where the calling thread allocates coroutine frames from now on. Each frame is freed by the allocator it came from,
+	 * which must outlive it.
+	 * \param allocator allocator to use, or nullptr for the calling thread's own frame pool (the default)
+	 * \return the previous allocator, or nullptr if it was the thread's frame pool
+	 */
+	inline FrameAllocator* SetFrameAllocator(FrameAllocator* allocator)
+	{
+		const auto previous = detail::CurrentFrameAllocator();
+		detail::CurrentFrameAllocator() = allocator;
+		return previous;
+	}
+}
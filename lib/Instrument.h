@@ -0,0 +1,368 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+
+/*
+ * Counts what eithers and options do, to find where a pipeline copies and allocates.
+ * Define LIBMONAD_INSTRUMENT to 1 before including any libmonad header, or pass it to the compiler, to count:
+ *
+ * - constructions, copies, moves and destructions of each Either<L, R> and Option<T> instantiation
+ * - calls of each combinator (Either::Map, Option::Bind, ...), with the constructions, copies, moves, destructions and
+ *   heap allocations made while it ran, including those made by the functions passed to it
+ *
+ * Heap allocations are counted by a replacement operator new, which one translation unit of the program defines by defining
+ * LIBMONAD_INSTRUMENT_ALLOCATIONS before including this header. Allocations made converting a function to a std::function
+ * happen before the combinator is called, so count against the caller only, eg. in EXPECT_NO_ALLOCATIONS.
+ *
+ * Left undefined (or 0), nothing is counted and eithers and options are exactly as they would be without this header.
+ * Every translation unit of a program must agree on LIBMONAD_INSTRUMENT.
+ */
+#ifndef LIBMONAD_INSTRUMENT
+#define LIBMONAD_INSTRUMENT 0
+#endif
+
+#ifdef _MSC_VER
+#define LIBMONAD_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define LIBMONAD_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+#if LIBMONAD_INSTRUMENT
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <utility>
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+
+namespace libmonad
+{
+	/**
+	 * \brief What was counted for an Either or Option instantiation, or a combinator
+	 */
+	struct Counts
+	{
+		std::size_t calls = 0;
+		std::size_t constructions = 0;
+		std::size_t copies = 0;
+		std::size_t moves = 0;
+		std::size_t destructions = 0;
+		std::size_t allocations = 0;
+
+		/**
+		 * \brief What was counted between two readings
+		 */
+		friend constexpr Counts operator-(const Counts& after, const Counts& before)
+		{
+			return { after.calls - before.calls, after.constructions - before.constructions, after.copies - before.copies,
+				after.moves - before.moves, after.destructions - before.destructions, after.allocations - before.allocations };
+		}
+
+		friend constexpr bool operator==(const Counts&, const Counts&) = default;
+	};
+
+	namespace detail
+	{
+		enum class Event { Call, Construction, Copy, Move, Destruction, Allocation };
+
+		/**
+		 * \brief Counts for one instantiation or combinator, which any thread may add to
+		 */
+		class Counters
+		{
+		public:
+			void Add(const Event event) noexcept { counters[static_cast<std::size_t>(event)].fetch_add(1, std::memory_order_relaxed); }
+
+			Counts Read() const noexcept
+			{
+				const auto read = [this](const Event event) { return counters[static_cast<std::size_t>(event)].load(std::memory_order_relaxed); };
+				return { read(Event::Call), read(Event::Construction), read(Event::Copy), read(Event::Move), read(Event::Destruction), read(Event::Allocation) };
+			}
+
+			void Reset() noexcept { for(auto& counter : counters) { counter.store(0, std::memory_order_relaxed); } }
+
+		private:
+			std::atomic<std::size_t> counters[6] = {};
+		};
+
+		/**
+		 * \brief A combinator running on this thread. The calls running form a list, innermost first,
+		 * and everything counted while a call runs is added to it and to each call it runs within
+		 */
+		struct ActiveCall
+		{
+			Counters* counters;
+			ActiveCall* outer;
+		};
+
+		inline thread_local ActiveCall* innermostCall = nullptr;
+		inline thread_local std::size_t threadAllocations = 0;
+		inline thread_local bool registering = false;
+
+		/**
+		 * \brief Stops the allocations the registry makes for itself being counted
+		 */
+		class Registering
+		{
+		public:
+			Registering() noexcept : outer(std::exchange(registering, true)) {}
+			~Registering() { registering = outer; }
+
+			Registering(const Registering&) = delete;
+			Registering& operator=(const Registering&) = delete;
+
+		private:
+			bool outer;
+		};
+
+		inline void AddToActiveCalls(const Event event) noexcept
+		{
+			for(auto call = innermostCall; call != nullptr; call = call->outer) { call->counters->Add(event); }
+		}
+
+		inline void Record(Counters& counters, const Event event) noexcept
+		{
+			counters.Add(event);
+			AddToActiveCalls(event);
+		}
+
+		/**
+		 * \brief Called by the replacement operator new for every heap allocation
+		 */
+		inline void RecordAllocation() noexcept
+		{
+			if(registering) { return; }
+			threadAllocations++;
+			AddToActiveCalls(Event::Allocation);
+		}
+
+		template <typename T>
+		std::string TypeName()
+		{
+			const char* name = typeid(T).name();
+#if __has_include(<cxxabi.h>)
+			int status = 0;
+			const std::unique_ptr<char, void (*)(void*)> demangled(abi::__cxa_demangle(name, nullptr, nullptr, &status), std::free);
+			if(status == 0 && demangled) { return demangled.get(); }
+#endif
+			return name;
+		}
+	}
+
+	/**
+	 * \brief Where the counts of every instantiation and combinator are kept, by name
+	 */
+	class InstrumentRegistry
+	{
+	public:
+		static InstrumentRegistry& Instance()
+		{
+			static InstrumentRegistry registry;
+			return registry;
+		}
+
+		/**
+		 * \brief The counters kept under a name, which stay where they are for the life of the program
+		 */
+		detail::Counters& For(const std::string_view name)
+		{
+			detail::Registering registering;
+			std::lock_guard lock(mutex);
+			return counters.try_emplace(std::string(name)).first->second;
+		}
+
+		/**
+		 * \brief What has been counted under a name, or nothing if the name has not been counted
+		 */
+		Counts Read(const std::string_view name) const
+		{
+			std::lock_guard lock(mutex);
+			const auto found = counters.find(name);
+			return found == counters.end() ? Counts{} : found->second.Read();
+		}
+
+		/**
+		 * \brief What has been counted under every name
+		 */
+		std::map<std::string, Counts, std::less<>> ReadAll() const
+		{
+			std::lock_guard lock(mutex);
+			std::map<std::string, Counts, std::less<>> all;
+			for(const auto& [name, counted] : counters) { all.emplace(name, counted.Read()); }
+			return all;
+		}
+
+		void Reset()
+		{
+			std::lock_guard lock(mutex);
+			for(auto& [name, counted] : counters) { counted.Reset(); }
+		}
+
+	private:
+		InstrumentRegistry() = default;
+
+		mutable std::mutex mutex;
+		std::map<std::string, detail::Counters, std::less<>> counters;
+	};
+
+	namespace detail
+	{
+		template <typename T>
+		Counters& CountersOf()
+		{
+			static auto& counters = []() -> Counters&
+			{
+				Registering registering;
+				return InstrumentRegistry::Instance().For(TypeName<T>());
+			}();
+			return counters;
+		}
+
+		/**
+		 * \brief Member of an Either or Option that counts its constructions, copies, moves and destructions
+		 * \tparam Owner the Either or Option
+		 */
+		template <typename Owner>
+		class Counted
+		{
+		public:
+			constexpr Counted() noexcept { Record(Event::Construction); }
+			constexpr Counted(const Counted&) noexcept { Record(Event::Copy); }
+			constexpr Counted(Counted&&) noexcept { Record(Event::Move); }
+			constexpr Counted& operator=(const Counted&) noexcept { Record(Event::Copy); return *this; }
+			constexpr Counted& operator=(Counted&&) noexcept { Record(Event::Move); return *this; }
+			constexpr ~Counted() { Record(Event::Destruction); }
+
+		private:
+			static constexpr void Record(const Event event) noexcept
+			{
+				if(!std::is_constant_evaluated()) { detail::Record(CountersOf<Owner>(), event); }
+			}
+		};
+
+		/**
+		 * \brief Counts a call of a combinator, and what is counted while it runs
+		 */
+		class Call
+		{
+		public:
+			constexpr explicit Call(Counters& (*counters)()) noexcept
+			{
+				if(!std::is_constant_evaluated())
+				{
+					// Only the call itself counts a call, not the calls it runs within
+					active = { &counters(), innermostCall };
+					active.counters->Add(Event::Call);
+					innermostCall = &active;
+				}
+			}
+
+			constexpr ~Call()
+			{
+				if(!std::is_constant_evaluated()) { innermostCall = active.outer; }
+			}
+
+			Call(const Call&) = delete;
+			Call& operator=(const Call&) = delete;
+
+		private:
+			ActiveCall active{ nullptr, nullptr };
+		};
+	}
+
+	/**
+	 * \brief What has been counted for an Either or Option instantiation, from all threads
+	 * \tparam T the Either or Option, eg. Either<int, std::string>
+	 */
+	template <typename T>
+	Counts CountsOf() { return detail::CountersOf<T>().Read(); }
+
+	/**
+	 * \brief What has been counted for a combinator, from all threads
+	 * \param combinator eg. "Either::Map" or "Option::Bind"
+	 */
+	inline Counts CountsOf(const std::string_view combinator) { return InstrumentRegistry::Instance().Read(combinator); }
+
+	/**
+	 * \brief How many heap allocations this thread has made, if the replacement operator new is defined
+	 */
+	inline std::size_t ThreadAllocations() noexcept { return detail::threadAllocations; }
+
+	/**
+	 * \brief How many heap allocations calling a function makes on this thread
+	 */
+	template <typename F>
+	std::size_t AllocationsDuring(F&& function)
+	{
+		const auto before = ThreadAllocations();
+		std::invoke(std::forward<F>(function));
+		return ThreadAllocations() - before;
+	}
+}
+
+#define LIBMONAD_INSTRUMENT_CALL(combinator) \
+	const ::libmonad::detail::Call libmonadInstrumentCall([]() -> ::libmonad::detail::Counters& \
+	{ \
+		static auto& counters = ::libmonad::InstrumentRegistry::Instance().For(combinator); \
+		return counters; \
+	})
+
+/**
+ * Expects the statements not to allocate on the heap, for use in GoogleTest tests, eg.
+ * EXPECT_NO_ALLOCATIONS(auto result = Parse(input).Map(Twice); benchmark::DoNotOptimize(result));
+ */
+#define EXPECT_NO_ALLOCATIONS(...) \
+	do \
+	{ \
+		const auto libmonadAllocationsBefore = ::libmonad::ThreadAllocations(); \
+		__VA_ARGS__; \
+		EXPECT_EQ(::libmonad::ThreadAllocations() - libmonadAllocationsBefore, 0u) << "Allocated running: " #__VA_ARGS__; \
+	} while(false)
+
+#ifdef LIBMONAD_INSTRUMENT_ALLOCATIONS
+namespace libmonad::detail
+{
+	inline void* CountedAllocate(const std::size_t size)
+	{
+		RecordAllocation();
+		if(auto memory = std::malloc(size == 0 ? 1 : size)) { return memory; }
+#ifdef __cpp_exceptions
+		throw std::bad_alloc();
+#else
+		std::abort();
+#endif
+	}
+}
+
+// Count every heap allocation, except over-aligned ones, which the standard library still allocates itself
+
+void* operator new(const std::size_t size) { return libmonad::detail::CountedAllocate(size); }
+void* operator new[](const std::size_t size) { return libmonad::detail::CountedAllocate(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+#endif
+
+#else
+
+namespace libmonad::detail
+{
+	/**
+	 * \brief Counts nothing, and takes no space in the either or option holding it
+	 */
+	template <typename Owner>
+	struct Counted {};
+}
+
+#define LIBMONAD_INSTRUMENT_CALL(combinator) static_cast<void>(0)
+
+#endif
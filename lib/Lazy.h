@@ -0,0 +1,212 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "Either.h"
+#include "Option.h"
+
+namespace libmonad
+{
+	template <typename T>
+	class Lazy;
+
+	/**
+	 * \brief Determines if a type is a Lazy
+	 */
+	template <typename T>
+	struct IsLazy : std::false_type {};
+
+	template <typename T>
+	struct IsLazy<Lazy<T>> : std::true_type {};
+
+	namespace detail
+	{
+		/**
+		 * \brief The value copies of a Lazy share, and whether it has been worked out yet. The first thread to force it moves it
+		 * from Unforced to Forcing and evaluates it; any other thread forcing it meanwhile waits on the same atomic until it is
+		 * Ready. From then on forcing is a single acquire load.
+		 * \tparam T type of value
+		 */
+		template <typename T>
+		class LazyState
+		{
+		public:
+			LazyState() {}
+			virtual ~LazyState() { if(IsReady()) { std::destroy_at(&value); } }
+
+			LazyState(const LazyState&) = delete;
+			LazyState& operator=(const LazyState&) = delete;
+
+			void AddRef() { references.fetch_add(1, std::memory_order_relaxed); }
+			void Release() { if(references.fetch_sub(1, std::memory_order_acq_rel) == 1) { delete this; } }
+
+			const T& Force()
+			{
+				if(stage.load(std::memory_order_acquire) != Ready) [[unlikely]] { ForceSlow(); }
+				return value;
+			}
+
+			bool IsReady() const { return stage.load(std::memory_order_acquire) == Ready; }
+
+		protected:
+			// Works out the value. Called once, unless it throws, in which case the next thread to force tries again.
+			virtual T Evaluate() = 0;
+
+			// Frees whatever evaluating needed, once it is no longer needed
+			virtual void Forget() = 0;
+
+		private:
+			enum Stage : std::uint8_t { Unforced, Forcing, Ready };
+
+			// Puts the state back to Unforced, waking any waiting threads, if evaluating throws
+			struct Unwind
+			{
+				std::atomic<Stage>* stage;
+
+				~Unwind()
+				{
+					if(stage == nullptr) { return; }
+					stage->store(Unforced, std::memory_order_release);
+					stage->notify_all();
+				}
+			};
+
+			void ForceSlow()
+			{
+				for(auto current = stage.load(std::memory_order_acquire); current != Ready; current = stage.load(std::memory_order_acquire))
+				{
+					if(current == Forcing) { stage.wait(Forcing, std::memory_order_acquire); continue; }
+					if(!stage.compare_exchange_strong(current, Forcing, std::memory_order_acquire)) { continue; }
+
+					Unwind unwind{ &stage };
+					std::construct_at(&value, Evaluate());
+					unwind.stage = nullptr;
+					Forget();
+					stage.store(Ready, std::memory_order_release);
+					stage.notify_all();
+					return;
+				}
+			}
+
+			std::atomic<std::size_t> references{1};
+			std::atomic<Stage> stage{Unforced};
+			union { T value; };
+		};
+
+		/**
+		 * \brief A LazyState worked out by a function, which is destroyed as soon as it has been called
+		 */
+		template <typename T, typename F>
+		class Thunk final : public LazyState<T>
+		{
+		public:
+			explicit Thunk(F evaluate) : evaluate(std::move(evaluate)) {}
+
+		private:
+			T Evaluate() override { return std::invoke(std::move(*evaluate)); }
+			void Forget() override { evaluate.reset(); }
+
+			std::optional<F> evaluate;
+		};
+	}
+
+	/**
+	 * \brief A value that is worked out the first time it is needed and then kept. However many threads force it at once,
+	 * it is worked out only once and the others wait for it; after that, forcing it takes no lock. Copies share the one
+	 * value. For a Lazy<Either<L, R>> or Lazy<Option<T>>, Map() and Bind() work on the right (or some) value as Async's do,
+	 * and a left value (or none) is kept like any other, so a failed lookup is not repeated either.
+	 * \tparam T type of value
+	 */
+	template <typename T>
+	class Lazy
+	{
+	public:
+		using ValueType = T;
+
+		Lazy(const Lazy& other) : state(other.state) { if(state != nullptr) { state->AddRef(); } }
+		Lazy(Lazy&& other) noexcept : state(std::exchange(other.state, nullptr)) {}
+
+		Lazy& operator=(Lazy other) noexcept
+		{
+			std::swap(state, other.state);
+			return *this;
+		}
+
+		~Lazy() { if(state != nullptr) { state->Release(); } }
+
+		/**
+		 * \brief Gets the value, working it out on this thread, or waiting for another thread to, if nobody has yet.
+		 * A value that forces itself never finishes.
+		 */
+		const T& Force() const { return state->Force(); }
+
+		/**
+		 * \brief Whether the value has been worked out
+		 */
+		bool IsForced() const { return state->IsReady(); }
+
+		/**
+		 * \brief Defers a transformation of the value, or of the right (or some) value of an Either (or Option)
+		 * \tparam F transformation function that takes a value and returns a U
+		 * \param transform transformation function
+		 * \return Lazy<U>, or Lazy of the Either (or Option) its Map() returns
+		 */
+		template <typename F>
+		auto Map(F&& transform) const
+		{
+			return Defer([source = *this, transform = std::forward<F>(transform)]
+			{
+				if constexpr (IsEither<T>::value || IsOption<T>::value) { return source.Force().Map(transform); }
+				else { return std::invoke(transform, source.Force()); }
+			});
+		}
+
+		/**
+		 * \brief Defers a transformation of the value that is itself lazy, or of the right (or some) value of an Either (or Option)
+		 * that returns another
+		 * \tparam F transformation function that takes a value and returns a Lazy<U>, or an Either (or Option)
+		 * \param transform transformation function
+		 * \return Lazy<U>, or Lazy of the Either (or Option) its Bind() returns
+		 */
+		template <typename F>
+		auto Bind(F&& transform) const
+		{
+			return Defer([source = *this, transform = std::forward<F>(transform)]
+			{
+				if constexpr (IsEither<T>::value || IsOption<T>::value) { return source.Force().Bind(transform); }
+				else
+				{
+					using Result = std::invoke_result_t<F, const T&>;
+					static_assert(IsLazy<Result>::value, "Bind transformation must return a Lazy");
+					return std::invoke(transform, source.Force()).Force();
+				}
+			});
+		}
+
+	private:
+		template <typename F>
+		friend auto Defer(F&& evaluate);
+
+		explicit Lazy(detail::LazyState<T>* state) : state(state) {}
+
+		detail::LazyState<T>* state;
+	};
+
+	/**
+	 * \brief Makes a value that is worked out by a function the first time it is forced
+	 * \param evaluate function that takes nothing and returns a T
+	 * \return Lazy<T>
+	 */
+	template <typename F>
+	auto Defer(F&& evaluate)
+	{
+		using T = std::decay_t<std::invoke_result_t<F>>;
+		static_assert(!IsLazy<T>::value, "Defer a function that returns a plain value, or use Bind");
+		return Lazy<T>(new detail::Thunk<T, std::decay_t<F>>(std::forward<F>(evaluate)));
+	}
+}
@@ -0,0 +1,331 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Either.h"
+#include "Option.h"
+
+namespace libmonad
+{
+	/**
+	 * \brief Whether a memoised function keeps its left values (or nones) as well as its right (or some) values
+	 */
+	enum class CacheLefts : bool { No, Yes };
+
+	/**
+	 * \brief How often a memoised function found its result already kept
+	 */
+	struct MemoStats
+	{
+		std::uint64_t hits = 0;
+		std::uint64_t misses = 0;
+		std::uint64_t evictions = 0;
+
+		double HitRate() const { return hits + misses == 0 ? 0 : static_cast<double>(hits) / static_cast<double>(hits + misses); }
+
+		MemoStats& operator+=(const MemoStats& other)
+		{
+			hits += other.hits;
+			misses += other.misses;
+			evictions += other.evictions;
+			return *this;
+		}
+	};
+
+	namespace detail
+	{
+		/**
+		 * \brief 32 bits of a key's hash, spread out by Fibonacci hashing in case the hash, such as std::hash of an integer,
+		 * is not spread out itself. Every bit of the hash mixes into the top bits of these
+		 */
+		template <typename Hash, typename K>
+		std::uint32_t MixedHash(const K& key)
+		{
+			return static_cast<std::uint32_t>((static_cast<std::uint64_t>(Hash()(key)) * 0x9E3779B97F4A7C15ull) >> 32);
+		}
+
+		/**
+		 * \brief Up to a fixed number of values by key, kept in one array with a CLOCK bit each, and found through an open
+		 * addressed index of 8 byte slots holding 32 bits of the key's hash and the entry's position, so that a miss
+		 * touches no entry. When full, the hand sweeps the entries, sparing once each one found since it last passed, and
+		 * the first it does not spare makes room for the new one.
+		 * \tparam K type of key
+		 * \tparam V type of value
+		 * \tparam Hash hashes a key
+		 */
+		template <typename K, typename V, typename Hash = std::hash<K>>
+		class ClockCache
+		{
+		public:
+			explicit ClockCache(const std::size_t capacity)
+				: capacity(capacity < 1 ? 1 : capacity), slots(std::bit_ceil(this->capacity * 2), Empty), mask(slots.size() - 1)
+			{
+				entries.reserve(this->capacity);
+			}
+
+			/**
+			 * \brief The value kept for a key, marking it found, or null
+			 */
+			const V* Find(const K& key)
+			{
+				const auto hash = HashOf(key);
+				for(auto i = hash & mask; slots[i] != Empty; i = (i + 1) & mask)
+				{
+					if(HashIn(slots[i]) != hash) { continue; }
+					auto& entry = entries[PositionIn(slots[i])];
+					if(entry.key == key)
+					{
+						entry.referenced = true;
+						return &entry.value;
+					}
+				}
+				return nullptr;
+			}
+
+			/**
+			 * \brief Keeps a value for a key that is not kept already, making room for it if full
+			 * \return whether another entry was evicted to make room
+			 */
+			bool Insert(K key, V value)
+			{
+				const auto hash = HashOf(key);
+				auto evicted = false;
+				std::size_t position;
+				if(entries.size() < capacity)
+				{
+					position = entries.size();
+					entries.push_back(Entry{ std::move(key), std::move(value), hash, false });
+				}
+				else
+				{
+					position = Victim();
+					Unlink(entries[position].hash, position);
+					std::destroy_at(&entries[position]);
+					std::construct_at(&entries[position], Entry{ std::move(key), std::move(value), hash, false });
+					evicted = true;
+				}
+
+				auto i = hash & mask;
+				while(slots[i] != Empty) { i = (i + 1) & mask; }
+				slots[i] = Slot(hash, position);
+				return evicted;
+			}
+
+			std::size_t Size() const { return entries.size(); }
+			std::size_t Capacity() const { return capacity; }
+
+		private:
+			struct Entry
+			{
+				K key;
+				V value;
+				std::uint32_t hash;
+				bool referenced;
+			};
+
+			static constexpr std::uint64_t Empty = ~std::uint64_t(0);
+
+			static std::uint32_t HashOf(const K& key) { return MixedHash<Hash>(key); }
+
+			static std::uint64_t Slot(const std::uint32_t hash, const std::size_t position) { return std::uint64_t(hash) << 32 | position; }
+			static std::uint32_t HashIn(const std::uint64_t slot) { return static_cast<std::uint32_t>(slot >> 32); }
+			static std::size_t PositionIn(const std::uint64_t slot) { return static_cast<std::uint32_t>(slot); }
+
+			std::size_t Victim()
+			{
+				while(entries[hand].referenced)
+				{
+					entries[hand].referenced = false;
+					hand = (hand + 1) % capacity;
+				}
+				return std::exchange(hand, (hand + 1) % capacity);
+			}
+
+			// Removes an entry's slot, moving back any later slot of the same run that could then not be found
+			void Unlink(const std::uint32_t hash, const std::size_t position)
+			{
+				auto hole = hash & mask;
+				while(slots[hole] != Slot(hash, position)) { hole = (hole + 1) & mask; }
+
+				for(auto i = (hole + 1) & mask; slots[i] != Empty; i = (i + 1) & mask)
+				{
+					const auto home = HashIn(slots[i]) & mask;
+					const auto reachable = hole <= i ? home > hole && home <= i : home > hole || home <= i;
+					if(reachable) { continue; }
+					slots[hole] = slots[i];
+					hole = i;
+				}
+				slots[hole] = Empty;
+			}
+
+			std::size_t capacity;
+			std::vector<Entry> entries;
+			std::vector<std::uint64_t> slots;
+			std::size_t mask;
+			std::size_t hand = 0;
+		};
+
+		template <typename T>
+		bool Succeeded(const T& result)
+		{
+			if constexpr (IsEither<T>::value) { return result.IsRight(); }
+			else { return !result.IsNone(); }
+		}
+	}
+
+	/**
+	 * \brief A function that returns an Either or an Option, which keeps the results for up to a fixed number of keys and
+	 * returns a copy of a kept result rather than calling the function again. It is called like the function, so can be
+	 * given to Map() or Bind(). Not safe to call from more than one thread at a time: see ShardedMemoized.
+	 * \tparam K type of key the function takes
+	 * \tparam F function that takes a const K& and returns an Either or an Option
+	 * \tparam Hash hashes a key
+	 */
+	template <typename K, typename F, typename Hash = std::hash<K>>
+	class Memoized
+	{
+	public:
+		using Result = std::decay_t<std::invoke_result_t<F&, const K&>>;
+
+		static_assert(IsEither<Result>::value || IsOption<Result>::value, "Memoize a function that returns an Either or an Option");
+
+		Memoized(F function, const std::size_t capacity, const CacheLefts lefts)
+			: function(std::move(function)), cache(capacity), lefts(lefts) {}
+
+		Result operator()(const K& key)
+		{
+			if(const auto* kept = cache.Find(key))
+			{
+				stats.hits++;
+				return *kept;
+			}
+
+			stats.misses++;
+			auto result = std::invoke(function, key);
+			if(lefts == CacheLefts::Yes || detail::Succeeded(result)) { stats.evictions += cache.Insert(key, result); }
+			return result;
+		}
+
+		MemoStats Stats() const { return stats; }
+		std::size_t Size() const { return cache.Size(); }
+
+	private:
+		F function;
+		detail::ClockCache<K, Result, Hash> cache;
+		CacheLefts lefts;
+		MemoStats stats;
+	};
+
+	/**
+	 * \brief A Memoized that can be called from any number of threads. Keys are spread by hash over shards, each a cache of
+	 * its own behind its own lock, so threads only contend when their keys share a shard. The function is called outside
+	 * the lock, so two threads that miss on the same key at once may both call it.
+	 * \tparam K type of key the function takes
+	 * \tparam F function that takes a const K& and returns an Either or an Option
+	 * \tparam Hash hashes a key
+	 */
+	template <typename K, typename F, typename Hash = std::hash<K>>
+	class ShardedMemoized
+	{
+	public:
+		using Result = std::decay_t<std::invoke_result_t<const F&, const K&>>;
+
+		static_assert(IsEither<Result>::value || IsOption<Result>::value, "Memoize a function that returns an Either or an Option");
+
+		ShardedMemoized(F function, const std::size_t capacity, const std::size_t shardCount, const CacheLefts lefts)
+			: function(std::move(function)), shardCount(shardCount < 1 ? 1 : shardCount), lefts(lefts)
+		{
+			shards = std::make_unique<Shard[]>(this->shardCount);
+			for(std::size_t i = 0; i < this->shardCount; i++)
+			{
+				shards[i].cache = std::make_unique<detail::ClockCache<K, Result, Hash>>((capacity + this->shardCount - 1) / this->shardCount);
+			}
+		}
+
+		Result operator()(const K& key) const
+		{
+			// The top bits of the mixed hash pick the shard, as a shard's cache finds a slot from its bottom bits
+			auto& shard = shards[static_cast<std::uint64_t>(detail::MixedHash<Hash>(key)) * shardCount >> 32];
+			{
+				std::lock_guard lock(shard.mutex);
+				if(const auto* kept = shard.cache->Find(key))
+				{
+					shard.stats.hits++;
+					return *kept;
+				}
+				shard.stats.misses++;
+			}
+
+			auto result = std::invoke(function, key);
+			if(lefts == CacheLefts::Yes || detail::Succeeded(result))
+			{
+				std::lock_guard lock(shard.mutex);
+				if(shard.cache->Find(key) == nullptr) { shard.stats.evictions += shard.cache->Insert(key, result); }
+			}
+			return result;
+		}
+
+		MemoStats Stats() const
+		{
+			MemoStats total;
+			for(std::size_t i = 0; i < shardCount; i++)
+			{
+				std::lock_guard lock(shards[i].mutex);
+				total += shards[i].stats;
+			}
+			return total;
+		}
+
+	private:
+		// Kept a cache line apart, so that locking one shard does not slow threads using the next
+		struct alignas(64) Shard
+		{
+			std::mutex mutex;
+			std::unique_ptr<detail::ClockCache<K, Result, Hash>> cache;
+			MemoStats stats;
+		};
+
+		F function;
+		std::size_t shardCount;
+		CacheLefts lefts;
+		std::unique_ptr<Shard[]> shards;
+	};
+
+	/**
+	 * \brief Keeps the results of a function that returns an Either or an Option for up to capacity keys
+	 * \tparam K type of key the function takes
+	 * \param function function that takes a const K& and returns an Either or an Option
+	 * \param capacity most keys kept
+	 * \param lefts whether to keep left values (or nones) too
+	 * \return Memoized<K, F>
+	 */
+	template <typename K, typename Hash = std::hash<K>, typename F>
+	Memoized<K, std::decay_t<F>, Hash> Memoize(F&& function, const std::size_t capacity, const CacheLefts lefts = CacheLefts::Yes)
+	{
+		return Memoized<K, std::decay_t<F>, Hash>(std::forward<F>(function), capacity, lefts);
+	}
+
+	/**
+	 * \brief Keeps the results of a function that returns an Either or an Option for up to capacity keys, for calling from
+	 * any number of threads
+	 * \tparam K type of key the function takes
+	 * \param function function that takes a const K& and returns an Either or an Option
+	 * \param capacity most keys kept, over all shards
+	 * \param shards number of independently locked caches
+	 * \param lefts whether to keep left values (or nones) too
+	 * \return ShardedMemoized<K, F>
+	 */
+	template <typename K, typename Hash = std::hash<K>, typename F>
+	ShardedMemoized<K, std::decay_t<F>, Hash> MemoizeSharded(F&& function, const std::size_t capacity, const std::size_t shards = 16,
+		const CacheLefts lefts = CacheLefts::Yes)
+	{
+		return ShardedMemoized<K, std::decay_t<F>, Hash>(std::forward<F>(function), capacity, shards, lefts);
+	}
+}
@@ -1,6 +1,10 @@
 // ReSharper disable CppNonExplicitConvertingConstructor
 #pragma once
 #include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
 
 #include "Either.h"
 
@@ -8,110 +12,529 @@ namespace libmonad
 {
 
 		struct None {};
+
+		template <typename T>
+		class Option;
+
+		/**
+		 * \brief Determines if a type is an Option
+		 * \tparam T type to check
+		 */
+		template <typename T>
+		struct IsOption : std::false_type {};
+
+		template <typename T>
+		struct IsOption<Option<T>> : std::true_type {};
+
+		/**
+		 * \brief The option that mapping to T produces: T itself when T is already an Option, otherwise Option<T>
+		 * \tparam T type the transformation returned
+		 */
+		template <typename T>
+		using MappedOption = std::conditional_t<IsOption<T>::value, T, Option<T>>;
 			
+		/**
+		 * \brief Reserves a value of T to mean None, so that an Option<T> needs no flag of its own and is exactly sizeof(T).
+		 * Specialise it for your own types with Enabled = true, a Value() that returns the reserved value and
+		 * an IsNone(value) that recognises it. An option holding the reserved value is None.
+		 * \tparam T type of value the option holds
+		 */
+		template <typename T, typename = void>
+		struct NoneSentinel
+		{
+			static constexpr bool Enabled = false;
+		};
+
+		/**
+		 * \brief A null pointer is None
+		 */
+		template <typename T>
+		struct NoneSentinel<T*>
+		{
+			static constexpr bool Enabled = true;
+			static constexpr T* Value() noexcept { return nullptr; }
+			static constexpr bool IsNone(T* const& value) noexcept { return value == nullptr; }
+		};
+
+		/**
+		 * \brief An empty unique pointer is None
+		 */
+		template <typename T, typename D>
+		struct NoneSentinel<std::unique_ptr<T, D>>
+		{
+			static constexpr bool Enabled = true;
+			static constexpr std::unique_ptr<T, D> Value() noexcept { return nullptr; }
+			static constexpr bool IsNone(const std::unique_ptr<T, D>& value) noexcept { return value == nullptr; }
+		};
+
+		/**
+		 * \brief Holds the value of an option, or nothing, with a flag saying which
+		 * \tparam T type of value
+		 */
+		template <typename T, bool = NoneSentinel<T>::Enabled>
+		class OptionStorage
+		{
+		public:
+			constexpr OptionStorage() noexcept : hasValue(false) {}
+			constexpr explicit OptionStorage(T in) : value(std::move(in)), hasValue(true) {}
+
+			template <typename... Args>
+			constexpr explicit OptionStorage(std::in_place_t, Args&&... args) : value(std::forward<Args>(args)...), hasValue(true) {}
+
+			constexpr OptionStorage(const OptionStorage& other) : hasValue(false)
+			{
+				if(other.hasValue) { Construct(other.value); }
+			}
+
+			constexpr OptionStorage(OptionStorage&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : hasValue(false)
+			{
+				if(other.hasValue) { Construct(std::move(other.value)); }
+			}
+
+			constexpr OptionStorage& operator=(const OptionStorage& other)
+			{
+				if(this == &other) { return *this; }
+				if(hasValue && other.hasValue) { value = other.value; }
+				else if(other.hasValue) { Construct(other.value); }
+				else { Reset(); }
+				return *this;
+			}
+
+			constexpr OptionStorage& operator=(OptionStorage&& other) noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>)
+			{
+				if(this == &other) { return *this; }
+				if(hasValue && other.hasValue) { value = std::move(other.value); }
+				else if(other.hasValue) { Construct(std::move(other.value)); }
+				else { Reset(); }
+				return *this;
+			}
+
+			constexpr ~OptionStorage() { Reset(); }
+
+			// Trivial when they are for T, so that an option of a trivially copyable value is trivially copyable
+
+			constexpr OptionStorage(const OptionStorage&) requires TrivialSpecialMembers<T>::CopyConstructible = default;
+			constexpr OptionStorage(OptionStorage&&) requires TrivialSpecialMembers<T>::MoveConstructible = default;
+			constexpr OptionStorage& operator=(const OptionStorage&) requires TrivialSpecialMembers<T>::CopyAssignable = default;
+			constexpr OptionStorage& operator=(OptionStorage&&) requires TrivialSpecialMembers<T>::MoveAssignable = default;
+			constexpr ~OptionStorage() requires TrivialSpecialMembers<T>::Destructible = default;
+
+			constexpr bool HasValue() const noexcept { return hasValue; }
+
+			constexpr T& Value() & { return value; }
+			constexpr const T& Value() const & { return value; }
+			constexpr T&& Value() && { return std::move(value); }
+
+			constexpr void Reset() noexcept
+			{
+				if(hasValue) { value.~T(); }
+				hasValue = false;
+			}
+
+			template <typename... Args>
+			constexpr T& Emplace(Args&&... args)
+			{
+				Reset();
+				Construct(std::forward<Args>(args)...);
+				return value;
+			}
+
+		private:
+			template <typename... Args>
+			constexpr void Construct(Args&&... args)
+			{
+				std::construct_at(std::addressof(value), std::forward<Args>(args)...);
+				hasValue = true;
+			}
+
+			// Only alive when hasValue is set
+			union
+			{
+				T value;
+			};
+
+			bool hasValue;
+		};
+
+		/**
+		 * \brief Holds the value of an option, which is None when it is the value NoneSentinel<T> reserves
+		 * \tparam T type of value
+		 */
+		template <typename T>
+		class OptionStorage<T, true>
+		{
+		public:
+			constexpr OptionStorage() noexcept(noexcept(NoneSentinel<T>::Value())) : value(NoneSentinel<T>::Value()) {}
+			constexpr explicit OptionStorage(T in) : value(std::move(in)) {}
+
+			template <typename... Args>
+			constexpr explicit OptionStorage(std::in_place_t, Args&&... args) : value(std::forward<Args>(args)...) {}
+
+			constexpr bool HasValue() const noexcept { return !NoneSentinel<T>::IsNone(value); }
+
+			constexpr T& Value() & { return value; }
+			constexpr const T& Value() const & { return value; }
+			constexpr T&& Value() && { return std::move(value); }
+
+			constexpr void Reset() noexcept { value = NoneSentinel<T>::Value(); }
+
+			// Made aside and moved in, as the value must always be alive to be None
+			template <typename... Args>
+			constexpr T& Emplace(Args&&... args)
+			{
+				T made(std::forward<Args>(args)...);
+				value = std::move(made);
+				return value;
+			}
+
+		private:
+			T value;
+		};
+
+		/**
+		 * \brief Holds the object an Option<T&> refers to as a pointer, which is None when null.
+		 * Assigning the option rebinds the reference rather than assigning to the object.
+		 * \tparam T type of object referred to
+		 */
+		template <typename T>
+		class OptionStorage<T&, false>
+		{
+		public:
+			constexpr OptionStorage() noexcept = default;
+			constexpr explicit OptionStorage(T& in) noexcept : pointer(std::addressof(in)) {}
+			constexpr OptionStorage(std::in_place_t, T& in) noexcept : pointer(std::addressof(in)) {}
+
+			constexpr bool HasValue() const noexcept { return pointer != nullptr; }
+
+			constexpr T& Value() const { return *pointer; }
+
+			constexpr void Reset() noexcept { pointer = nullptr; }
+
+		private:
+			T* pointer = nullptr;
+		};
+
+		/**
+		 * \brief An Option either holds a value of T (Some) or holds nothing (None)
+		 * \tparam T type of value
+		 */
 		template <typename T>
 		class Option
 		{
-			bool isNone {};
-			Either<None,T> value {};			
+			OptionStorage<T> storage;
+
+			// Counts constructions, copies, moves and destructions when built with LIBMONAD_INSTRUMENT, and is nothing otherwise
+			LIBMONAD_NO_UNIQUE_ADDRESS detail::Counted<Option> counted;
 
 		public:
-			
-			Option(T in): value(in){}
-			Option(None n = {}){ value = n; }
+			using ValueType = T;
+
+			constexpr Option(T in): storage(std::in_place, std::forward<T>(in)){}
+			constexpr Option(None = {}) {}
+
+			/**
+			 * \brief An option whose value is made from arguments in place, so it is never copied or moved
+			 * \param args arguments for the value's constructor
+			 */
+			template <typename... Args>
+			constexpr explicit Option(std::in_place_t, Args&&... args) requires (!std::is_reference_v<T> && std::is_constructible_v<T, Args...>)
+				: storage(std::in_place, std::forward<Args>(args)...) {}
+
+			/**
+			 * \brief An option of a reference cannot refer to a temporary
+			 */
+			Option(std::remove_reference_t<T>&&) requires std::is_reference_v<T> = delete;
 						
-			bool IsNone() const { return value.IsLeft(); }
-			bool IsSome() const { return value.IsRight(); }			
+			constexpr bool IsNone() const { return !storage.HasValue(); }
+			constexpr bool IsSome() const { return storage.HasValue(); }
 
-			template <typename T2>
-			Option<T2> Map(std::function<Option<T2>(T)> transform)
+			/**
+			 * \brief Destroys the value, if any, and makes a new one in its place from arguments.
+			 * If making it throws, the option is left None, or unchanged for a T with a NoneSentinel.
+			 * \param args arguments for the value's constructor
+			 * \return the new value
+			 */
+			template <typename... Args>
+			constexpr T& Emplace(Args&&... args) requires (!std::is_reference_v<T> && std::is_constructible_v<T, Args...>)
+			{
+				return storage.Emplace(std::forward<Args>(args)...);
+			}
+
+			/**
+			 * \brief Two options are equal if both are None, or both hold values that are equal
+			 * \return true if equal
+			 */
+			friend constexpr bool operator==(const Option& a, const Option& b)
 			{
-				std::function<Option<T2>(T)> fn = [=](T t) -> Option<T2> { return transform(t); };
-				std::function<Either<None, T2>(T)> fn2  = [=](T t ) -> Either<None,T2> { return ToEither<T2>(fn(t)); };
+				if(a.IsNone() || b.IsNone()) { return a.IsNone() == b.IsNone(); }
+				return a.storage.Value() == b.storage.Value();
+			}
+
+			/**
+			 * \brief An option is equal to None if it holds no value
+			 * \return true if the option is None
+			 */
+			friend constexpr bool operator==(const Option& a, None) { return a.IsNone(); }
+
+			template <typename T2>
+			Option<T2> Map(std::function<Option<T2>(T)> transform) const & { return MapImpl(*this, std::move(transform)); }
+
+			template <typename T2>
+			Option<T2> Map(std::function<Option<T2>(T)> transform) && { return MapImpl(std::move(*this), std::move(transform)); }
 
-				Either<None, T2> either = value.Map(fn2);
-				return ToOption(either);
+			template <typename T2>
+			Option<T2> Bind(std::function<Either<None,Option<T2>>(T)> transform) const &
+			{
+				return BindImpl(*this, [&](const T& t) { return transform(t).WhenLeft([](None) { return Option<T2>(); }); });
 			}
 
 			template <typename T2>
-			Option<T2> Bind(std::function<Either<None,Option<T2>>(T)> transform)
+			Option<T2> Bind(std::function<Either<None,Option<T2>>(T)> transform) &&
 			{
-				std::function<Either<None, T2>(T)> fn2 = [=](T t)
-				{
-					return ToEither(
-							transform(t).When(
-								[&](None n){ return Option<T2>();},
-								[&](Option<T2> t2) { return t2;}));
-				};
-				
-				return ToOption(value.Bind(fn2));
+				return BindImpl(std::move(*this), [&](T&& t) { return transform(std::move(t)).WhenLeft([](None) { return Option<T2>(); }); });
 			}
 
-			T ThrowIfNone(Option<std::string> optionalMessage = None())
+			/**
+			 * \brief Transforms the value if there is one, deducing the type to transform to from the transformation function.
+			 * Called on an rvalue option, the value is moved into the transformation.
+			 * \tparam F transformation function that takes the value and returns a T2 or an Option<T2>
+			 * \param transform transformation function
+			 * \return Option<T2>
+			 */
+			template <typename F, typename = std::enable_if_t<std::is_invocable_v<F, T&>>>
+			constexpr auto Map(F&& transform) & { return MapImpl(*this, std::forward<F>(transform)); }
+
+			template <typename F, typename = std::enable_if_t<std::is_invocable_v<F, const T&>>>
+			constexpr auto Map(F&& transform) const & { return MapImpl(*this, std::forward<F>(transform)); }
+
+			template <typename F, typename = std::enable_if_t<std::is_invocable_v<F, T&&>>>
+			constexpr auto Map(F&& transform) && { return MapImpl(std::move(*this), std::forward<F>(transform)); }
+
+			/**
+			 * \brief Transforms the value if there is one into another option, deducing the type of option from the transformation function.
+			 * Called on an rvalue option, the value is moved into the transformation.
+			 * \tparam F transformation function that takes the value and returns an Option<T2>
+			 * \param transform transformation function
+			 * \return Option<T2>
+			 */
+			template <typename F, typename = std::enable_if_t<std::is_invocable_v<F, T&>>>
+			constexpr auto Bind(F&& transform) & { return BindImpl(*this, std::forward<F>(transform)); }
+
+			template <typename F, typename = std::enable_if_t<std::is_invocable_v<F, const T&>>>
+			constexpr auto Bind(F&& transform) const & { return BindImpl(*this, std::forward<F>(transform)); }
+
+			template <typename F, typename = std::enable_if_t<std::is_invocable_v<F, T&&>>>
+			constexpr auto Bind(F&& transform) && { return BindImpl(std::move(*this), std::forward<F>(transform)); }
+
+			/**
+			 * \brief Returns the value, or throws if there is none (what happens exactly depends on LIBMONAD_ERROR_POLICY).
+			 * Called on an rvalue option, the value is moved out.
+			 * \param optionalMessage message of the exception thrown if there is no value
+			 * \return the value
+			 */
+			constexpr T& ThrowIfNone(Option<std::string> optionalMessage = None()) &
 			{
-				T result;
+				ThrowIfNoneImpl(optionalMessage);
+				return storage.Value();
+			}
 
-				value.Match([&](None none)
-				{
-					optionalMessage.Match(
-							[](None){ throw std::exception("ThrowIfNone"); },
-							[](const std::string& message){ throw std::exception(message.c_str()); }
-					);
-				}, [&](T some)
-				{
-					result = some;
-				});
+			constexpr const T& ThrowIfNone(Option<std::string> optionalMessage = None()) const &
+			{
+				ThrowIfNoneImpl(optionalMessage);
+				return storage.Value();
+			}
 
-				return result;
+			constexpr T ThrowIfNone(Option<std::string> optionalMessage = None()) &&
+			{
+				ThrowIfNoneImpl(optionalMessage);
+				return std::move(storage).Value();
 			}
 			
-			T MatchTo(std::function<T()> ifNone, std::function<T(T)> ifSome )
+			T MatchTo(std::function<T()> ifNone, std::function<T(T)> ifSome ) const &
+			{
+				return MatchToImpl(*this, ifNone, ifSome);
+			}
+
+			T MatchTo(std::function<T()> ifNone, std::function<T(T)> ifSome ) &&
 			{
-				return value.When(
-					[=](None n){return ifNone();},
-					[=](T t){return ifSome(t);});
+				return MatchToImpl(std::move(*this), ifNone, ifSome);
 			}
 
-			T WhenNone(std::function<T()> ifNone)
+			/**
+			 * \brief What value to return, whether or not there is one.
+			 * Called on an rvalue option, the value is moved into ifSome.
+			 * \param ifNone what to return if there is no value
+			 * \param ifSome what to return if there is a value
+			 * \return the common type of what ifNone and ifSome return
+			 */
+			template <typename FN, typename FS>
+			constexpr std::common_type_t<std::invoke_result_t<FN>, std::invoke_result_t<FS, T&>> MatchTo(FN&& ifNone, FS&& ifSome) &
 			{
-				return value.When(
-					[=](None n){ return ifNone(); },
-					[=](T t){ return t; });
+				return MatchToImpl(*this, std::forward<FN>(ifNone), std::forward<FS>(ifSome));
 			}
 
-			void Match(const std::function<void(None)>& ifNone, std::function<void(T)> ifSome )
+			template <typename FN, typename FS>
+			constexpr std::common_type_t<std::invoke_result_t<FN>, std::invoke_result_t<FS, const T&>> MatchTo(FN&& ifNone, FS&& ifSome) const &
 			{
-				return value.Match(
-					[=](None n){ ifNone(n); },
-					[=](T t){ ifSome(t); });
+				return MatchToImpl(*this, std::forward<FN>(ifNone), std::forward<FS>(ifSome));
+			}
+
+			template <typename FN, typename FS>
+			constexpr std::common_type_t<std::invoke_result_t<FN>, std::invoke_result_t<FS, T&&>> MatchTo(FN&& ifNone, FS&& ifSome) &&
+			{
+				return MatchToImpl(std::move(*this), std::forward<FN>(ifNone), std::forward<FS>(ifSome));
+			}
+
+			T WhenNone(std::function<T()> ifNone) const &
+			{
+				return WhenNoneImpl(*this, ifNone);
+			}
+
+			T WhenNone(std::function<T()> ifNone) &&
+			{
+				return WhenNoneImpl(std::move(*this), ifNone);
+			}
+
+			/**
+			 * \brief What value to return if there is no value.
+			 * Called on an rvalue option, the value is moved out.
+			 * \param ifNone what to return if there is no value
+			 * \return the value, or what ifNone returned
+			 */
+			template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<T, F>>>
+			constexpr T WhenNone(F&& ifNone) const &
+			{
+				return WhenNoneImpl(*this, std::forward<F>(ifNone));
+			}
+
+			template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<T, F>>>
+			constexpr T WhenNone(F&& ifNone) &&
+			{
+				return WhenNoneImpl(std::move(*this), std::forward<F>(ifNone));
+			}
+
+			void Match(const std::function<void(None)>& ifNone, std::function<void(T)> ifSome ) const &
+			{
+				MatchImpl(*this, ifNone, ifSome);
+			}
+
+			void Match(const std::function<void(None)>& ifNone, std::function<void(T)> ifSome ) &&
+			{
+				MatchImpl(std::move(*this), ifNone, ifSome);
+			}
+
+			/**
+			 * \brief perform action depending on whether there is a value.
+			 * Called on an rvalue option, the value is moved into ifSome.
+			 * \param ifNone action to perform if there is no value
+			 * \param ifSome action to perform if there is a value
+			 * \return the common type of what ifNone and ifSome return, usually void
+			 */
+			template <typename FN, typename FS>
+			constexpr MatchResult<FN, FS, None, T&> Match(FN&& ifNone, FS&& ifSome) &
+			{
+				return MatchImpl(*this, std::forward<FN>(ifNone), std::forward<FS>(ifSome));
+			}
+
+			template <typename FN, typename FS>
+			constexpr MatchResult<FN, FS, None, const T&> Match(FN&& ifNone, FS&& ifSome) const &
+			{
+				return MatchImpl(*this, std::forward<FN>(ifNone), std::forward<FS>(ifSome));
+			}
+
+			template <typename FN, typename FS>
+			constexpr MatchResult<FN, FS, None, T&&> Match(FN&& ifNone, FS&& ifSome) &&
+			{
+				return MatchImpl(std::move(*this), std::forward<FN>(ifNone), std::forward<FS>(ifSome));
 			}
 
 			template <typename T2>
-			Option<T2> ToOption(Either<None, T2> either)
+			constexpr Option<T2> ToOption(Either<None, T2> either)
 			{
-				Option<T2> option = None();
-				
-				either.Match(
-					[&](None n){ option = None(); }, 
-					[&](T2 t2){ option = t2;});
-				return option;
+				LIBMONAD_INSTRUMENT_CALL("Option::ToOption");
+				return std::move(either).Match(
+					[](None) { return Option<T2>(); },
+					[](T2&& t2) { return Option<T2>(std::move(t2)); });
 			}
 
 			template <typename T2>
-			Either<None, T2> ToEither(Option<T2> option)
+			constexpr Either<None, T2> ToEither(Option<T2> option)
 			{
-				Either<None,T2> either = None();
+				LIBMONAD_INSTRUMENT_CALL("Option::ToEither");
+				return std::move(option).Match(
+					[](None n) { return Either<None, T2>(n); },
+					[](T2&& t) { return Either<None, T2>(std::move(t)); });
+			}
 
-				option.Match(
-					[&](None n){ either = n;},
-					[&](T2 t) { either = t;});
-				return either;
-			}			
-			
+		private:
+
+			// Each combinator is implemented once here, for self being an lvalue, const lvalue or rvalue option.
+			// The value is forwarded with self's value category, so an rvalue option moves its value.
+
+			template <typename Self, typename F>
+			static constexpr auto MapImpl(Self&& self, F&& transform)
+			{
+				LIBMONAD_INSTRUMENT_CALL("Option::Map");
+				using Result = MappedOption<std::decay_t<std::invoke_result_t<F, ForwardLike<Self, T>>>>;
+
+				if(self.IsNone()) LIBMONAD_LEFT_HINT { return Result(); }
+				return Result(std::invoke(std::forward<F>(transform), std::forward<Self>(self).storage.Value()));
+			}
+
+			template <typename Self, typename F>
+			static constexpr auto BindImpl(Self&& self, F&& transform)
+			{
+				LIBMONAD_INSTRUMENT_CALL("Option::Bind");
+				using Result = std::decay_t<std::invoke_result_t<F, ForwardLike<Self, T>>>;
+				static_assert(IsOption<Result>::value, "Bind transformation must return an Option, use Map to return a plain value");
+
+				if(self.IsNone()) LIBMONAD_LEFT_HINT { return Result(); }
+				return Result(std::invoke(std::forward<F>(transform), std::forward<Self>(self).storage.Value()));
+			}
+
+			template <typename Self, typename FN, typename FS>
+			static constexpr decltype(auto) MatchImpl(Self&& self, FN&& ifNone, FS&& ifSome)
+			{
+				LIBMONAD_INSTRUMENT_CALL("Option::Match");
+				using Result = MatchResult<FN, FS, None, ForwardLike<Self, T>>;
+
+				if(self.IsNone()) LIBMONAD_LEFT_HINT { return static_cast<Result>(std::invoke(std::forward<FN>(ifNone), None())); }
+				return static_cast<Result>(std::invoke(std::forward<FS>(ifSome), std::forward<Self>(self).storage.Value()));
+			}
+
+			template <typename Self, typename FN, typename FS>
+			static constexpr auto MatchToImpl(Self&& self, FN&& ifNone, FS&& ifSome)
+			{
+				LIBMONAD_INSTRUMENT_CALL("Option::MatchTo");
+				using Result = std::common_type_t<std::invoke_result_t<FN>, std::invoke_result_t<FS, ForwardLike<Self, T>>>;
+
+				if(self.IsNone()) LIBMONAD_LEFT_HINT { return static_cast<Result>(std::invoke(std::forward<FN>(ifNone))); }
+				return static_cast<Result>(std::invoke(std::forward<FS>(ifSome), std::forward<Self>(self).storage.Value()));
+			}
+
+			template <typename Self, typename F>
+			static constexpr T WhenNoneImpl(Self&& self, F&& ifNone)
+			{
+				LIBMONAD_INSTRUMENT_CALL("Option::WhenNone");
+				if(self.IsNone()) LIBMONAD_LEFT_HINT { return std::invoke(std::forward<F>(ifNone)); }
+				return std::forward<Self>(self).storage.Value();
+			}
+
+			constexpr void ThrowIfNoneImpl(const Option<std::string>& optionalMessage) const
+			{
+				if constexpr (ErrorsChecked)
+				{
+					if(IsSome()) { return; }
+
+					optionalMessage.Match(
+							[](None){ Fail("ThrowIfNone"); },
+							[](const std::string& message){ Fail(message); });
+				}
+			}
 		};
 
 		template <typename T>
-		static Option<T> ToOption(T thing)
+		static constexpr Option<T> ToOption(T thing)
 		{
 			return Option<T>(thing);
 		}		
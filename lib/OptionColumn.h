@@ -0,0 +1,298 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Bitmap.h"
+#include "Option.h"
+
+namespace libmonad
+{
+	/**
+	 * \brief A column of options stored as a bitmap saying which elements are some, and a dense array of values at their own index,
+	 * rather than as std::vector<Option<T>>. Bulk Map, Bind and Match scan the bitmap a word at a time, skipping 64 nones at once.
+	 * \tparam T type of value, which must be default constructible to fill the slots of none elements
+	 */
+	template <typename T>
+	class OptionColumn
+	{
+	public:
+		OptionColumn() = default;
+
+		/**
+		 * \brief Copies a vector of options into a column
+		 * \param options options to copy
+		 */
+		explicit OptionColumn(const std::vector<Option<T>>& options);
+
+		/**
+		 * \brief Moves a vector of options into a column
+		 * \param options options to move from
+		 */
+		explicit OptionColumn(std::vector<Option<T>>&& options);
+
+		/**
+		 * \brief Makes a column out of a bitmap of which elements are some and the value of every element at its own index
+		 * \param someBits which elements have a value
+		 * \param values one value per element, the same number as there are bits
+		 */
+		OptionColumn(ValidityBitmap someBits, std::vector<T> values);
+
+		/**
+		 * \brief Adds an option to the end of the column
+		 * \param option option to add
+		 */
+		void PushBack(Option<T> option);
+
+		void PushNone();
+		void PushSome(T value);
+
+		/**
+		 * \brief Number of elements
+		 */
+		std::size_t Size() const { return someBits.Size(); }
+
+		/**
+		 * \brief Number of elements that have a value, counted a word of the bitmap at a time
+		 */
+		std::size_t SomeCount() const { return someBits.Count(); }
+
+		bool IsNone(const std::size_t i) const { return !someBits.Test(i); }
+		bool IsSome(const std::size_t i) const { return someBits.Test(i); }
+
+		/**
+		 * \brief Copies out element i
+		 * \param i index of the element
+		 * \return element i as an option
+		 */
+		Option<T> At(const std::size_t i) const { return someBits.Test(i) ? Option<T>(values[i]) : Option<T>(); }
+
+		/**
+		 * \brief Which elements have a value
+		 */
+		const ValidityBitmap& SomeBits() const { return someBits; }
+
+		/**
+		 * \brief The value of every element, at its own index. The values of none elements are default constructed and meaningless.
+		 */
+		const std::vector<T>& Values() const { return values; }
+
+		/**
+		 * \brief Transforms every value, leaving nones as they are.
+		 * Called on an rvalue column, values are moved into the transformation.
+		 * \tparam F transformation function that takes a value and returns a U or an Option<U>
+		 * \param transform transformation function
+		 * \return OptionColumn<U>
+		 */
+		template <typename F>
+		auto Map(F&& transform) const & { return MapImpl(*this, std::forward<F>(transform)); }
+
+		template <typename F>
+		auto Map(F&& transform) && { return MapImpl(std::move(*this), std::forward<F>(transform)); }
+
+		/**
+		 * \brief Transforms every value into an option, so elements can become none.
+		 * Called on an rvalue column, values are moved into the transformation.
+		 * \tparam F transformation function that takes a value and returns an Option<U>
+		 * \param transform transformation function
+		 * \return OptionColumn<U>
+		 */
+		template <typename F>
+		auto Bind(F&& transform) const & { return BindImpl(*this, std::forward<F>(transform)); }
+
+		template <typename F>
+		auto Bind(F&& transform) && { return BindImpl(std::move(*this), std::forward<F>(transform)); }
+
+		/**
+		 * \brief Performs an action for every element, in order, depending on whether it has a value
+		 * \param ifNone action to perform for a none
+		 * \param ifSome action to perform with a value
+		 */
+		template <typename FN, typename FS>
+		void Match(FN&& ifNone, FS&& ifSome) const
+		{
+			someBits.ForEach(
+				[&](const std::size_t i) { std::invoke(ifSome, values[i]); },
+				[&](std::size_t) { std::invoke(ifNone, None()); });
+		}
+
+		/**
+		 * \brief Performs an action for every value, in order, skipping nones a word at a time
+		 * \param ifSome action to perform with a value
+		 */
+		template <typename F>
+		void WhenSome(F&& ifSome) const
+		{
+			someBits.ForEachSet([&](const std::size_t i) { std::invoke(ifSome, values[i]); });
+		}
+
+		/**
+		 * \brief Converts the column back into a vector of options
+		 * \return one option per element
+		 */
+		std::vector<Option<T>> ToVector() const &;
+		std::vector<Option<T>> ToVector() &&;
+
+		/**
+		 * \brief Takes the bitmap and values out of the column, the reverse of making a column out of them
+		 * \return which elements have a value, and the value of every element at its own index
+		 */
+		std::pair<ValidityBitmap, std::vector<T>> Release() && { return { std::move(someBits), std::move(values) }; }
+
+		friend bool operator==(const OptionColumn& a, const OptionColumn& b)
+		{
+			if(a.someBits != b.someBits) { return false; }
+			bool equal = true;
+			a.someBits.ForEachSet([&](const std::size_t i) { equal = equal && a.values[i] == b.values[i]; });
+			return equal;
+		}
+
+	private:
+		template <typename U>
+		friend class OptionColumn;
+
+		template <typename Self, typename F>
+		static auto MapImpl(Self&& self, F&& transform);
+
+		template <typename Self, typename F>
+		static auto BindImpl(Self&& self, F&& transform);
+
+		ValidityBitmap someBits;
+		std::vector<T> values;
+	};
+
+	template <typename T>
+	OptionColumn<T>::OptionColumn(const std::vector<Option<T>>& options)
+	{
+		someBits.Reserve(options.size());
+		values.reserve(options.size());
+		for(const auto& option : options) { PushBack(option); }
+	}
+
+	template <typename T>
+	OptionColumn<T>::OptionColumn(std::vector<Option<T>>&& options)
+	{
+		someBits.Reserve(options.size());
+		values.reserve(options.size());
+		for(auto& option : options) { PushBack(std::move(option)); }
+	}
+
+	template <typename T>
+	OptionColumn<T>::OptionColumn(ValidityBitmap someBits, std::vector<T> values) : someBits(std::move(someBits)), values(std::move(values))
+	{
+		if constexpr (ErrorsChecked)
+		{
+			if(this->someBits.Size() != this->values.size()) { Fail("OptionColumn needs one value per bit"); }
+		}
+	}
+
+	template <typename T>
+	void OptionColumn<T>::PushBack(Option<T> option)
+	{
+		std::move(option).Match(
+			[this](None) { PushNone(); },
+			[this](T&& value) { PushSome(std::move(value)); });
+	}
+
+	template <typename T>
+	void OptionColumn<T>::PushNone()
+	{
+		values.emplace_back();
+		someBits.PushBack(false);
+	}
+
+	template <typename T>
+	void OptionColumn<T>::PushSome(T value)
+	{
+		values.push_back(std::move(value));
+		someBits.PushBack(true);
+	}
+
+	template <typename T>
+	template <typename Self, typename F>
+	auto OptionColumn<T>::MapImpl(Self&& self, F&& transform)
+	{
+		using U = std::decay_t<std::invoke_result_t<F&, ForwardLike<Self, T>>>;
+		if constexpr (IsOption<U>::value)
+		{
+			return BindImpl(std::forward<Self>(self), std::forward<F>(transform));
+		}
+		else if constexpr (std::is_same_v<U, T> && !std::is_lvalue_reference_v<Self>)
+		{
+			// An rvalue column mapped to the same type is transformed in place, reusing its arrays
+			self.someBits.ForEachSet([&](const std::size_t i)
+			{
+				self.values[i] = std::invoke(transform, std::move(self.values[i]));
+			});
+			return std::move(self);
+		}
+		else
+		{
+			OptionColumn<U> result;
+			result.someBits = self.someBits;
+			result.values.resize(self.Size());
+			self.someBits.ForEachSet([&](const std::size_t i)
+			{
+				result.values[i] = std::invoke(transform, static_cast<ForwardLike<Self, T>>(self.values[i]));
+			});
+			return result;
+		}
+	}
+
+	template <typename T>
+	template <typename Self, typename F>
+	auto OptionColumn<T>::BindImpl(Self&& self, F&& transform)
+	{
+		using Result = std::decay_t<std::invoke_result_t<F&, ForwardLike<Self, T>>>;
+		static_assert(IsOption<Result>::value, "Bind transformation must return an Option, use Map to return a plain value");
+		using U = typename Result::ValueType;
+
+		if constexpr (std::is_same_v<U, T> && !std::is_lvalue_reference_v<Self>)
+		{
+			// An rvalue column bound to the same type is transformed in place, reusing its arrays
+			self.someBits.ForEachSet([&](const std::size_t i)
+			{
+				std::invoke(transform, std::move(self.values[i])).Match(
+					[&](None) { self.someBits.Reset(i); },
+					[&](U&& value) { self.values[i] = std::move(value); });
+			});
+			return std::move(self);
+		}
+		else
+		{
+			OptionColumn<U> result;
+			result.someBits = self.someBits;
+			result.values.resize(self.Size());
+			self.someBits.ForEachSet([&](const std::size_t i)
+			{
+				std::invoke(transform, static_cast<ForwardLike<Self, T>>(self.values[i])).Match(
+					[&](None) { result.someBits.Reset(i); },
+					[&](U&& value) { result.values[i] = std::move(value); });
+			});
+			return result;
+		}
+	}
+
+	template <typename T>
+	std::vector<Option<T>> OptionColumn<T>::ToVector() const &
+	{
+		std::vector<Option<T>> options;
+		options.reserve(Size());
+		someBits.ForEach(
+			[&](const std::size_t i) { options.emplace_back(values[i]); },
+			[&](std::size_t) { options.emplace_back(); });
+		return options;
+	}
+
+	template <typename T>
+	std::vector<Option<T>> OptionColumn<T>::ToVector() &&
+	{
+		std::vector<Option<T>> options;
+		options.reserve(Size());
+		someBits.ForEach(
+			[&](const std::size_t i) { options.emplace_back(std::move(values[i])); },
+			[&](std::size_t) { options.emplace_back(); });
+		return options;
+	}
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Either.h"
+
+namespace libmonad
+{
+	template <typename L, typename In, typename Out, typename... Stages>
+	class FusedPipeline;
+
+	/**
+	 * \brief Starts a lazy pipeline of Map and Bind stages, eg. Pipeline<int>::From<string>().Map(f).Bind(g).Map(h)
+	 * \tparam L Left type that every stage shares
+	 */
+	template <typename L>
+	struct Pipeline
+	{
+		/**
+		 * \brief A pipeline with no stages yet, that runs on an Either<L, R>
+		 * \tparam R Right type the pipeline starts with
+		 * \return pipeline that passes its input straight through
+		 */
+		template <typename R>
+		static constexpr FusedPipeline<L, R, R> From() { return {}; }
+	};
+
+	/**
+	 * \brief Right type of what a stage returns: T itself, or R when the stage returns an Either<L, R>
+	 * \tparam L Left type of the pipeline
+	 * \tparam T type the stage returns
+	 */
+	template <typename L, typename T>
+	struct StageRight { using Type = T; };
+
+	template <typename L, typename R>
+	struct StageRight<L, Either<L, R>> { using Type = R; };
+
+	/**
+	 * \brief A chain of Map and Bind stages composed into one function, built once and run on any number of inputs.
+	 * Running it checks for a left value once on entry, passes each right value straight into the next stage
+	 * without wrapping it in an Either, and returns as soon as a Bind stage produces a left value.
+	 * \tparam L Left type
+	 * \tparam In Right type the pipeline runs on
+	 * \tparam Out Right type the pipeline produces
+	 * \tparam Stages the functions, in order, that make up the pipeline
+	 */
+	template <typename L, typename In, typename Out, typename... Stages>
+	class FusedPipeline
+	{
+	public:
+		constexpr FusedPipeline() = default;
+
+		/**
+		 * \brief Makes a pipeline out of the given stages
+		 * \param stages functions that make up the pipeline
+		 */
+		constexpr explicit FusedPipeline(std::tuple<Stages...> stages) : stages(std::move(stages)) {}
+
+		/**
+		 * \brief Adds a stage that transforms the right value. Like Either::Map, the transformation may return a plain value or an Either<L, T>
+		 * \tparam F transformation function that takes the right value
+		 * \param transform transformation function
+		 * \return pipeline with the stage added
+		 */
+		template <typename F>
+		constexpr auto Map(F&& transform) const & { return Append(stages, std::forward<F>(transform)); }
+
+		template <typename F>
+		constexpr auto Map(F&& transform) && { return Append(std::move(stages), std::forward<F>(transform)); }
+
+		/**
+		 * \brief Adds a stage that transforms the right value into another either, ending the pipeline early if it is a left value
+		 * \tparam F transformation function that takes the right value and returns an Either<L, T>
+		 * \param transform transformation function
+		 * \return pipeline with the stage added
+		 */
+		template <typename F>
+		constexpr auto Bind(F&& transform) const &
+		{
+			static_assert(IsEither<std::decay_t<std::invoke_result_t<F, Out&&>>>::value, "Bind transformation must return an Either, use Map to return a plain value");
+			return Append(stages, std::forward<F>(transform));
+		}
+
+		template <typename F>
+		constexpr auto Bind(F&& transform) &&
+		{
+			static_assert(IsEither<std::decay_t<std::invoke_result_t<F, Out&&>>>::value, "Bind transformation must return an Either, use Map to return a plain value");
+			return Append(std::move(stages), std::forward<F>(transform));
+		}
+
+		/**
+		 * \brief Runs the pipeline on an either, passing a left value straight through
+		 * \param input either to run the pipeline on
+		 * \return the left value, or what the last stage produced
+		 */
+		constexpr Either<L, Out> Run(const Either<L, In>& input) const
+		{
+			return input.Match(
+				[](const L& left) { return Either<L, Out>(left); },
+				[this](const In& right) { return RunFrom<0>(right); });
+		}
+
+		constexpr Either<L, Out> Run(Either<L, In>&& input) const
+		{
+			return std::move(input).Match(
+				[](L&& left) { return Either<L, Out>(std::move(left)); },
+				[this](In&& right) { return RunFrom<0>(std::move(right)); });
+		}
+
+		/**
+		 * \brief Runs the pipeline on a right value, skipping the check on entry
+		 * \param input right value to run the pipeline on
+		 * \return the left value a Bind stage produced, or what the last stage produced
+		 */
+		constexpr Either<L, Out> Run(In input) const { return RunFrom<0>(std::move(input)); }
+
+		template <typename T>
+		constexpr Either<L, Out> operator()(T&& input) const { return Run(std::forward<T>(input)); }
+
+	private:
+		template <typename L2, typename In2, typename Out2, typename... Stages2>
+		friend class FusedPipeline;
+
+		template <typename Tuple, typename F>
+		static constexpr auto Append(Tuple&& stages, F&& transform)
+		{
+			using Result = std::decay_t<std::invoke_result_t<F, Out&&>>;
+			using Next = FusedPipeline<L, In, typename StageRight<L, Result>::Type, Stages..., std::decay_t<F>>;
+			static_assert(!IsEither<Result>::value || std::is_same_v<Result, Either<L, typename StageRight<L, Result>::Type>>,
+				"A stage that returns an Either must keep the pipeline's left type");
+
+			return Next(std::tuple_cat(std::forward<Tuple>(stages), std::tuple<std::decay_t<F>>(std::forward<F>(transform))));
+		}
+
+		/**
+		 * \brief Passes value through stage I and those after it, returning early if a stage produces a left value
+		 */
+		template <std::size_t I, typename T>
+		constexpr Either<L, Out> RunFrom(T&& value) const
+		{
+			if constexpr (I == sizeof...(Stages))
+			{
+				return Either<L, Out>(std::forward<T>(value));
+			}
+			else
+			{
+				auto result = std::invoke(std::get<I>(stages), std::forward<T>(value));
+				if constexpr (IsEither<decltype(result)>::value)
+				{
+					using Right = typename StageRight<L, decltype(result)>::Type;
+					return std::move(result).Match(
+						[](L&& left) { return Either<L, Out>(std::move(left)); },
+						[this](Right&& right) { return RunFrom<I + 1>(std::move(right)); });
+				}
+				else
+				{
+					return RunFrom<I + 1>(std::move(result));
+				}
+			}
+		}
+
+		std::tuple<Stages...> stages;
+	};
+}
@@ -0,0 +1,177 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace libmonad
+{
+	/**
+	 * \brief A vector that keeps its first N elements in place and moves them to the heap only when the N + 1th is added,
+	 * so a small number of elements costs no allocation. Capacity never shrinks back to N.
+	 * \tparam T type of element
+	 * \tparam N number of elements kept in place
+	 */
+	template <typename T, std::size_t N>
+	class SmallVector
+	{
+		static_assert(N > 0, "A SmallVector keeps at least one element in place");
+
+	public:
+		SmallVector() noexcept = default;
+
+		SmallVector(std::initializer_list<T> elements)
+		{
+			Reserve(elements.size());
+			for(const auto& element : elements) { EmplaceBack(element); }
+		}
+
+		SmallVector(const SmallVector& other)
+		{
+			Reserve(other.size);
+			for(const auto& element : other) { EmplaceBack(element); }
+		}
+
+		SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) { TakeFrom(other); }
+
+		SmallVector& operator=(const SmallVector& other)
+		{
+			if(this != &other)
+			{
+				Clear();
+				Reserve(other.size);
+				for(const auto& element : other) { EmplaceBack(element); }
+			}
+			return *this;
+		}
+
+		SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+		{
+			if(this != &other)
+			{
+				Clear();
+				Release();
+				TakeFrom(other);
+			}
+			return *this;
+		}
+
+		~SmallVector()
+		{
+			Clear();
+			Release();
+		}
+
+		std::size_t Size() const { return size; }
+		bool Empty() const { return size == 0; }
+		std::size_t Capacity() const { return capacity; }
+
+		/**
+		 * \brief Whether the elements are still kept in place, ie. nothing has been allocated
+		 */
+		bool IsInline() const { return elements == InlineElements(); }
+
+		T& operator[](const std::size_t i) { return elements[i]; }
+		const T& operator[](const std::size_t i) const { return elements[i]; }
+
+		T* begin() { return elements; }
+		T* end() { return elements + size; }
+		const T* begin() const { return elements; }
+		const T* end() const { return elements + size; }
+
+		/**
+		 * \brief Constructs an element at the end, moving every element to a larger heap block first if there is no room
+		 * \return the new element
+		 */
+		template <typename... Args>
+		T& EmplaceBack(Args&&... args)
+		{
+			if(size < capacity) { return *std::construct_at(elements + size++, std::forward<Args>(args)...); }
+
+			// The new element is made before the old ones move, as args may refer to one of them
+			const auto grown = std::max(capacity * 2, size + 1);
+			auto* const block = std::allocator<T>().allocate(grown);
+			std::construct_at(block + size, std::forward<Args>(args)...);
+			std::uninitialized_move(elements, elements + size, block);
+			std::destroy(elements, elements + size);
+			Release();
+			elements = block;
+			capacity = grown;
+			return elements[size++];
+		}
+
+		void PushBack(const T& element) { EmplaceBack(element); }
+		void PushBack(T&& element) { EmplaceBack(std::move(element)); }
+
+		/**
+		 * \brief Copies every element of another vector onto the end
+		 */
+		template <std::size_t M>
+		void Append(const SmallVector<T, M>& other)
+		{
+			Reserve(size + other.Size());
+			for(const auto& element : other) { EmplaceBack(element); }
+		}
+
+		/**
+		 * \brief Makes room for at least count elements without allocating again
+		 */
+		void Reserve(const std::size_t count)
+		{
+			if(count <= capacity) { return; }
+			auto* const block = std::allocator<T>().allocate(count);
+			std::uninitialized_move(elements, elements + size, block);
+			std::destroy(elements, elements + size);
+			Release();
+			elements = block;
+			capacity = count;
+		}
+
+		/**
+		 * \brief Destroys every element, keeping the capacity
+		 */
+		void Clear()
+		{
+			std::destroy(elements, elements + size);
+			size = 0;
+		}
+
+		friend bool operator==(const SmallVector& a, const SmallVector& b) { return std::equal(a.begin(), a.end(), b.begin(), b.end()); }
+
+	private:
+		T* InlineElements() { return reinterpret_cast<T*>(buffer); }
+		const T* InlineElements() const { return reinterpret_cast<const T*>(buffer); }
+
+		// Frees a heap block, leaving the empty vector in place
+		void Release()
+		{
+			if(!IsInline()) { std::allocator<T>().deallocate(elements, capacity); }
+			elements = InlineElements();
+			capacity = N;
+		}
+
+		// Takes other's heap block, or moves its elements in place when it has none. Expects this to be empty and in place.
+		void TakeFrom(SmallVector& other)
+		{
+			if(other.IsInline())
+			{
+				std::uninitialized_move(other.elements, other.elements + other.size, elements);
+				std::destroy(other.elements, other.elements + other.size);
+			}
+			else
+			{
+				elements = std::exchange(other.elements, other.InlineElements());
+				capacity = std::exchange(other.capacity, N);
+			}
+			size = std::exchange(other.size, 0);
+		}
+
+		T* elements = InlineElements();
+		std::size_t size = 0;
+		std::size_t capacity = N;
+		alignas(T) std::byte buffer[N * sizeof(T)];
+	};
+}
@@ -0,0 +1,519 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Either.h"
+#include "ErrorPolicy.h"
+#include "FramePool.h"
+#include "Option.h"
+
+namespace libmonad
+{
+	template <typename L, typename R>
+	class EitherStream;
+
+	template <typename T>
+	class OptionStream;
+
+	namespace detail
+	{
+		/**
+		 * \brief Promise of a stream coroutine: it starts suspended, runs to each co_yield when the next element is pulled and
+		 * hands the consumer the yielded element in place. Frames come from the current FrameAllocator, like those of tasks.
+		 * \tparam T type of element, an Either or an Option
+		 * \tparam Stream the stream the coroutine returns
+		 */
+		template <typename T, typename Stream>
+		class StreamPromise
+		{
+		public:
+			static void* operator new(const std::size_t size) { return AllocateFrame(size); }
+			static void operator delete(void* frame, const std::size_t size) noexcept { DeallocateFrame(frame, size); }
+
+			Stream get_return_object() { return Stream(std::coroutine_handle<StreamPromise>::from_promise(*this)); }
+
+			std::suspend_always initial_suspend() const noexcept { return {}; }
+			std::suspend_always final_suspend() const noexcept { return {}; }
+
+			/**
+			 * \brief Yields a temporary, which lives until the coroutine is resumed, so is handed over without a copy
+			 */
+			std::suspend_always yield_value(T&& element) noexcept
+			{
+				current = std::addressof(element);
+				return {};
+			}
+
+			/**
+			 * \brief Yields a copy of an element the coroutine keeps
+			 */
+			auto yield_value(const T& element)
+			{
+				struct CopyAwaiter
+				{
+					T copy;
+					bool await_ready() const noexcept { return false; }
+					void await_suspend(std::coroutine_handle<StreamPromise> frame) noexcept { frame.promise().current = std::addressof(copy); }
+					void await_resume() const noexcept {}
+				};
+				return CopyAwaiter{ element };
+			}
+
+			void return_void() const noexcept {}
+
+			// A stream is pulled, so has nothing to wait for
+			template <typename U>
+			std::suspend_never await_transform(U&&) = delete;
+
+			void unhandled_exception()
+			{
+#ifdef LIBMONAD_NO_EXCEPTIONS
+				std::abort();
+#else
+				exception = std::current_exception();
+#endif
+			}
+
+			T& Current() const { return *current; }
+
+			void RethrowIfFailed() const
+			{
+#ifndef LIBMONAD_NO_EXCEPTIONS
+				if(exception) { std::rethrow_exception(exception); }
+#endif
+			}
+
+		private:
+			T* current = nullptr;
+#ifndef LIBMONAD_NO_EXCEPTIONS
+			std::exception_ptr exception;
+#endif
+		};
+
+		/**
+		 * \brief Owns the frame of a stream coroutine and pulls elements from it one at a time
+		 */
+		template <typename T, typename Stream>
+		class StreamFrame
+		{
+		public:
+			using Promise = StreamPromise<T, Stream>;
+
+			/**
+			 * \brief Walks a stream once, resuming its coroutine on every increment
+			 */
+			class Iterator
+			{
+			public:
+				using iterator_category = std::input_iterator_tag;
+				using value_type = T;
+				using difference_type = std::ptrdiff_t;
+
+				Iterator() = default;
+				explicit Iterator(std::coroutine_handle<Promise> frame) : frame(frame) {}
+
+				T& operator*() const { return frame.promise().Current(); }
+				Iterator& operator++()
+				{
+					Advance(frame);
+					return *this;
+				}
+				void operator++(int) { ++*this; }
+
+				friend bool operator==(const Iterator& iterator, std::default_sentinel_t) { return iterator.frame.done(); }
+
+			private:
+				std::coroutine_handle<Promise> frame;
+			};
+
+			explicit StreamFrame(std::coroutine_handle<Promise> frame) : frame(frame) {}
+			StreamFrame(StreamFrame&& other) noexcept : frame(std::exchange(other.frame, nullptr)) {}
+			StreamFrame& operator=(StreamFrame&& other) noexcept
+			{
+				if(this != &other)
+				{
+					if(frame) { frame.destroy(); }
+					frame = std::exchange(other.frame, nullptr);
+				}
+				return *this;
+			}
+			~StreamFrame() { if(frame) { frame.destroy(); } }
+
+			/**
+			 * \brief Pulls the next element
+			 * \return whether there was one, in which case it is Current()
+			 */
+			bool Advance() const
+			{
+				if constexpr (ErrorsChecked)
+				{
+					if(!frame) { Fail("stream has no elements: it has been moved from"); }
+				}
+				return Advance(frame);
+			}
+
+			T& Current() const { return frame.promise().Current(); }
+
+			/**
+			 * \brief Pulls the first element not yet pulled
+			 */
+			Iterator begin() const
+			{
+				Advance();
+				return Iterator(frame);
+			}
+
+			static bool Advance(const std::coroutine_handle<Promise> frame)
+			{
+				if(frame.done()) { return false; }
+				frame.resume();
+				frame.promise().RethrowIfFailed();
+				return !frame.done();
+			}
+
+		private:
+			std::coroutine_handle<Promise> frame;
+		};
+
+		template <typename T>
+		struct StreamOfElement;
+
+		template <typename L, typename R>
+		struct StreamOfElement<Either<L, R>> { using Type = EitherStream<L, R>; };
+
+		template <typename T>
+		struct StreamOfElement<Option<T>> { using Type = OptionStream<T>; };
+
+		/**
+		 * \brief The stream of elements of type T, an Either or an Option
+		 */
+		template <typename T>
+		using StreamOf = typename StreamOfElement<T>::Type;
+
+		template <typename Element, typename Stream, typename F>
+		using MappedStream = StreamOf<std::decay_t<decltype(std::declval<Element>().Map(std::declval<F&>()))>>;
+
+		template <typename Element, typename Stream, typename F>
+		using BoundStream = StreamOf<std::decay_t<decltype(std::declval<Element>().Bind(std::declval<F&>()))>>;
+
+		// Each stage is a coroutine that owns the stream it pulls from and yields one element for each it pulls,
+		// so elements pass through a chain of stages one at a time
+
+		template <typename Element, typename Stream, typename F>
+		MappedStream<Element, Stream, F> MapStage(Stream source, F transform)
+		{
+			for(auto& element : source) { co_yield std::move(element).Map(transform); }
+		}
+
+		template <typename Element, typename Stream, typename F>
+		BoundStream<Element, Stream, F> BindStage(Stream source, F transform)
+		{
+			for(auto& element : source) { co_yield std::move(element).Bind(transform); }
+		}
+	}
+
+	/**
+	 * \brief A lazy, single pass stream of eithers: each element is produced only when it is pulled, and passes through every
+	 * Map, Bind and Filter stage before the next is produced, so a stream of any length is processed in constant memory.
+	 * A stream is the return type of a coroutine that co_yields its elements, eg.
+	 *
+	 * EitherStream<int, long> Records(std::istream& in)
+	 * {
+	 *     for(std::string line; std::getline(in, line);) { co_yield Parse(line); }
+	 * }
+	 *
+	 * long total = 0;
+	 * for(auto& record : Records(in).Map(Normalise).Bind(Validate).TakeWhileRight()) { total += record.ThrowIfLeft(); }
+	 *
+	 * Each stage takes the stream it is called on, which cannot be used afterwards.
+	 * \tparam L Left type
+	 * \tparam R Right type
+	 */
+	template <typename L, typename R>
+	class EitherStream
+	{
+		using Frame = detail::StreamFrame<Either<L, R>, EitherStream>;
+
+	public:
+		using promise_type = typename Frame::Promise;
+		using LeftType = L;
+		using RightType = R;
+
+		EitherStream(EitherStream&&) noexcept = default;
+		EitherStream& operator=(EitherStream&&) noexcept = default;
+
+		/**
+		 * \brief Pulls the next element, whose value can be moved from
+		 */
+		typename Frame::Iterator begin() const { return frame.begin(); }
+		std::default_sentinel_t end() const { return {}; }
+
+		/**
+		 * \brief Pulls the next element
+		 * \return the element, or none at the end of the stream
+		 */
+		Option<Either<L, R>> Next()
+		{
+			if(!frame.Advance()) { return None(); }
+			return std::move(frame.Current());
+		}
+
+		/**
+		 * \brief Transforms the right value of each element as it is pulled
+		 * \tparam F transformation function that takes a right value and returns a T or an Either<L, T>
+		 * \param transform transformation function
+		 * \return EitherStream<L, T>
+		 */
+		template <typename F>
+		auto Map(F&& transform) &&
+		{
+			return detail::MapStage<Either<L, R>>(std::move(*this), std::decay_t<F>(std::forward<F>(transform)));
+		}
+
+		/**
+		 * \brief Transforms the right value of each element into an either as it is pulled, so elements can become left
+		 * \tparam F transformation function that takes a right value and returns an Either<L, T>
+		 * \param transform transformation function
+		 * \return EitherStream<L, T>
+		 */
+		template <typename F>
+		auto Bind(F&& transform) &&
+		{
+			return detail::BindStage<Either<L, R>>(std::move(*this), std::decay_t<F>(std::forward<F>(transform)));
+		}
+
+		/**
+		 * \brief Drops right elements whose value does not satisfy a predicate. Left elements are kept.
+		 * \param predicate function that takes a const R& and returns whether to keep it
+		 */
+		template <typename F>
+		EitherStream Filter(F&& predicate) && { return FilterStage(std::move(*this), std::decay_t<F>(std::forward<F>(predicate))); }
+
+		/**
+		 * \brief Ends the stream at its first left element, which is dropped, without pulling anything after it
+		 */
+		EitherStream TakeWhileRight() && { return TakeWhileRightStage(std::move(*this)); }
+
+		/**
+		 * \brief Groups right values into chunks of up to size values. A left element ends the chunk being filled, and follows it.
+		 * \param size most values in a chunk
+		 * \return EitherStream<L, std::vector<R>>
+		 */
+		EitherStream<L, std::vector<R>> Chunk(const std::size_t size) && { return ChunkStage(std::move(*this), size); }
+
+		/**
+		 * \brief Pulls the whole stream, stopping at the first left element
+		 * \return the first left value, or every right value in order
+		 */
+		Either<L, std::vector<R>> CollectOrFirstLeft() &&
+		{
+			std::vector<R> rights;
+			for(auto& either : *this)
+			{
+				if(either.IsLeft()) { return std::move(either).Map([](R&&) { return std::vector<R>(); }); }
+				rights.push_back(std::move(either).ThrowIfLeft());
+			}
+			return rights;
+		}
+
+	private:
+		friend class detail::StreamPromise<Either<L, R>, EitherStream>;
+
+		explicit EitherStream(std::coroutine_handle<promise_type> frame) : frame(frame) {}
+
+		template <typename F>
+		static EitherStream FilterStage(EitherStream source, F predicate)
+		{
+			for(auto& either : source)
+			{
+				if(either.IsLeft() || predicate(std::as_const(either.ThrowIfLeft()))) { co_yield std::move(either); }
+			}
+		}
+
+		static EitherStream TakeWhileRightStage(EitherStream source)
+		{
+			for(auto& either : source)
+			{
+				if(either.IsLeft()) { co_return; }
+				co_yield std::move(either);
+			}
+		}
+
+		static EitherStream<L, std::vector<R>> ChunkStage(EitherStream source, const std::size_t size)
+		{
+			std::vector<R> chunk;
+			chunk.reserve(size);
+			for(auto& either : source)
+			{
+				if(either.IsRight())
+				{
+					chunk.push_back(std::move(either).ThrowIfLeft());
+					if(chunk.size() < size) { continue; }
+				}
+				if(!chunk.empty())
+				{
+					co_yield Either<L, std::vector<R>>(std::move(chunk));
+					chunk.clear();
+					chunk.reserve(size);
+				}
+				if(either.IsLeft()) { co_yield std::move(either).Map([](R&&) { return std::vector<R>(); }); }
+			}
+			if(!chunk.empty()) { co_yield Either<L, std::vector<R>>(std::move(chunk)); }
+		}
+
+		Frame frame;
+	};
+
+	/**
+	 * \brief A lazy, single pass stream of options: each element is produced only when it is pulled, and passes through every
+	 * Map, Bind and Filter stage before the next is produced, so a stream of any length is processed in constant memory.
+	 * A stream is the return type of a coroutine that co_yields its elements, eg.
+	 *
+	 * OptionStream<Order> Orders(const std::vector<long>& ids)
+	 * {
+	 *     for(const auto id : ids) { co_yield FindOrder(id); }
+	 * }
+	 *
+	 * Each stage takes the stream it is called on, which cannot be used afterwards.
+	 * \tparam T type of value
+	 */
+	template <typename T>
+	class OptionStream
+	{
+		using Frame = detail::StreamFrame<Option<T>, OptionStream>;
+
+	public:
+		using promise_type = typename Frame::Promise;
+		using ValueType = T;
+
+		OptionStream(OptionStream&&) noexcept = default;
+		OptionStream& operator=(OptionStream&&) noexcept = default;
+
+		/**
+		 * \brief Pulls the next element, whose value can be moved from
+		 */
+		typename Frame::Iterator begin() const { return frame.begin(); }
+		std::default_sentinel_t end() const { return {}; }
+
+		/**
+		 * \brief Pulls the next element
+		 * \return the element, or none at the end of the stream
+		 */
+		Option<Option<T>> Next()
+		{
+			if(!frame.Advance()) { return None(); }
+			return std::move(frame.Current());
+		}
+
+		/**
+		 * \brief Transforms the value of each element as it is pulled
+		 * \tparam F transformation function that takes a value and returns a U or an Option<U>
+		 * \param transform transformation function
+		 * \return OptionStream<U>
+		 */
+		template <typename F>
+		auto Map(F&& transform) &&
+		{
+			return detail::MapStage<Option<T>>(std::move(*this), std::decay_t<F>(std::forward<F>(transform)));
+		}
+
+		/**
+		 * \brief Transforms the value of each element into an option as it is pulled, so elements can become none
+		 * \tparam F transformation function that takes a value and returns an Option<U>
+		 * \param transform transformation function
+		 * \return OptionStream<U>
+		 */
+		template <typename F>
+		auto Bind(F&& transform) &&
+		{
+			return detail::BindStage<Option<T>>(std::move(*this), std::decay_t<F>(std::forward<F>(transform)));
+		}
+
+		/**
+		 * \brief Drops elements whose value does not satisfy a predicate. None elements are kept.
+		 * \param predicate function that takes a const T& and returns whether to keep it
+		 */
+		template <typename F>
+		OptionStream Filter(F&& predicate) && { return FilterStage(std::move(*this), std::decay_t<F>(std::forward<F>(predicate))); }
+
+		/**
+		 * \brief Ends the stream at its first none, without pulling anything after it
+		 */
+		OptionStream TakeWhileSome() && { return TakeWhileSomeStage(std::move(*this)); }
+
+		/**
+		 * \brief Groups values into chunks of up to size values. A none ends the chunk being filled, and follows it.
+		 * \param size most values in a chunk
+		 * \return OptionStream<std::vector<T>>
+		 */
+		OptionStream<std::vector<T>> Chunk(const std::size_t size) && { return ChunkStage(std::move(*this), size); }
+
+		/**
+		 * \brief Pulls the whole stream, stopping at the first none
+		 * \return none, or every value in order
+		 */
+		Option<std::vector<T>> CollectOrNone() &&
+		{
+			std::vector<T> values;
+			for(auto& option : *this)
+			{
+				if(option.IsNone()) { return None(); }
+				values.push_back(std::move(option).ThrowIfNone());
+			}
+			return values;
+		}
+
+	private:
+		friend class detail::StreamPromise<Option<T>, OptionStream>;
+
+		explicit OptionStream(std::coroutine_handle<promise_type> frame) : frame(frame) {}
+
+		template <typename F>
+		static OptionStream FilterStage(OptionStream source, F predicate)
+		{
+			for(auto& option : source)
+			{
+				if(option.IsNone() || predicate(std::as_const(option.ThrowIfNone()))) { co_yield std::move(option); }
+			}
+		}
+
+		static OptionStream TakeWhileSomeStage(OptionStream source)
+		{
+			for(auto& option : source)
+			{
+				if(option.IsNone()) { co_return; }
+				co_yield std::move(option);
+			}
+		}
+
+		static OptionStream<std::vector<T>> ChunkStage(OptionStream source, const std::size_t size)
+		{
+			std::vector<T> chunk;
+			chunk.reserve(size);
+			for(auto& option : source)
+			{
+				if(option.IsSome())
+				{
+					chunk.push_back(std::move(option).ThrowIfNone());
+					if(chunk.size() < size) { continue; }
+				}
+				if(!chunk.empty())
+				{
+					co_yield Option<std::vector<T>>(std::move(chunk));
+					chunk.clear();
+					chunk.reserve(size);
+				}
+				if(option.IsNone()) { co_yield Option<std::vector<T>>(); }
+			}
+			if(!chunk.empty()) { co_yield Option<std::vector<T>>(std::move(chunk)); }
+		}
+
+		Frame frame;
+	};
+}
@@ -0,0 +1,277 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+#include "Either.h"
+#include "ErrorPolicy.h"
+#include "FramePool.h"
+#include "Option.h"
+
+namespace libmonad
+{
+	template <typename L, typename R>
+	class EitherTask;
+
+	template <typename T>
+	class OptionTask;
+
+	namespace detail
+	{
+		/**
+		 * \brief What EitherTask and OptionTask promises share: the coroutine runs straight away, stops before its frame is freed
+		 * so the task can take its result, and allocates its frame from the current FrameAllocator when it cannot be elided
+		 */
+		class TaskPromise
+		{
+		public:
+			static void* operator new(const std::size_t size) { return AllocateFrame(size); }
+			static void operator delete(void* frame, const std::size_t size) noexcept { DeallocateFrame(frame, size); }
+
+			std::suspend_never initial_suspend() const noexcept { return {}; }
+			std::suspend_always final_suspend() const noexcept { return {}; }
+
+			void unhandled_exception()
+			{
+#ifdef LIBMONAD_NO_EXCEPTIONS
+				std::abort();
+#else
+				exception = std::current_exception();
+#endif
+			}
+
+		protected:
+			void RethrowIfFailed() const
+			{
+#ifndef LIBMONAD_NO_EXCEPTIONS
+				if(exception) { std::rethrow_exception(exception); }
+#endif
+			}
+
+		private:
+#ifndef LIBMONAD_NO_EXCEPTIONS
+			std::exception_ptr exception;
+#endif
+		};
+
+		/**
+		 * \brief Owns the frame of a finished (or short circuited) coroutine
+		 */
+		template <typename Promise>
+		class TaskFrame
+		{
+		public:
+			explicit TaskFrame(std::coroutine_handle<Promise> frame) : frame(frame) {}
+			TaskFrame(TaskFrame&& other) noexcept : frame(std::exchange(other.frame, nullptr)) {}
+			TaskFrame& operator=(TaskFrame&& other) noexcept
+			{
+				if(this != &other)
+				{
+					if(frame) { frame.destroy(); }
+					frame = std::exchange(other.frame, nullptr);
+				}
+				return *this;
+			}
+			~TaskFrame() { if(frame) { frame.destroy(); } }
+
+			Promise& Get() const
+			{
+				if constexpr (ErrorsChecked)
+				{
+					if(!frame) { Fail("task has no result: it has been moved from"); }
+				}
+				return frame.promise();
+			}
+
+		private:
+			std::coroutine_handle<Promise> frame;
+		};
+
+		/**
+		 * \brief Awaits an Either: resumes with the right value, or stores the left value as the task's result and never resumes
+		 * \tparam E type of the either awaited: a reference to one that outlives the co_await, or the either itself
+		 */
+		template <typename E>
+		class EitherAwaiter
+		{
+			using Awaited = std::remove_cvref_t<E>;
+			using LeftArg = ForwardLike<E, typename Awaited::LeftType>;
+			using RightArg = ForwardLike<E, typename Awaited::RightType>;
+
+		public:
+			explicit EitherAwaiter(E&& either) : either(std::forward<E>(either)) {}
+
+			bool await_ready() const noexcept { return either.IsRight(); }
+
+			template <typename Promise>
+			void await_suspend(std::coroutine_handle<Promise> frame)
+			{
+				std::forward<E>(either).Match(
+					[&](LeftArg left) { frame.promise().SetLeft(std::forward<LeftArg>(left)); },
+					[](RightArg) {});
+			}
+
+			decltype(auto) await_resume() { return std::forward<E>(either).ThrowIfLeft(); }
+
+		private:
+			E either;
+		};
+
+		/**
+		 * \brief Awaits an Option: resumes with the value, or leaves the task's result none and never resumes
+		 * \tparam O type of the option awaited: a reference to one that outlives the co_await, or the option itself
+		 */
+		template <typename O>
+		class OptionAwaiter
+		{
+		public:
+			explicit OptionAwaiter(O&& option) : option(std::forward<O>(option)) {}
+
+			bool await_ready() const noexcept { return option.IsSome(); }
+			void await_suspend(std::coroutine_handle<>) const noexcept {}
+			decltype(auto) await_resume() { return std::forward<O>(option).ThrowIfNone(); }
+
+		private:
+			O option;
+		};
+	}
+
+	/**
+	 * \brief Return type of a coroutine that works on eithers as if they were plain values: co_await on an Either gives its right value,
+	 * or ends the coroutine with its left value. co_return gives the result, a right value or a left value. The coroutine runs to completion
+	 * when called, and its frame is allocated from the thread's FrameAllocator when the compiler cannot elide it. eg.
+	 *
+	 * EitherTask<int, long> Total(const string& a, const string& b)
+	 * {
+	 *     const long x = co_await Parse(a);
+	 *     const long y = co_await Parse(b);
+	 *     co_return x + y;
+	 * }
+	 *
+	 * \tparam L Left type
+	 * \tparam R Right type
+	 */
+	template <typename L, typename R>
+	class EitherTask
+	{
+	public:
+		class promise_type : public detail::TaskPromise
+		{
+		public:
+			EitherTask get_return_object() { return EitherTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+			void return_value(Either<L, R> value) { result = std::move(value); }
+
+			template <typename Left>
+			void SetLeft(Left&& left) { result = Either<L, R>(L(std::forward<Left>(left))); }
+
+			/**
+			 * \brief co_await on an Either whose left value converts to L
+			 */
+			template <typename E> requires IsEither<std::remove_cvref_t<E>>::value
+			auto await_transform(E&& either)
+			{
+				static_assert(std::is_convertible_v<typename std::remove_cvref_t<E>::LeftType, L>, "an awaited Either's left type must convert to the task's left type");
+				return detail::EitherAwaiter<E&&>(std::forward<E>(either));
+			}
+
+			/**
+			 * \brief co_await on another EitherTask, whose result is taken and awaited as an Either
+			 */
+			template <typename L2, typename R2>
+			auto await_transform(EitherTask<L2, R2>&& task)
+			{
+				static_assert(std::is_convertible_v<L2, L>, "an awaited EitherTask's left type must convert to the task's left type");
+				return detail::EitherAwaiter<Either<L2, R2>>(std::move(task).Result());
+			}
+
+			Either<L, R> TakeResult()
+			{
+				RethrowIfFailed();
+				return std::move(result);
+			}
+
+		private:
+			Either<L, R> result;
+		};
+
+		EitherTask(EitherTask&&) noexcept = default;
+		EitherTask& operator=(EitherTask&&) noexcept = default;
+
+		/**
+		 * \brief Takes the coroutine's result, rethrowing any exception that escaped it
+		 * \return the left value it ended with, or the result it returned
+		 */
+		Either<L, R> Result() && { return frame.Get().TakeResult(); }
+
+		operator Either<L, R>() && { return std::move(*this).Result(); }
+
+	private:
+		explicit EitherTask(std::coroutine_handle<promise_type> frame) : frame(frame) {}
+
+		detail::TaskFrame<promise_type> frame;
+	};
+
+	/**
+	 * \brief Return type of a coroutine that works on options as if they were plain values: co_await on an Option gives its value,
+	 * or ends the coroutine with none. co_return gives the result, a value or None(). eg.
+	 *
+	 * OptionTask<int> Total(const Option<int>& a, const Option<int>& b)
+	 * {
+	 *     co_return co_await a + co_await b;
+	 * }
+	 *
+	 * \tparam T type of value
+	 */
+	template <typename T>
+	class OptionTask
+	{
+	public:
+		class promise_type : public detail::TaskPromise
+		{
+		public:
+			OptionTask get_return_object() { return OptionTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+			void return_value(Option<T> value) { result = std::move(value); }
+
+			/**
+			 * \brief co_await on an Option
+			 */
+			template <typename O> requires IsOption<std::remove_cvref_t<O>>::value
+			auto await_transform(O&& option) { return detail::OptionAwaiter<O&&>(std::forward<O>(option)); }
+
+			/**
+			 * \brief co_await on another OptionTask, whose result is taken and awaited as an Option
+			 */
+			template <typename T2>
+			auto await_transform(OptionTask<T2>&& task) { return detail::OptionAwaiter<Option<T2>>(std::move(task).Result()); }
+
+			Option<T> TakeResult()
+			{
+				RethrowIfFailed();
+				return std::move(result);
+			}
+
+		private:
+			Option<T> result;
+		};
+
+		OptionTask(OptionTask&&) noexcept = default;
+		OptionTask& operator=(OptionTask&&) noexcept = default;
+
+		/**
+		 * \brief Takes the coroutine's result, rethrowing any exception that escaped it
+		 * \return none if it awaited a none, otherwise the result it returned
+		 */
+		Option<T> Result() && { return frame.Get().TakeResult(); }
+
+		operator Option<T>() && { return std::move(*this).Result(); }
+
+	private:
+		explicit OptionTask(std::coroutine_handle<promise_type> frame) : frame(frame) {}
+
+		detail::TaskFrame<promise_type> frame;
+	};
+}
@@ -0,0 +1,158 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ErrorPolicy.h"
+
+namespace libmonad
+{
+	/**
+	 * \brief A fixed number of threads that run tasks from a shared queue
+	 */
+	class ThreadPool
+	{
+	public:
+		/**
+		 * \brief Starts the threads
+		 * \param threads number of threads, by default one per hardware thread
+		 */
+		explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency());
+
+		/**
+		 * \brief Runs the tasks already queued, then stops the threads
+		 */
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/**
+		 * \brief Number of threads
+		 */
+		std::size_t Size() const { return threads.size(); }
+
+		/**
+		 * \brief Queues a task to run on one of the threads
+		 * \param task task to run
+		 */
+		void Submit(std::function<void()> task);
+
+		/**
+		 * \brief Calls process(i) for every i in [0, count) across the pool's threads and the calling thread, returning once every call has.
+		 * Indices are handed out in increasing order, one at a time, to whichever thread is free.
+		 * If a call throws, the first exception is rethrown here once the rest have finished.
+		 * Must not be called from one of the pool's own threads.
+		 * \param count number of calls
+		 * \param process function taking an index, which may be called from several threads at once
+		 */
+		template <typename F>
+		void ParallelFor(std::size_t count, F&& process);
+
+	private:
+		void Work();
+
+		std::vector<std::thread> threads;
+		std::deque<std::function<void()>> tasks;
+		std::mutex mutex;
+		std::condition_variable wake;
+		bool stopping = false;
+	};
+
+	inline ThreadPool::ThreadPool(std::size_t threads)
+	{
+		if(threads == 0) { threads = 1; }
+		this->threads.reserve(threads);
+		for(std::size_t i = 0; i < threads; i++) { this->threads.emplace_back([this] { Work(); }); }
+	}
+
+	inline ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock(mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for(auto& thread : threads) { thread.join(); }
+	}
+
+	inline void ThreadPool::Submit(std::function<void()> task)
+	{
+		{
+			std::lock_guard lock(mutex);
+			tasks.push_back(std::move(task));
+		}
+		wake.notify_one();
+	}
+
+	inline void ThreadPool::Work()
+	{
+		for(;;)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock lock(mutex);
+				wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+				if(tasks.empty()) { return; }
+				task = std::move(tasks.front());
+				tasks.pop_front();
+			}
+			task();
+		}
+	}
+
+	template <typename F>
+	void ThreadPool::ParallelFor(const std::size_t count, F&& process)
+	{
+		if(count == 0) { return; }
+
+		// Shared with the queued tasks, which may only start after every index has been handed out and this has returned.
+		// Such a task finds no index left and returns without touching process, which lives on this caller's stack.
+		struct State
+		{
+			explicit State(const std::size_t count) : count(count) {}
+
+			const std::size_t count;
+			std::atomic<std::size_t> next{0};
+			std::atomic<std::size_t> done{0};
+			std::exception_ptr error;
+			std::once_flag errorOnce;
+		};
+
+		const auto state = std::make_shared<State>(count);
+		auto run = [state, process = &process]
+		{
+			for(auto i = state->next.fetch_add(1, std::memory_order_relaxed); i < state->count; i = state->next.fetch_add(1, std::memory_order_relaxed))
+			{
+#ifdef LIBMONAD_NO_EXCEPTIONS
+				(*process)(i);
+#else
+				try { (*process)(i); }
+				catch(...) { std::call_once(state->errorOnce, [&] { state->error = std::current_exception(); }); }
+#endif
+				if(state->done.fetch_add(1, std::memory_order_acq_rel) + 1 == state->count) { state->done.notify_all(); }
+			}
+		};
+
+		const auto helpers = count - 1 < threads.size() ? count - 1 : threads.size();
+		for(std::size_t i = 0; i < helpers; i++) { Submit(run); }
+		run();
+
+		for(auto done = state->done.load(std::memory_order_acquire); done != count; done = state->done.load(std::memory_order_acquire))
+		{
+			state->done.wait(done, std::memory_order_acquire);
+		}
+
+#ifndef LIBMONAD_NO_EXCEPTIONS
+		if(state->error) { std::rethrow_exception(state->error); }
+#endif
+	}
+}
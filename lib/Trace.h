@@ -0,0 +1,421 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Either.h"
+#include "Option.h"
+
+/*
+ * Traces named stages of Either and Option pipelines, to find which stage short circuits most and where the time goes.
+ * Wrap a function given to Map() or Bind() in Traced<"name">(function), and define LIBMONAD_TRACE to 1 before including any
+ * libmonad header, or pass it to the compiler, to record for each name:
+ *
+ * - how many calls returned a left value (or none), and how many a right value (or some) or a plain value
+ * - how long the calls took, in cycles of the time stamp counter where there is one and nanoseconds otherwise,
+ *   as a histogram by powers of two
+ *
+ * Each thread records into counters of its own, without locking or atomic read-modify-writes, and Trace::Snapshot() adds
+ * up those of every thread. A snapshot can be written as text, as JSON, or as a header of branch hints (see lib/BranchHints.h).
+ *
+ * Left undefined (or 0), Traced returns the function itself, and Trace::Snapshot() is empty.
+ * Every translation unit of a program must agree on LIBMONAD_TRACE.
+ */
+#ifndef LIBMONAD_TRACE
+#define LIBMONAD_TRACE 0
+#endif
+
+// Most distinct stage names a traced program records; calls of any more are not recorded
+#ifndef LIBMONAD_TRACE_MAX_STAGES
+#define LIBMONAD_TRACE_MAX_STAGES 64
+#endif
+
+#if LIBMONAD_TRACE
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace libmonad
+{
+	/**
+	 * \brief The name of a traced stage, given as a string literal template argument
+	 */
+	template <std::size_t N>
+	struct StageName
+	{
+		constexpr StageName(const char (&name)[N]) { std::copy_n(name, N, chars); }
+		constexpr std::string_view View() const { return { chars, N - 1 }; }
+
+		char chars[N];
+	};
+
+	/**
+	 * \brief Number of latency buckets: bucket i counts calls that took less than 2^i cycles, and at least 2^(i - 1)
+	 */
+	constexpr std::size_t TraceLatencyBuckets = 32;
+
+	/**
+	 * \brief What was recorded for one stage
+	 */
+	struct StageTrace
+	{
+		std::string name;
+		std::uint64_t lefts = 0;
+		std::uint64_t rights = 0;
+		std::array<std::uint64_t, TraceLatencyBuckets> latency{};
+
+		std::uint64_t Calls() const { return lefts + rights; }
+		double LeftRate() const { return Calls() == 0 ? 0 : static_cast<double>(lefts) / static_cast<double>(Calls()); }
+
+		/**
+		 * \brief Fewest cycles that at least a fraction of calls took no more than, to the next power of two
+		 */
+		std::uint64_t LatencyPercentile(const double fraction) const
+		{
+			const auto wanted = static_cast<double>(Calls()) * fraction;
+			std::uint64_t seen = 0;
+			for(std::size_t bucket = 0; bucket < TraceLatencyBuckets; bucket++)
+			{
+				seen += latency[bucket];
+				if(seen > 0 && static_cast<double>(seen) >= wanted) { return std::uint64_t(1) << bucket; }
+			}
+			return 0;
+		}
+	};
+
+	/**
+	 * \brief What every stage recorded, from every thread, when the snapshot was taken
+	 */
+	struct TraceSnapshot
+	{
+		std::vector<StageTrace> stages;
+
+		/**
+		 * \brief The stage recorded under a name, or null
+		 */
+		const StageTrace* Find(const std::string_view name) const
+		{
+			const auto found = std::find_if(stages.begin(), stages.end(), [name](const StageTrace& stage) { return stage.name == name; });
+			return found == stages.end() ? nullptr : &*found;
+		}
+
+		/**
+		 * \brief One line for each stage: its name, calls, lefts, left rate and median and 99th percentile latency
+		 */
+		std::string ToText() const
+		{
+			std::ostringstream text;
+			text << std::fixed << std::setprecision(4);
+			for(const auto& stage : stages)
+			{
+				text << stage.name << " calls=" << stage.Calls() << " lefts=" << stage.lefts << " left_rate=" << stage.LeftRate()
+					<< " p50<=" << stage.LatencyPercentile(0.5) << " p99<=" << stage.LatencyPercentile(0.99) << '\n';
+			}
+			return text.str();
+		}
+
+		/**
+		 * \brief An array with an object for each stage, holding its name, counts and latency histogram
+		 */
+		std::string ToJson() const
+		{
+			std::ostringstream json;
+			json << '[';
+			for(std::size_t i = 0; i < stages.size(); i++)
+			{
+				const auto& stage = stages[i];
+				json << (i == 0 ? "" : ",") << "{\"name\":\"";
+				for(const auto c : stage.name) { json << (c == '"' || c == '\\' ? "\\" : "") << c; }
+				json << "\",\"lefts\":" << stage.lefts << ",\"rights\":" << stage.rights
+					<< ",\"latency\":[";
+				for(std::size_t bucket = 0; bucket < TraceLatencyBuckets; bucket++) { json << (bucket == 0 ? "" : ",") << stage.latency[bucket]; }
+				json << "]}";
+			}
+			json << ']';
+			return json.str();
+		}
+
+		/**
+		 * \brief A header to build with as LIBMONAD_BRANCH_PROFILE, hinting that lefts are unlikely if fewer than a fraction of
+		 * all traced calls returned one, or likely if more than a fraction did
+		 */
+		std::string ToHints(const double unlikelyBelow = 0.05, const double likelyAbove = 0.95) const
+		{
+			std::uint64_t lefts = 0;
+			std::uint64_t calls = 0;
+			std::ostringstream hints;
+			hints << std::fixed << std::setprecision(4);
+			hints << "// Branch hints from a libmonad trace (see lib/BranchHints.h)\n#pragma once\n\n";
+			for(const auto& stage : stages)
+			{
+				hints << "// " << stage.name << ": " << stage.Calls() << " calls, left rate " << stage.LeftRate() << '\n';
+				lefts += stage.lefts;
+				calls += stage.Calls();
+			}
+
+			const auto leftRate = calls == 0 ? 0.5 : static_cast<double>(lefts) / static_cast<double>(calls);
+			if(leftRate < unlikelyBelow) { hints << "\n#define LIBMONAD_LEFT_HINT [[unlikely]]\n"; }
+			else if(leftRate > likelyAbove) { hints << "\n#define LIBMONAD_LEFT_HINT [[likely]]\n"; }
+			return hints.str();
+		}
+	};
+
+	namespace detail
+	{
+		template <typename T>
+		constexpr bool WentRight(const T& result)
+		{
+			if constexpr (IsEither<T>::value) { return result.IsRight(); }
+			else if constexpr (IsOption<T>::value) { return !result.IsNone(); }
+			else { return true; }
+		}
+	}
+
+#if LIBMONAD_TRACE
+	namespace detail
+	{
+		constexpr std::size_t MaxTracedStages = LIBMONAD_TRACE_MAX_STAGES;
+
+		inline std::uint64_t ReadCycles() noexcept
+		{
+#if (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))) || defined(__x86_64__) || defined(__i386__)
+			return __rdtsc();
+#else
+			return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+		}
+
+		/**
+		 * \brief One thread's counts for one stage. Only the thread adds to them, with a plain load and store,
+		 * and they are atomic only so that a snapshot can read them meanwhile.
+		 */
+		struct StageCounters
+		{
+			std::atomic<std::uint64_t> lefts{0};
+			std::atomic<std::uint64_t> rights{0};
+			std::atomic<std::uint64_t> latency[TraceLatencyBuckets] = {};
+
+			static void Bump(std::atomic<std::uint64_t>& counter, const std::uint64_t by = 1) noexcept
+			{
+				counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+			}
+
+			void Record(const bool right, const std::uint64_t cycles) noexcept
+			{
+				Bump(right ? rights : lefts);
+				Bump(latency[std::min<std::size_t>(std::bit_width(cycles), TraceLatencyBuckets - 1)]);
+			}
+
+			void AddTo(StageTrace& total) const noexcept
+			{
+				total.lefts += lefts.load(std::memory_order_relaxed);
+				total.rights += rights.load(std::memory_order_relaxed);
+				for(std::size_t bucket = 0; bucket < TraceLatencyBuckets; bucket++) { total.latency[bucket] += latency[bucket].load(std::memory_order_relaxed); }
+			}
+
+			void Reset() noexcept
+			{
+				lefts.store(0, std::memory_order_relaxed);
+				rights.store(0, std::memory_order_relaxed);
+				for(auto& bucket : latency) { bucket.store(0, std::memory_order_relaxed); }
+			}
+		};
+
+		struct ThreadTrace
+		{
+			StageCounters stages[MaxTracedStages];
+		};
+
+		/**
+		 * \brief The names of the stages, the counters of every thread recording, and what threads that have ended recorded
+		 */
+		class TraceRegistry
+		{
+		public:
+			static TraceRegistry& Instance()
+			{
+				static TraceRegistry registry;
+				return registry;
+			}
+
+			/**
+			 * \brief The index of a stage's counters, the same for every stage of the same name, or MaxTracedStages if there
+			 * are already as many stages as can be recorded
+			 */
+			std::size_t Register(const std::string_view name)
+			{
+				std::lock_guard lock(mutex);
+				const auto found = std::find(names.begin(), names.end(), name);
+				if(found != names.end()) { return static_cast<std::size_t>(found - names.begin()); }
+				if(names.size() == MaxTracedStages) { return MaxTracedStages; }
+				names.emplace_back(name);
+				return names.size() - 1;
+			}
+
+			void Attach(ThreadTrace& trace)
+			{
+				std::lock_guard lock(mutex);
+				threads.push_back(&trace);
+			}
+
+			// Keeps what an ending thread recorded
+			void Detach(ThreadTrace& trace)
+			{
+				std::lock_guard lock(mutex);
+				for(std::size_t stage = 0; stage < MaxTracedStages; stage++)
+				{
+					StageTrace counted;
+					trace.stages[stage].AddTo(counted);
+					auto& kept = ended.stages[stage];
+					StageCounters::Bump(kept.lefts, counted.lefts);
+					StageCounters::Bump(kept.rights, counted.rights);
+					for(std::size_t bucket = 0; bucket < TraceLatencyBuckets; bucket++) { StageCounters::Bump(kept.latency[bucket], counted.latency[bucket]); }
+				}
+				threads.erase(std::find(threads.begin(), threads.end(), &trace));
+			}
+
+			TraceSnapshot Snapshot() const
+			{
+				std::lock_guard lock(mutex);
+				TraceSnapshot snapshot;
+				for(std::size_t stage = 0; stage < names.size(); stage++)
+				{
+					auto& total = snapshot.stages.emplace_back();
+					total.name = names[stage];
+					ended.stages[stage].AddTo(total);
+					for(const auto* thread : threads) { thread->stages[stage].AddTo(total); }
+				}
+				return snapshot;
+			}
+
+			/**
+			 * \brief Forgets what has been recorded, keeping the stages. A thread recording meanwhile may keep a count it had just read.
+			 */
+			void Reset()
+			{
+				std::lock_guard lock(mutex);
+				for(auto& stage : ended.stages) { stage.Reset(); }
+				for(auto* thread : threads) { for(auto& stage : thread->stages) { stage.Reset(); } }
+			}
+
+		private:
+			TraceRegistry() = default;
+
+			mutable std::mutex mutex;
+			std::vector<std::string> names;
+			std::vector<ThreadTrace*> threads;
+			ThreadTrace ended;
+		};
+
+		/**
+		 * \brief This thread's counters, made and attached the first time it records and kept once it ends
+		 */
+		class ThreadTraceHolder
+		{
+		public:
+			~ThreadTraceHolder() { if(trace) { TraceRegistry::Instance().Detach(*trace); } }
+
+			StageCounters& For(const std::size_t stage)
+			{
+				if(!trace) [[unlikely]]
+				{
+					trace = std::make_unique<ThreadTrace>();
+					TraceRegistry::Instance().Attach(*trace);
+				}
+				return trace->stages[stage];
+			}
+
+		private:
+			std::unique_ptr<ThreadTrace> trace;
+		};
+
+		inline thread_local ThreadTraceHolder threadTrace;
+
+		/**
+		 * \brief A function that records what each of its calls returned, and how long it took, under its stage
+		 */
+		template <StageName Name, typename F>
+		class TracedStage
+		{
+		public:
+			explicit TracedStage(F function) : function(std::move(function)) {}
+
+			template <typename... Args>
+			auto operator()(Args&&... args) { return Call(function, std::forward<Args>(args)...); }
+
+			template <typename... Args>
+			auto operator()(Args&&... args) const { return Call(function, std::forward<Args>(args)...); }
+
+		private:
+			static std::size_t Stage()
+			{
+				static const auto stage = TraceRegistry::Instance().Register(Name.View());
+				return stage;
+			}
+
+			template <typename G, typename... Args>
+			static auto Call(G& function, Args&&... args)
+			{
+				const auto start = ReadCycles();
+				auto result = std::invoke(function, std::forward<Args>(args)...);
+				const auto cycles = ReadCycles() - start;
+				if(const auto stage = Stage(); stage < MaxTracedStages) { threadTrace.For(stage).Record(WentRight(result), cycles); }
+				return result;
+			}
+
+			F function;
+		};
+	}
+
+	/**
+	 * \brief Records, under a name, what each call of a function returns and how long it takes
+	 * \tparam Name name of the stage, eg. Traced<"parse">(Parse)
+	 * \param function function given to Map() or Bind()
+	 * \return a function that calls it
+	 */
+	template <StageName Name, typename F>
+	auto Traced(F&& function) { return detail::TracedStage<Name, std::decay_t<F>>(std::forward<F>(function)); }
+
+	namespace Trace
+	{
+		/**
+		 * \brief Adds up what every thread has recorded for every stage
+		 */
+		inline TraceSnapshot Snapshot() { return detail::TraceRegistry::Instance().Snapshot(); }
+
+		/**
+		 * \brief Forgets everything recorded so far
+		 */
+		inline void Reset() { detail::TraceRegistry::Instance().Reset(); }
+	}
+#else
+	/**
+	 * \brief Returns the function: tracing is not built in
+	 */
+	template <StageName Name, typename F>
+	std::decay_t<F> Traced(F&& function) { return std::forward<F>(function); }
+
+	namespace Trace
+	{
+		inline TraceSnapshot Snapshot() { return {}; }
+		inline void Reset() {}
+	}
+#endif
+}
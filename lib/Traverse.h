@@ -0,0 +1,171 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Either.h"
+#include "Option.h"
+#include "ThreadPool.h"
+
+namespace libmonad
+{
+	/**
+	 * \brief What traversing a range with a function returning Result produces
+	 * \tparam Result Either<L, R> or Option<T>
+	 */
+	template <typename Result>
+	struct TraverseResult;
+
+	template <typename L, typename R>
+	struct TraverseResult<Either<L, R>>
+	{
+		using Value = R;
+		using Failure = L;
+		using Type = Either<L, std::vector<R>>;
+	};
+
+	template <typename T>
+	struct TraverseResult<Option<T>>
+	{
+		using Value = T;
+		using Failure = None;
+		using Type = Option<std::vector<T>>;
+	};
+
+	/**
+	 * \brief Passes each element of a range on as it is: moved out of an rvalue range, copied out of an lvalue one
+	 * \tparam Range type, including reference, of the range
+	 */
+	template <typename Range>
+	constexpr auto PassOn = [](auto&& element)
+	{
+		using Element = std::ranges::range_value_t<Range>;
+		if constexpr (std::is_lvalue_reference_v<Range>) { return Element(element); }
+		else { return Element(std::move(element)); }
+	};
+
+	/**
+	 * \brief Calls transform on each element of a range in order, stopping at the first left value or none
+	 * \param range range to traverse
+	 * \param transform function taking an element and returning an Either<L, R> or an Option<T>
+	 * \return the first left value (or none), otherwise every right value (or value) in order
+	 */
+	template <std::ranges::input_range Range, typename F>
+	auto Traverse(Range&& range, F transform)
+	{
+		using Result = std::decay_t<std::invoke_result_t<F&, std::ranges::range_reference_t<Range>>>;
+		using Traits = TraverseResult<Result>;
+		using Out = typename Traits::Type;
+
+		std::vector<typename Traits::Value> values;
+		if constexpr (std::ranges::sized_range<Range>) { values.reserve(std::ranges::size(range)); }
+
+		std::optional<typename Traits::Failure> failure;
+		for(auto&& element : range)
+		{
+			std::invoke(transform, std::forward<decltype(element)>(element)).Match(
+				[&](typename Traits::Failure&& left) { failure.emplace(std::move(left)); },
+				[&](typename Traits::Value&& value) { values.push_back(std::move(value)); });
+			if(failure) { return Out(std::move(*failure)); }
+		}
+		return Out(std::move(values));
+	}
+
+	/**
+	 * \brief Turns eithers into an either of their right values, or options into an option of their values.
+	 * The values are moved out of an rvalue range.
+	 * \param range range of Either<L, R> or Option<T>
+	 * \return the first left value (or none), otherwise every right value (or value) in order
+	 */
+	template <std::ranges::input_range Range>
+	auto Sequence(Range&& range)
+	{
+		return Traverse(std::forward<Range>(range), PassOn<Range>);
+	}
+
+	/**
+	 * \brief Calls transform on each element of a range across a thread pool, stopping all threads promptly once a left value or none is found.
+	 * The range is split into chunks handed to threads in order. Once any element is found to fail, no element after it is started,
+	 * but every element before it still is, so the result is the same as Traverse's: the failure at the lowest index wins.
+	 * \param pool threads to run on, together with the calling thread
+	 * \param range random access range to traverse
+	 * \param transform function taking an element and returning an Either<L, R> or an Option<T>, which may be called from several threads at once
+	 * \param chunkSize number of elements a thread takes at a time, by default enough for 16 chunks per thread
+	 * \return the left value (or none) at the lowest index, otherwise every right value (or value) in order
+	 */
+	template <std::ranges::random_access_range Range, typename F>
+	auto Traverse(ThreadPool& pool, Range&& range, F transform, std::size_t chunkSize = 0)
+	{
+		using Result = std::decay_t<std::invoke_result_t<F&, std::ranges::range_reference_t<Range>>>;
+		using Traits = TraverseResult<Result>;
+		using Out = typename Traits::Type;
+
+		const auto size = static_cast<std::size_t>(std::ranges::size(range));
+		const auto first = std::ranges::begin(range);
+		if(chunkSize == 0) { chunkSize = std::max<std::size_t>(1, size / ((pool.Size() + 1) * 16)); }
+		const auto chunks = (size + chunkSize - 1) / chunkSize;
+
+		struct Chunk
+		{
+			std::vector<typename Traits::Value> values;
+			std::optional<typename Traits::Failure> failure;
+		};
+		std::vector<Chunk> results(chunks);
+
+		// Lowest index found to fail so far, only ever lowered. Elements above it are not started.
+		std::atomic<std::size_t> firstFailure{size};
+
+		pool.ParallelFor(chunks, [&](const std::size_t c)
+		{
+			const auto begin = c * chunkSize;
+			const auto end = std::min(size, begin + chunkSize);
+			auto& chunk = results[c];
+			if(begin > firstFailure.load(std::memory_order_relaxed)) { return; }
+
+			chunk.values.reserve(end - begin);
+			for(auto i = begin; i < end && i < firstFailure.load(std::memory_order_relaxed); i++)
+			{
+				std::invoke(transform, first[static_cast<std::iter_difference_t<decltype(first)>>(i)]).Match(
+					[&](typename Traits::Failure&& left) { chunk.failure.emplace(std::move(left)); },
+					[&](typename Traits::Value&& value) { chunk.values.push_back(std::move(value)); });
+
+				if(chunk.failure)
+				{
+					auto lowest = firstFailure.load(std::memory_order_relaxed);
+					while(i < lowest && !firstFailure.compare_exchange_weak(lowest, i, std::memory_order_relaxed)) {}
+					return;
+				}
+			}
+		});
+
+		const auto failed = firstFailure.load(std::memory_order_relaxed);
+		if(failed != size) { return Out(std::move(*results[failed / chunkSize].failure)); }
+
+		std::vector<typename Traits::Value> values;
+		values.reserve(size);
+		for(auto& chunk : results)
+		{
+			for(auto& value : chunk.values) { values.push_back(std::move(value)); }
+		}
+		return Out(std::move(values));
+	}
+
+	/**
+	 * \brief Turns eithers into an either of their right values, or options into an option of their values, across a thread pool
+	 * \param pool threads to run on, together with the calling thread
+	 * \param range random access range of Either<L, R> or Option<T>
+	 * \return the left value (or none) at the lowest index, otherwise every right value (or value) in order
+	 */
+	template <std::ranges::random_access_range Range>
+	auto Sequence(ThreadPool& pool, Range&& range)
+	{
+		return Traverse(pool, std::forward<Range>(range), PassOn<Range>);
+	}
+}
@@ -0,0 +1,188 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "Either.h"
+#include "ErrorPolicy.h"
+#include "SmallVector.h"
+
+namespace libmonad
+{
+	template <typename E, typename T, std::size_t N>
+	class Validated;
+
+	/**
+	 * \brief Determines if a type is a Validated
+	 */
+	template <typename T>
+	struct IsValidated : std::false_type {};
+
+	template <typename E, typename T, std::size_t N>
+	struct IsValidated<Validated<E, T, N>> : std::true_type {};
+
+	/**
+	 * \brief The result of a check: a valid value, or every error found. Unlike an Either, independent checks are run together with
+	 * Combine(), which collects the errors of all of them rather than stopping at the first. Up to N errors are kept in place,
+	 * so a valid result, or one with few errors, allocates nothing of its own.
+	 * \tparam E type of error
+	 * \tparam T type of valid value
+	 * \tparam N number of errors kept without allocating
+	 */
+	template <typename E, typename T, std::size_t N = 4>
+	class Validated
+	{
+	public:
+		using ErrorList = SmallVector<E, N>;
+		using ErrorType = E;
+		using ValueType = T;
+
+		static_assert(!std::is_same_v<E, T>, "A Validated's error and value types must differ");
+
+		/**
+		 * \brief A valid value
+		 */
+		Validated(T value) : result(std::move(value)) {}
+
+		/**
+		 * \brief A single error
+		 */
+		Validated(E error) : result(ErrorList{ std::move(error) }) {}
+
+		/**
+		 * \brief Errors found, of which there must be at least one
+		 */
+		explicit Validated(ErrorList errors) : result(CheckNotEmpty(std::move(errors))) {}
+
+		/**
+		 * \brief The result of a check that stops at its first error
+		 */
+		explicit Validated(Either<E, T> either) : result(std::move(either).Match(
+			[](E&& error) { return Result(ErrorList{ std::move(error) }); },
+			[](T&& value) { return Result(std::move(value)); })) {}
+
+		bool IsValid() const { return result.IsRight(); }
+		bool IsInvalid() const { return result.IsLeft(); }
+
+		/**
+		 * \brief Gets the valid value, reporting an error through the error policy if there are errors instead
+		 */
+		const T& ThrowIfInvalid() const &
+		{
+			CheckValid();
+			return result.ThrowIfLeft();
+		}
+
+		T ThrowIfInvalid() &&
+		{
+			CheckValid();
+			return std::move(result).ThrowIfLeft();
+		}
+
+		/**
+		 * \brief Every error found, in order, or none if valid
+		 */
+		const ErrorList& Errors() const
+		{
+			return *result.Match([](const ErrorList& errors) { return &errors; }, [](const T&) { return &NoErrors(); });
+		}
+
+		/**
+		 * \brief Transforms the valid value, carrying errors over unchanged
+		 * \tparam F transformation function that takes a value and returns a U
+		 * \param transform transformation function
+		 * \return Validated<E, U, N>
+		 */
+		template <typename F>
+		auto Map(F&& transform) const & { return MapImpl(*this, std::forward<F>(transform)); }
+
+		template <typename F>
+		auto Map(F&& transform) && { return MapImpl(std::move(*this), std::forward<F>(transform)); }
+
+		/**
+		 * \brief Performs one action or another depending on whether it is valid
+		 * \param ifInvalid action to perform with the errors
+		 * \param ifValid action to perform with the value
+		 * \return what the action returns
+		 */
+		template <typename FI, typename FV>
+		decltype(auto) Match(FI&& ifInvalid, FV&& ifValid) const & { return result.Match(std::forward<FI>(ifInvalid), std::forward<FV>(ifValid)); }
+
+		template <typename FI, typename FV>
+		decltype(auto) Match(FI&& ifInvalid, FV&& ifValid) && { return std::move(result).Match(std::forward<FI>(ifInvalid), std::forward<FV>(ifValid)); }
+
+		/**
+		 * \brief Converts to an Either whose left value holds every error
+		 */
+		Either<ErrorList, T> ToEither() const & { return result; }
+		Either<ErrorList, T> ToEither() && { return std::move(result); }
+
+		friend bool operator==(const Validated& a, const Validated& b) { return a.result == b.result; }
+
+	private:
+		using Result = Either<ErrorList, T>;
+
+		template <typename E2, typename T2, std::size_t N2>
+		friend class Validated;
+
+		template <typename F, typename E2, std::size_t N2, typename... Ts>
+		friend auto Combine(F&& transform, const Validated<E2, Ts, N2>&... checks);
+
+		explicit Validated(Result result) : result(std::move(result)) {}
+
+		static ErrorList CheckNotEmpty(ErrorList errors)
+		{
+			if constexpr (ErrorsChecked)
+			{
+				if(errors.Empty()) { Fail("Validated needs at least one error"); }
+			}
+			return errors;
+		}
+
+		void CheckValid() const
+		{
+			if constexpr (ErrorsChecked)
+			{
+				if(IsInvalid()) { Fail("ThrowIfInvalid"); }
+			}
+		}
+
+		// The value, for Combine once it has seen every check is valid. Match inlines where the checked ThrowIfLeft does not.
+		const T& Value() const { return *result.Match([](const ErrorList&) -> const T* { return nullptr; }, [](const T& value) { return &value; }); }
+
+		static const ErrorList& NoErrors()
+		{
+			static const ErrorList none{};
+			return none;
+		}
+
+		template <typename Self, typename F>
+		static auto MapImpl(Self&& self, F&& transform)
+		{
+			using U = std::decay_t<std::invoke_result_t<F, ForwardLike<Self, T>>>;
+			static_assert(!IsEither<U>::value && !IsValidated<U>::value, "Map transformation must return a plain value");
+			return Validated<E, U, N>(std::forward<Self>(self).result.Map(std::forward<F>(transform)));
+		}
+
+		Result result;
+	};
+
+	/**
+	 * \brief Runs independent checks together: if every one is valid, calls a transformation with all of their values,
+	 * and otherwise returns the errors of every check that failed, in the order the checks are given
+	 * \param transform function that takes the value of each check and returns a U
+	 * \param checks results of the checks
+	 * \return Validated<E, U, N>
+	 */
+	template <typename F, typename E, std::size_t N, typename... Ts>
+	auto Combine(F&& transform, const Validated<E, Ts, N>&... checks)
+	{
+		using Result = Validated<E, std::decay_t<std::invoke_result_t<F, const Ts&...>>, N>;
+		if((checks.IsValid() && ...)) { return Result(std::invoke(std::forward<F>(transform), checks.Value()...)); }
+
+		typename Result::ErrorList errors;
+		([&] { if(checks.IsInvalid()) { errors.Append(checks.Errors()); } }(), ...);
+		return Result(std::move(errors));
+	}
+}